@@ -1,33 +1,74 @@
 #ifndef INTRINSICS_H
 #define INTRINSICS_H
-#include <intrin.h>
 #include <array>
+#include <span>
+#include <cassert>
 
+#include <clmMath/clm_vector_simd.h>
+#include <clmMath/clm_dispatch.h>
+
+// These wrappers only use what the build targets (clm_vector_simd.h): the 256-bit
+// overloads exist only in AVX builds, so nothing here can fault on an older CPU. Work on
+// whole arrays should go through the span overloads at the bottom, which pick the widest
+// instruction set at runtime.
 namespace clm::util::math::intrin {
+#ifdef CLM_SIMD_SSE
+	// Lanes are loaded straight from the arrays, so out[i] = oper(lhs[i], rhs[i]).
+	template<__m128(*oper)(__m128, __m128)>
+	std::array<float, 4> vec_4_float_oper(const std::array<float, 4>& lhs, const std::array<float, 4>& rhs) noexcept
+	{
+		std::array<float, 4> out;
+		_mm_storeu_ps(out.data(), oper(_mm_loadu_ps(lhs.data()), _mm_loadu_ps(rhs.data())));
+		return out;
+	}
+
 	template<__m128(*oper)(__m128, __m128)>
 	std::array<float, 4> vec_4_float_oper(float lhs0 = 0.0f, float rhs0 = 0.0f,
 										  float lhs1 = 0.0f, float rhs1 = 0.0f,
 										  float lhs2 = 0.0f, float rhs2 = 0.0f,
 										  float lhs3 = 0.0f, float rhs3 = 0.0f) noexcept
 	{
-		__m128 lhsVec = _mm_set_ps(lhs0, lhs1, lhs2, lhs3);
-		__m128 rhsVec = _mm_set_ps(rhs0, rhs1, rhs2, rhs3);
-		__m128 operOut = oper(lhsVec, rhsVec);
-		float out[4];
-		_mm_store_ps(out, operOut);
-		return std::to_array(out);
+		return vec_4_float_oper<oper>({lhs0, lhs1, lhs2, lhs3}, {rhs0, rhs1, rhs2, rhs3});
+	}
+
+	template<__m128d(*oper)(__m128d, __m128d)>
+	std::array<double, 2> vec_2_double_oper(const std::array<double, 2>& lhs, const std::array<double, 2>& rhs) noexcept
+	{
+		std::array<double, 2> out;
+		_mm_storeu_pd(out.data(), oper(_mm_loadu_pd(lhs.data()), _mm_loadu_pd(rhs.data())));
+		return out;
 	}
 
 	template<__m128d(*oper)(__m128d, __m128d)>
 	std::array<double, 2> vec_2_double_oper(double lhs0 = 0.0, double rhs0 = 0.0,
 											double lhs1 = 0.0, double rhs1 = 0.0) noexcept
 	{
-		__m128d lhs = _mm_set_pd(lhs0, lhs1);
-		__m128d rhs = _mm_set_pd(rhs0, rhs1);
-		__m128d operOut = oper(lhs, rhs);
-		double out[2];
-		_mm_store_pd(out, operOut);
-		return std::to_array(out);
+		return vec_2_double_oper<oper>({lhs0, lhs1}, {rhs0, rhs1});
+	}
+
+	inline __m128 add_floats(__m128 a, __m128 b) noexcept
+	{
+		return _mm_add_ps(a, b);
+	}
+
+	inline __m128d add_doubles(__m128d a, __m128d b) noexcept
+	{
+		return _mm_add_pd(a, b);
+	}
+
+	inline __m128 sub_floats(__m128 a, __m128 b) noexcept
+	{
+		return _mm_sub_ps(a, b);
+	}
+#endif
+
+#ifdef CLM_SIMD_AVX
+	template<__m256d(*oper)(__m256d, __m256d)>
+	std::array<double, 4> vec_4_double_oper(const std::array<double, 4>& lhs, const std::array<double, 4>& rhs) noexcept
+	{
+		std::array<double, 4> out;
+		_mm256_storeu_pd(out.data(), oper(_mm256_loadu_pd(lhs.data()), _mm256_loadu_pd(rhs.data())));
+		return out;
 	}
 
 	template<__m256d(*oper)(__m256d, __m256d)>
@@ -36,32 +77,35 @@ namespace clm::util::math::intrin {
 											double lhs2 = 0.0, double rhs2 = 0.0,
 											double lhs3 = 0.0, double rhs3 = 0.0) noexcept
 	{
-		__m256d lhs = _mm256_set_pd(lhs0, lhs1, lhs2, lhs3);
-		__m256d rhs = _mm256_set_pd(rhs0, rhs1, rhs2, rhs3);
-		__m256d operOut = oper(lhs, rhs);
-		double out[4];
-		_mm256_store_pd(out, operOut);
-		return std::to_array(out);
+		return vec_4_double_oper<oper>({lhs0, lhs1, lhs2, lhs3}, {rhs0, rhs1, rhs2, rhs3});
 	}
 
-	inline __m128 add_floats(__m128 a, __m128 b) noexcept
+	inline __m256d add_doubles(__m256d a, __m256d b) noexcept
 	{
-		return _mm_add_ps(a, b);
+		return _mm256_add_pd(a, b);
 	}
+#endif
 
-	inline __m128d add_doubles(__m128d a, __m128d b) noexcept
+	// out[i] = lhs[i] + rhs[i] over whole arrays through the runtime dispatched kernels.
+	template<clm::math::dispatch::dispatched_type T>
+	void add(std::span<const T> lhs, std::span<const T> rhs, std::span<T> out) noexcept
 	{
-		return _mm_add_pd(a, b);
+		assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+		clm::math::dispatch::batch_kernels<T>().add(lhs.data(), rhs.data(), out.data(), lhs.size());
 	}
 
-	inline __m256d add_doubles(__m256d a, __m256d b) noexcept
+	template<clm::math::dispatch::dispatched_type T>
+	void sub(std::span<const T> lhs, std::span<const T> rhs, std::span<T> out) noexcept
 	{
-		return _mm256_add_pd(a, b);
+		assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+		clm::math::dispatch::batch_kernels<T>().sub(lhs.data(), rhs.data(), out.data(), lhs.size());
 	}
 
-	inline __m128 sub_floats(__m128 a, __m128 b) noexcept
+	template<clm::math::dispatch::dispatched_type T>
+	void scale(std::span<const T> in, T factor, std::span<T> out) noexcept
 	{
-		return _mm_sub_ps(a, b);
+		assert(out.size() >= in.size());
+		clm::math::dispatch::batch_kernels<T>().scale(in.data(), factor, out.data(), in.size());
 	}
 }
 #endif
\ No newline at end of file
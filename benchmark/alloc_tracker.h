@@ -0,0 +1,189 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <new>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+
+// Heap allocation accounting through replaced global operator new/delete. Opt-in: the
+// operators are only defined in the one source file of an executable that defines
+// CLM_ALLOC_TRACKER_HOOKS before including this header. Without them every query reads
+// zero and alloc_tracking_enabled() is false.
+//
+// Counters are per thread and unsynchronised, so counting costs a few adds per call. A
+// block freed on another thread than it was allocated on lowers that thread's live bytes
+// instead, which can make a scope's live figure negative; counts and bytes stay exact.
+namespace clm::bench {
+	struct alloc_stats
+	{
+		std::uint64_t allocations = 0;
+		std::uint64_t deallocations = 0;
+		std::uint64_t bytes = 0;
+		// Highest live byte count reached above the level at the start of the scope.
+		std::uint64_t peak = 0;
+
+		bool empty() const noexcept
+		{
+			return allocations == 0 && deallocations == 0;
+		}
+		alloc_stats& operator+=(const alloc_stats& rhs) noexcept
+		{
+			allocations += rhs.allocations;
+			deallocations += rhs.deallocations;
+			bytes += rhs.bytes;
+			peak = std::max(peak, rhs.peak);
+			return *this;
+		}
+	};
+
+	namespace detail {
+		struct alloc_counters
+		{
+			std::uint64_t allocations;
+			std::uint64_t deallocations;
+			std::uint64_t bytes;
+			std::int64_t live;
+			std::int64_t peak;
+		};
+
+		// Trivial types only: these are touched from operator new, before and after any
+		// dynamic initialisation could run.
+		inline thread_local alloc_counters allocCounters{};
+		inline bool allocHooksInstalled = false;
+
+		// Every block carries its base pointer and size just below the pointer handed out,
+		// so unsized and aligned deletes can account for it.
+		struct alloc_header
+		{
+			void* base;
+			std::size_t size;
+		};
+
+		inline void* tracked_alloc(std::size_t size, std::size_t align) noexcept
+		{
+			align = std::max(align, alignof(std::max_align_t));
+			// Padding and header on top of a size near SIZE_MAX would wrap to a small block.
+			if (align > SIZE_MAX - sizeof(alloc_header) || size > SIZE_MAX - align - sizeof(alloc_header))
+			{
+				return nullptr;
+			}
+			void* base = std::malloc(size + align + sizeof(alloc_header));
+			if (!base)
+			{
+				return nullptr;
+			}
+			const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(base) + sizeof(alloc_header);
+			void* user = reinterpret_cast<void*>((first + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+			static_cast<alloc_header*>(user)[-1] = alloc_header{base, size};
+
+			alloc_counters& c = allocCounters;
+			c.allocations++;
+			c.bytes += size;
+			c.live += static_cast<std::int64_t>(size);
+			c.peak = std::max(c.peak, c.live);
+			return user;
+		}
+
+		inline void tracked_free(void* user) noexcept
+		{
+			if (!user)
+			{
+				return;
+			}
+			const alloc_header header = static_cast<alloc_header*>(user)[-1];
+			alloc_counters& c = allocCounters;
+			c.deallocations++;
+			c.live -= static_cast<std::int64_t>(header.size);
+			std::free(header.base);
+		}
+
+		inline void* tracked_new(std::size_t size, std::size_t align)
+		{
+			while (true)
+			{
+				if (void* p = tracked_alloc(size, align))
+				{
+					return p;
+				}
+				std::new_handler handler = std::get_new_handler();
+				if (!handler)
+				{
+					throw std::bad_alloc{};
+				}
+				handler();
+			}
+		}
+	}
+
+	inline bool alloc_tracking_enabled() noexcept
+	{
+		return detail::allocHooksInstalled;
+	}
+
+	// Counts the calling thread's allocations from construction on. Scopes nest: an inner
+	// scope's peak never hides the outer one's.
+	class alloc_scope
+	{
+	public:
+		alloc_scope() noexcept
+			:
+			m_start(detail::allocCounters)
+		{
+			detail::allocCounters.peak = m_start.live;
+		}
+		~alloc_scope()
+		{
+			detail::alloc_counters& c = detail::allocCounters;
+			c.peak = std::max(c.peak, m_start.peak);
+		}
+		alloc_scope(const alloc_scope&) = delete;
+		alloc_scope& operator=(const alloc_scope&) = delete;
+
+		// So far; may be called repeatedly.
+		alloc_stats stats() const noexcept
+		{
+			const detail::alloc_counters& c = detail::allocCounters;
+			alloc_stats s{};
+			s.allocations = c.allocations - m_start.allocations;
+			s.deallocations = c.deallocations - m_start.deallocations;
+			s.bytes = c.bytes - m_start.bytes;
+			s.peak = static_cast<std::uint64_t>(std::max<std::int64_t>(0, c.peak - m_start.live));
+			return s;
+		}
+
+	private:
+		detail::alloc_counters m_start;
+	};
+}
+
+#ifdef CLM_ALLOC_TRACKER_HOOKS
+namespace clm::bench::detail {
+	inline const bool allocHooksRegistered = (allocHooksInstalled = true);
+}
+
+void* operator new(std::size_t size) { return clm::bench::detail::tracked_new(size, 0); }
+void* operator new[](std::size_t size) { return clm::bench::detail::tracked_new(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align) { return clm::bench::detail::tracked_new(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return clm::bench::detail::tracked_new(size, static_cast<std::size_t>(align)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return clm::bench::detail::tracked_alloc(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return clm::bench::detail::tracked_alloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return clm::bench::detail::tracked_alloc(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return clm::bench::detail::tracked_alloc(size, static_cast<std::size_t>(align)); }
+
+void operator delete(void* p) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete(void* p, std::size_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { clm::bench::detail::tracked_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { clm::bench::detail::tracked_free(p); }
+#endif
+
+#endif
\ No newline at end of file
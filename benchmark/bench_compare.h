@@ -0,0 +1,411 @@
+#ifndef BENCH_COMPARE_H
+#define BENCH_COMPARE_H
+
+#include <span>
+#include <cmath>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <iomanip>
+#include <iterator>
+#include <optional>
+#include <algorithm>
+#include <string_view>
+#include <system_error>
+
+#include "bench_runner.h"
+
+// Reading back bench_runner::write_json output and diffing two runs.
+namespace clm::bench {
+	namespace detail {
+		// Just enough JSON for result files: objects, arrays, strings, numbers and literals.
+		// Unknown keys are skipped, so files from newer versions still load.
+		class json_reader
+		{
+		public:
+			explicit json_reader(std::string_view text) noexcept
+				:
+				m_text(text)
+			{}
+
+			bool read_results(std::vector<bench_result>& results)
+			{
+				return object([&](std::string_view key) {
+					if (key != "benchmarks")
+					{
+						return skip();
+					}
+					return array([&]() {
+						bench_result r{};
+						if (!object([&](std::string_view field) { return result_field(r, field); }))
+						{
+							return false;
+						}
+						results.push_back(std::move(r));
+						return true;
+					});
+				}) && (skip_space(), m_pos == m_text.size());
+			}
+
+		private:
+			bool result_field(bench_result& r, std::string_view field)
+			{
+				double* target = nullptr;
+				if (field == "name")
+				{
+					return string(&r.name);
+				}
+				else if (field == "samples_ns")
+				{
+					return array([&]() {
+						double ns = 0;
+						if (!number(ns))
+						{
+							return false;
+						}
+						r.sample_times.push_back(ns * 1e-9);
+						return true;
+					});
+				}
+				else if (field == "iterations" || field == "samples" || field == "outliers")
+				{
+					double value = 0;
+					if (!number(value))
+					{
+						return false;
+					}
+					(field == "iterations" ? r.iterations : field == "samples" ? r.samples : r.outliers) = static_cast<size_t>(value);
+					return true;
+				}
+				else if (field == "min") { target = &r.stats.min; }
+				else if (field == "median") { target = &r.stats.median; }
+				else if (field == "mean") { target = &r.stats.mean; }
+				else if (field == "p90") { target = &r.stats.p90; }
+				else if (field == "p99") { target = &r.stats.p99; }
+				else if (field == "stddev") { target = &r.stats.stddev; }
+				else if (field == "items_per_second") { target = &r.items_per_second; }
+				else if (field == "bytes_per_second") { target = &r.bytes_per_second; }
+				else if (field == "allocations") { target = &r.allocations; }
+				return target ? number(*target) : skip();
+			}
+
+			void skip_space() noexcept
+			{
+				while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+				{
+					m_pos++;
+				}
+			}
+			bool consume(char c) noexcept
+			{
+				skip_space();
+				if (m_pos < m_text.size() && m_text[m_pos] == c)
+				{
+					m_pos++;
+					return true;
+				}
+				return false;
+			}
+
+			// fn(key) reads the value of each member.
+			template<typename Fn>
+			bool object(Fn&& fn)
+			{
+				if (!consume('{'))
+				{
+					return false;
+				}
+				if (consume('}'))
+				{
+					return true;
+				}
+				do
+				{
+					std::string key;
+					if (!string(&key) || !consume(':') || !fn(std::string_view{key}))
+					{
+						return false;
+					}
+				} while (consume(','));
+				return consume('}');
+			}
+
+			// fn() reads each element.
+			template<typename Fn>
+			bool array(Fn&& fn)
+			{
+				if (!consume('['))
+				{
+					return false;
+				}
+				if (consume(']'))
+				{
+					return true;
+				}
+				do
+				{
+					if (!fn())
+					{
+						return false;
+					}
+				} while (consume(','));
+				return consume(']');
+			}
+
+			// Escapes other than the ones write_json produces are kept as written.
+			bool string(std::string* out)
+			{
+				if (!consume('"'))
+				{
+					return false;
+				}
+				while (m_pos < m_text.size())
+				{
+					char c = m_text[m_pos++];
+					if (c == '"')
+					{
+						return true;
+					}
+					if (c == '\\' && m_pos < m_text.size())
+					{
+						const char e = m_text[m_pos++];
+						c = e == 'n' ? '\n' : e == 't' ? '\t' : e;
+						if (e == 'u' && m_pos + 4 <= m_text.size())
+						{
+							unsigned code = 0;
+							const char* const digits = m_text.data() + m_pos;
+							const auto [end, error] = std::from_chars(digits, digits + 4, code, 16);
+							if (error != std::errc{} || end != digits + 4)
+							{
+								return false;
+							}
+							c = static_cast<char>(code);
+							m_pos += 4;
+						}
+					}
+					if (out)
+					{
+						out->push_back(c);
+					}
+				}
+				return false;
+			}
+
+			bool number(double& out)
+			{
+				skip_space();
+				const size_t start = m_pos;
+				while (m_pos < m_text.size() && (std::isdigit(static_cast<unsigned char>(m_text[m_pos])) ||
+					   std::string_view{"+-.eE"}.find(m_text[m_pos]) != std::string_view::npos))
+				{
+					m_pos++;
+				}
+				if (start == m_pos)
+				{
+					return false;
+				}
+				const char* const last = m_text.data() + m_pos;
+				const auto [end, error] = std::from_chars(m_text.data() + start, last, out);
+				return error == std::errc{} && end == last;
+			}
+
+			bool skip()
+			{
+				skip_space();
+				if (m_pos >= m_text.size())
+				{
+					return false;
+				}
+				switch (m_text[m_pos])
+				{
+				case '{': return object([&](std::string_view) { return skip(); });
+				case '[': return array([&]() { return skip(); });
+				case '"': return string(nullptr);
+				default:
+					for (std::string_view literal : {"true", "false", "null"})
+					{
+						if (m_text.substr(m_pos, literal.size()) == literal)
+						{
+							m_pos += literal.size();
+							return true;
+						}
+					}
+					double ignored = 0;
+					return number(ignored);
+				}
+			}
+
+			std::string_view m_text;
+			size_t m_pos = 0;
+		};
+	}
+
+	// Results as written by bench_runner::write_json, or nullopt if the file is malformed.
+	inline std::optional<std::vector<bench_result>> read_json(std::istream& in)
+	{
+		const std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+		std::vector<bench_result> results;
+		detail::json_reader reader{text};
+		if (!reader.read_results(results))
+		{
+			return std::nullopt;
+		}
+		return results;
+	}
+
+	// Two-sided p-value of the Mann-Whitney U test that a and b come from the same
+	// distribution, from the normal approximation with tie correction. Needs no
+	// assumption about the shape of timing distributions, which are rarely normal.
+	inline double mann_whitney_p(std::span<const double> a, std::span<const double> b)
+	{
+		const double n1 = static_cast<double>(a.size());
+		const double n2 = static_cast<double>(b.size());
+		if (a.empty() || b.empty())
+		{
+			return 1.0;
+		}
+		struct ranked
+		{
+			double value;
+			bool first;
+		};
+		std::vector<ranked> all;
+		all.reserve(a.size() + b.size());
+		for (double v : a) { all.push_back(ranked{v, true}); }
+		for (double v : b) { all.push_back(ranked{v, false}); }
+		std::ranges::sort(all, {}, &ranked::value);
+
+		double rankSumA = 0;
+		double tieTerm = 0;
+		for (size_t i = 0; i < all.size();)
+		{
+			size_t j = i;
+			while (j < all.size() && all[j].value == all[i].value)
+			{
+				j++;
+			}
+			const double ties = static_cast<double>(j - i);
+			const double rank = static_cast<double>(i + j + 1) / 2.0;
+			for (size_t k = i; k < j; k++)
+			{
+				rankSumA += all[k].first ? rank : 0.0;
+			}
+			tieTerm += ties * ties * ties - ties;
+			i = j;
+		}
+
+		const double n = n1 + n2;
+		const double u = rankSumA - n1 * (n1 + 1) / 2.0;
+		const double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+		if (variance <= 0)
+		{
+			return 1.0;
+		}
+		const double z = (u - n1 * n2 / 2.0) / std::sqrt(variance);
+		return std::erfc(std::abs(z) / std::sqrt(2.0));
+	}
+
+	struct compare_config
+	{
+		// Changes in median smaller than this fraction are reported but never flagged.
+		double threshold = 0.05;
+		// Significance level for the U test on the per-sample times.
+		double alpha = 0.01;
+	};
+
+	enum class compare_verdict
+	{
+		unchanged,
+		faster,
+		slower,
+		added,
+		removed
+	};
+
+	struct comparison
+	{
+		std::string name;
+		// Median seconds per iteration; 0 on the side a benchmark is missing from.
+		double baseline = 0;
+		double current = 0;
+		// current / baseline - 1.
+		double change = 0;
+		double p_value = 1;
+		compare_verdict verdict = compare_verdict::unchanged;
+	};
+
+	// Pairs benchmarks by name. A change counts when it passes both the threshold and the
+	// U test; results without raw samples are judged on the threshold alone.
+	inline std::vector<comparison> compare_results(std::span<const bench_result> baseline, std::span<const bench_result> current, const compare_config& config = {})
+	{
+		std::vector<comparison> out;
+		for (const bench_result& cur : current)
+		{
+			comparison c{};
+			c.name = cur.name;
+			c.current = cur.stats.median;
+			const auto base = std::ranges::find(baseline, cur.name, &bench_result::name);
+			if (base == baseline.end())
+			{
+				c.verdict = compare_verdict::added;
+				out.push_back(std::move(c));
+				continue;
+			}
+			c.baseline = base->stats.median;
+			c.change = c.baseline > 0 ? c.current / c.baseline - 1.0 : 0.0;
+			const bool haveSamples = base->sample_times.size() > 1 && cur.sample_times.size() > 1;
+			c.p_value = haveSamples ? mann_whitney_p(base->sample_times, cur.sample_times) : 0.0;
+			if (std::abs(c.change) >= config.threshold && c.p_value < config.alpha)
+			{
+				c.verdict = c.change > 0 ? compare_verdict::slower : compare_verdict::faster;
+			}
+			out.push_back(std::move(c));
+		}
+		for (const bench_result& base : baseline)
+		{
+			if (std::ranges::find(current, base.name, &bench_result::name) == current.end())
+			{
+				comparison c{};
+				c.name = base.name;
+				c.baseline = base.stats.median;
+				c.verdict = compare_verdict::removed;
+				out.push_back(std::move(c));
+			}
+		}
+		return out;
+	}
+
+	// One line per benchmark; returns the number flagged slower.
+	inline size_t print_comparison(std::ostream& out, std::span<const comparison> comparisons)
+	{
+		const auto flags = out.flags();
+		const auto precision = out.precision();
+		out << std::left << std::setw(40) << "benchmark" << std::right << std::setw(14) << "base ns"
+			<< std::setw(14) << "new ns" << std::setw(10) << "change" << std::setw(10) << "p" << "  verdict\n";
+		size_t slower = 0;
+		for (const comparison& c : comparisons)
+		{
+			const char* verdict = "";
+			switch (c.verdict)
+			{
+			case compare_verdict::unchanged: verdict = ""; break;
+			case compare_verdict::faster: verdict = "faster"; break;
+			case compare_verdict::slower: verdict = "SLOWER"; slower++; break;
+			case compare_verdict::added: verdict = "new"; break;
+			case compare_verdict::removed: verdict = "removed"; break;
+			}
+			out << std::left << std::setw(40) << c.name << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(14) << c.baseline * 1e9 << std::setw(14) << c.current * 1e9
+				<< std::setw(9) << c.change * 100.0 << '%' << std::setprecision(4) << std::setw(10) << c.p_value
+				<< "  " << verdict << '\n';
+		}
+		out.flags(flags);
+		out.precision(precision);
+		return slower;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+// clmBench: runs the benchmark suite, or compares two result files.
+//
+//	clmBench [--filter text] [--quick] [--json file]
+//	clmBench --compare baseline.json current.json [--threshold fraction] [--alpha p]
+//
+// Compare mode exits with 1 when any benchmark got significantly slower, so it can gate
+// a build; 2 means bad arguments or an unreadable file.
+#define CLM_ALLOC_TRACKER_HOOKS
+#include "alloc_tracker.h"
+
+#include <string>
+#include <fstream>
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+#include "bench_runner.h"
+#include "bench_compare.h"
+#include "bench_suite.h"
+
+namespace {
+	// All of text as a number, or nullopt.
+	std::optional<double> parse_number(std::string_view text)
+	{
+		double value = 0;
+		const char* const last = text.data() + text.size();
+		const auto [end, error] = std::from_chars(text.data(), last, value);
+		if (error != std::errc{} || end != last)
+		{
+			return std::nullopt;
+		}
+		return value;
+	}
+
+	std::optional<std::vector<clm::bench::bench_result>> load(const std::string& path)
+	{
+		std::ifstream in{path};
+		if (!in)
+		{
+			std::cerr << "cannot open " << path << '\n';
+			return std::nullopt;
+		}
+		auto results = clm::bench::read_json(in);
+		if (!results)
+		{
+			std::cerr << path << " is not a benchmark result file\n";
+		}
+		return results;
+	}
+
+	int compare(const std::string& baselinePath, const std::string& currentPath, const clm::bench::compare_config& config)
+	{
+		const auto baseline = load(baselinePath);
+		const auto current = load(currentPath);
+		if (!baseline || !current)
+		{
+			return 2;
+		}
+		const auto comparisons = clm::bench::compare_results(*baseline, *current, config);
+		const size_t slower = clm::bench::print_comparison(std::cout, comparisons);
+		std::cout << slower << " of " << comparisons.size() << " benchmarks slower by at least "
+			<< config.threshold * 100.0 << "% at p < " << config.alpha << '\n';
+		return slower == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	clm::bench::suite_config suite{};
+	clm::bench::bench_config bench{};
+	clm::bench::compare_config compareConfig{};
+	std::string jsonPath;
+	std::vector<std::string> comparePaths;
+	bool compareMode = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg{argv[i]};
+		const bool hasValue = i + 1 < argc;
+		if (arg == "--filter" && hasValue)
+		{
+			suite.filter = argv[++i];
+		}
+		else if (arg == "--json" && hasValue)
+		{
+			jsonPath = argv[++i];
+		}
+		else if (arg == "--quick")
+		{
+			suite.sizes = {1024};
+			bench.warmup = clm::bench::bench_config::seconds_t{0.02};
+			bench.max_time = clm::bench::bench_config::seconds_t{0.5};
+		}
+		else if (arg == "--compare" && i + 2 < argc)
+		{
+			compareMode = true;
+			comparePaths = {argv[i + 1], argv[i + 2]};
+			i += 2;
+		}
+		else if ((arg == "--threshold" || arg == "--alpha") && hasValue)
+		{
+			const auto value = parse_number(argv[++i]);
+			if (!value)
+			{
+				std::cerr << arg << " needs a number, not \"" << argv[i] << "\"\n";
+				return 2;
+			}
+			(arg == "--threshold" ? compareConfig.threshold : compareConfig.alpha) = *value;
+		}
+		else
+		{
+			std::cerr << "usage: clmBench [--filter text] [--quick] [--json file]\n"
+				<< "       clmBench --compare baseline.json current.json [--threshold fraction] [--alpha p]\n";
+			return 2;
+		}
+	}
+
+	if (compareMode)
+	{
+		return compare(comparePaths[0], comparePaths[1], compareConfig);
+	}
+
+	clm::bench::bench_runner runner{bench};
+	clm::bench::run_suite(runner, suite);
+	runner.print(std::cout);
+	if (!jsonPath.empty())
+	{
+		std::ofstream out{jsonPath};
+		if (!out)
+		{
+			std::cerr << "cannot write " << jsonPath << '\n';
+			return 2;
+		}
+		runner.write_json(out);
+	}
+	return 0;
+}
\ No newline at end of file
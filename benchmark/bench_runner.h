@@ -0,0 +1,311 @@
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <span>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include "time_bench.h"
+#include "time_log.h"
+#include "json_string.h"
+
+namespace clm::bench {
+	// Keeps the compiler from dropping a computation whose result is otherwise unused.
+	template<typename T>
+	inline void do_not_optimize(const T& value) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		static_cast<void>(*static_cast<const volatile char*>(static_cast<const void*>(&value)));
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	struct bench_config
+	{
+		using seconds_t = std::chrono::duration<double>;
+
+		// Untimed run before sampling, also used to pick the iterations per sample.
+		seconds_t warmup{0.1};
+		// Each sample repeats the body until it takes at least this long, so timer
+		// resolution and call overhead stay negligible.
+		seconds_t min_sample_time{0.01};
+		// Sampling stops once the standard error of the mean is below this fraction of
+		// the mean, after min_samples, or at max_samples / max_time regardless.
+		double target_relative_error = 0.01;
+		size_t min_samples = 10;
+		size_t max_samples = 200;
+		seconds_t max_time{5.0};
+		// Samples outside [Q1 - k * IQR, Q3 + k * IQR] are dropped as outliers.
+		double outlier_fence = 1.5;
+	};
+
+	// Work done by one iteration of the benchmark body, for the throughput figures.
+	struct throughput
+	{
+		double items = 0;
+		double bytes = 0;
+	};
+
+	// Seconds per iteration.
+	struct bench_stats
+	{
+		double min = 0;
+		double median = 0;
+		double mean = 0;
+		double p90 = 0;
+		double p99 = 0;
+		double stddev = 0;
+	};
+
+	struct bench_result
+	{
+		std::string name;
+		size_t iterations = 0;
+		size_t samples = 0;
+		size_t outliers = 0;
+		bench_stats stats;
+		double items_per_second = 0;
+		double bytes_per_second = 0;
+		// Heap allocations per iteration, measured only with the hooks of alloc_tracker.h
+		// installed; benchmarks of allocation-free kernels can check it is zero.
+		double allocations = 0;
+		// Per-iteration times of the kept samples, for comparing runs.
+		std::vector<double> sample_times;
+	};
+
+	// Linear interpolation between closest ranks; sorted must be sorted and non-empty.
+	inline double percentile(std::span<const double> sorted, double p) noexcept
+	{
+		const double rank = p * static_cast<double>(sorted.size() - 1);
+		const size_t low = static_cast<size_t>(rank);
+		const size_t high = std::min(low + 1, sorted.size() - 1);
+		return sorted[low] + (sorted[high] - sorted[low]) * (rank - static_cast<double>(low));
+	}
+
+	inline bench_stats compute_stats(std::span<const double> samples)
+	{
+		bench_stats stats{};
+		if (samples.empty())
+		{
+			return stats;
+		}
+		std::vector<double> sorted(samples.begin(), samples.end());
+		std::ranges::sort(sorted);
+		double sum = 0;
+		for (double s : sorted)
+		{
+			sum += s;
+		}
+		stats.mean = sum / static_cast<double>(sorted.size());
+		double squares = 0;
+		for (double s : sorted)
+		{
+			squares += (s - stats.mean) * (s - stats.mean);
+		}
+		stats.stddev = sorted.size() > 1 ? std::sqrt(squares / static_cast<double>(sorted.size() - 1)) : 0.0;
+		stats.min = sorted.front();
+		stats.median = percentile(sorted, 0.5);
+		stats.p90 = percentile(sorted, 0.9);
+		stats.p99 = percentile(sorted, 0.99);
+		return stats;
+	}
+
+	// Tukey's fences: keeps the samples within fence interquartile ranges of the quartiles.
+	inline std::vector<double> reject_outliers(std::span<const double> samples, double fence)
+	{
+		if (samples.size() < 4)
+		{
+			return std::vector<double>(samples.begin(), samples.end());
+		}
+		std::vector<double> sorted(samples.begin(), samples.end());
+		std::ranges::sort(sorted);
+		const double q1 = percentile(sorted, 0.25);
+		const double q3 = percentile(sorted, 0.75);
+		const double low = q1 - fence * (q3 - q1);
+		const double high = q3 + fence * (q3 - q1);
+		std::vector<double> kept;
+		kept.reserve(samples.size());
+		for (double s : samples)
+		{
+			if (s >= low && s <= high)
+			{
+				kept.push_back(s);
+			}
+		}
+		return kept;
+	}
+
+	// Runs benchmarks under one configuration and keeps their results for reporting.
+	class bench_runner
+	{
+	public:
+		bench_runner() = default;
+		explicit bench_runner(const bench_config& config)
+			:
+			m_config(config)
+		{}
+
+		// Times fn(), which should pass its result to do_not_optimize. The body is
+		// repeated in batches timed with time_bench; each batch is one sample.
+		template<typename Fn>
+		const bench_result& run(std::string_view name, Fn&& fn, throughput work = {})
+		{
+			using clock = std::chrono::steady_clock;
+			const size_t iterations = calibrate(fn);
+
+			time_log log{};
+			std::vector<double> samples;
+			samples.reserve(m_config.max_samples);
+			const auto start = clock::now();
+			while (samples.size() < m_config.max_samples)
+			{
+				{
+					time_bench timer{log};
+					for (size_t i = 0; i < iterations; i++)
+					{
+						fn();
+					}
+				}
+				samples.push_back(log.get_deltas().back().count() / static_cast<double>(iterations));
+				if (samples.size() >= m_config.min_samples &&
+					(stable(samples) || clock::now() - start >= m_config.max_time))
+				{
+					break;
+				}
+			}
+
+			bench_result result{};
+			result.name = name;
+			result.iterations = iterations;
+			result.sample_times = reject_outliers(samples, m_config.outlier_fence);
+			result.samples = result.sample_times.size();
+			result.outliers = samples.size() - result.samples;
+			result.stats = compute_stats(result.sample_times);
+			if (log.allocation_samples() != 0)
+			{
+				result.allocations = static_cast<double>(log.allocation_totals().allocations) / static_cast<double>(samples.size() * iterations);
+			}
+			if (result.stats.mean > 0)
+			{
+				result.items_per_second = work.items / result.stats.mean;
+				result.bytes_per_second = work.bytes / result.stats.mean;
+			}
+			m_results.push_back(std::move(result));
+			return m_results.back();
+		}
+
+		const std::vector<bench_result>& results() const noexcept
+		{
+			return m_results;
+		}
+		void clear() noexcept
+		{
+			m_results.clear();
+		}
+
+		// One line per benchmark, times in nanoseconds per iteration.
+		void print(std::ostream& out) const
+		{
+			out << std::left << std::setw(40) << "benchmark" << std::right
+				<< std::setw(12) << "min ns" << std::setw(12) << "median ns" << std::setw(12) << "mean ns"
+				<< std::setw(12) << "p90 ns" << std::setw(12) << "p99 ns" << std::setw(10) << "stddev%"
+				<< std::setw(14) << "items/s" << std::setw(14) << "bytes/s" << std::setw(12) << "allocs/it" << '\n';
+			const auto flags = out.flags();
+			out << std::fixed;
+			for (const bench_result& r : m_results)
+			{
+				const bench_stats& s = r.stats;
+				out << std::left << std::setw(40) << r.name << std::right << std::setprecision(1)
+					<< std::setw(12) << s.min * 1e9 << std::setw(12) << s.median * 1e9 << std::setw(12) << s.mean * 1e9
+					<< std::setw(12) << s.p90 * 1e9 << std::setw(12) << s.p99 * 1e9
+					<< std::setw(10) << (s.mean > 0 ? 100.0 * s.stddev / s.mean : 0.0)
+					<< std::scientific << std::setprecision(3)
+					<< std::setw(14) << r.items_per_second << std::setw(14) << r.bytes_per_second
+					<< std::fixed << std::setprecision(2) << std::setw(12) << r.allocations << '\n';
+			}
+			out.flags(flags);
+		}
+
+		// {"benchmarks": [{"name": ..., "iterations": ..., "median": ..., "samples_ns": [...]}, ...]}
+		// with the stats as flat fields of each benchmark, every time in seconds except the
+		// raw samples.
+		void write_json(std::ostream& out) const
+		{
+			const auto flags = out.flags();
+			const auto precision = out.precision();
+			out << std::setprecision(17) << "{\n  \"benchmarks\": [";
+			for (size_t i = 0; i < m_results.size(); i++)
+			{
+				const bench_result& r = m_results[i];
+				const bench_stats& s = r.stats;
+				out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+				write_json_string(out, r.name);
+				out << ", \"iterations\": " << r.iterations << ", \"samples\": " << r.samples << ", \"outliers\": " << r.outliers
+					<< ", \"min\": " << s.min << ", \"median\": " << s.median << ", \"mean\": " << s.mean
+					<< ", \"p90\": " << s.p90 << ", \"p99\": " << s.p99 << ", \"stddev\": " << s.stddev
+					<< ", \"items_per_second\": " << r.items_per_second << ", \"bytes_per_second\": " << r.bytes_per_second
+					<< ", \"allocations\": " << r.allocations << ", \"samples_ns\": [";
+				for (size_t j = 0; j < r.sample_times.size(); j++)
+				{
+					out << (j == 0 ? "" : ", ") << r.sample_times[j] * 1e9;
+				}
+				out << "]}";
+			}
+			out << "\n  ]\n}\n";
+			out.flags(flags);
+			out.precision(precision);
+		}
+
+	private:
+		// Warms up while doubling the batch size until a batch lasts min_sample_time.
+		template<typename Fn>
+		size_t calibrate(Fn& fn) const
+		{
+			using clock = std::chrono::steady_clock;
+			size_t iterations = 1;
+			const auto start = clock::now();
+			while (true)
+			{
+				const auto batchStart = clock::now();
+				for (size_t i = 0; i < iterations; i++)
+				{
+					fn();
+				}
+				const auto now = clock::now();
+				const bool longEnough = now - batchStart >= m_config.min_sample_time;
+				if (longEnough && now - start >= m_config.warmup)
+				{
+					return iterations;
+				}
+				if (!longEnough)
+				{
+					iterations *= 2;
+				}
+			}
+		}
+
+		bool stable(std::span<const double> samples) const
+		{
+			const bench_stats stats = compute_stats(samples);
+			const double standardError = stats.stddev / std::sqrt(static_cast<double>(samples.size()));
+			return standardError <= m_config.target_relative_error * stats.mean;
+		}
+
+		bench_config m_config{};
+		std::vector<bench_result> m_results;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,452 @@
+#ifndef BENCH_SUITE_H
+#define BENCH_SUITE_H
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#include <clmMath/clm_vector.h>
+#include <clmMath/clm_matrix.h>
+#include <clmMath/clm_gen_math.h>
+#include <clmMath/clm_geo.h>
+#include <clmMath/clm_color.h>
+#include <clmMath/clm_dyn_matrix.h>
+#include <clmMath/clm_rasterizer.h>
+
+#include "bench_runner.h"
+#include "vector_bench.h"
+#include "matrix_bench.h"
+#include "dyn_matrix_bench.h"
+#include "raster_bench.h"
+
+// The library's core operations under bench_runner, each over a cache-resident and a
+// memory-bound working set. Names are "group/operation/type/count" and stay stable
+// between versions, since bench_compare pairs results by name.
+namespace clm::bench {
+	struct suite_config
+	{
+		// Element counts per benchmark; the defaults fit L1 and overflow the LLC.
+		std::vector<size_t> sizes{1024, 1 << 20};
+		// Only benchmarks whose name contains this run.
+		std::string filter;
+	};
+
+	namespace detail {
+		inline std::string bench_name(std::string_view group, std::string_view op, std::string_view type, size_t count)
+		{
+			return std::string{group} + '/' + std::string{op} + '/' + std::string{type} + '/' + std::to_string(count);
+		}
+
+		inline bool selected(const suite_config& config, std::string_view name) noexcept
+		{
+			return config.filter.empty() || name.find(config.filter) != std::string_view::npos;
+		}
+
+		template<typename T, size_t dim>
+		std::vector<math::Vector<T, dim>> random_vectors(size_t count, unsigned seed)
+		{
+			std::mt19937 rng{seed};
+			std::uniform_real_distribution<T> dist{static_cast<T>(0.5), static_cast<T>(2)};
+			std::vector<math::Vector<T, dim>> vecs(count);
+			for (auto& v : vecs)
+			{
+				for (size_t j = 0; j < dim; j++)
+				{
+					v[j] = dist(rng);
+				}
+			}
+			return vecs;
+		}
+
+		template<typename T, size_t dim>
+		void vector_suite(bench_runner& runner, const suite_config& config, std::string_view type)
+		{
+			using vec_t = math::Vector<T, dim>;
+			for (size_t n : config.sizes)
+			{
+				const auto a = random_vectors<T, dim>(n, 1u);
+				const auto b = random_vectors<T, dim>(n, 2u);
+				std::vector<vec_t> out(n);
+				const throughput work{static_cast<double>(n), static_cast<double>(2 * n * sizeof(vec_t))};
+				const T scale = static_cast<T>(0.75);
+
+				const auto name = [&](std::string_view op) { return bench_name("vector", op, type, n); };
+				if (const auto id = name("add_scale"); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						for (size_t i = 0; i < n; i++)
+						{
+							out[i] = a[i] + b[i] * scale;
+						}
+						do_not_optimize(out.data());
+					}, work);
+				}
+				if (const auto id = name("dot"); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						T acc{};
+						for (size_t i = 0; i < n; i++)
+						{
+							acc += math::dot(a[i], b[i]);
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+				if constexpr (dim == 3)
+				{
+					if (const auto id = name("cross"); selected(config, id))
+					{
+						runner.run(id, [&]() {
+							for (size_t i = 0; i < n; i++)
+							{
+								out[i] = math::cross(a[i], b[i]);
+							}
+							do_not_optimize(out.data());
+						}, work);
+					}
+				}
+				if (const auto id = name("unit_vector"); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						for (size_t i = 0; i < n; i++)
+						{
+							out[i] = math::unit_vector(a[i]);
+						}
+						do_not_optimize(out.data());
+					}, throughput{static_cast<double>(n), static_cast<double>(n * sizeof(vec_t))});
+				}
+			}
+		}
+
+		// The operation mix of bench_vector_ops, through Vector and through the std::array
+		// reference, so the two names differ only in the last "_scalar_ref".
+		template<typename T, size_t dim>
+		void vector_mix_suite(bench_runner& runner, const suite_config& config, std::string_view type)
+		{
+			using vec_t = math::Vector<T, dim>;
+			using arr_t = scalar_ref::vec_t<T, dim>;
+			for (size_t n : config.sizes)
+			{
+				const auto vecs = random_vectors<T, dim>(n, 4u);
+				std::vector<arr_t> arrs(n);
+				for (size_t i = 0; i < n; i++)
+				{
+					for (size_t j = 0; j < dim; j++)
+					{
+						arrs[i][j] = vecs[i][j];
+					}
+				}
+				const throughput work{static_cast<double>(n), static_cast<double>(n * sizeof(vec_t))};
+				const T scale = static_cast<T>(0.75);
+
+				if (const auto id = bench_name("vector", "mix", type, n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						T acc{};
+						for (size_t i = 2; i < n; i++)
+						{
+							const vec_t v = vecs[i - 2] + vecs[i - 1] * scale - vecs[i];
+							acc += math::dot(v, vecs[i]);
+							if constexpr (dim == 3)
+							{
+								acc += math::cross(vecs[i - 1], vecs[i])[0];
+							}
+							acc += math::unit_vector(vecs[i])[0];
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+				if (const auto id = bench_name("vector", "mix_scalar_ref", type, n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						T acc{};
+						for (size_t i = 2; i < n; i++)
+						{
+							const auto v = scalar_ref::fused(arrs[i - 2], arrs[i - 1], arrs[i], scale);
+							acc += scalar_ref::dot(v, arrs[i]);
+							if constexpr (dim == 3)
+							{
+								acc += scalar_ref::cross(arrs[i - 1], arrs[i])[0];
+							}
+							acc += scalar_ref::unit_vector(arrs[i])[0];
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+			}
+		}
+
+		inline void matrix_suite(bench_runner& runner, const suite_config& config)
+		{
+			for (size_t n : config.sizes)
+			{
+				std::mt19937 rng{42u};
+				std::vector<math::Matrix4f> mats(n);
+				for (auto& m : mats)
+				{
+					m = random_matrix(rng);
+				}
+				std::vector<math::Matrix4f> out(n);
+				const throughput work{static_cast<double>(n), static_cast<double>(n * sizeof(math::Matrix4f))};
+
+				if (const auto id = bench_name("matrix", "multiply", "Matrix4f", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						for (size_t i = 1; i < n; i++)
+						{
+							out[i] = mats[i - 1] * mats[i];
+						}
+						do_not_optimize(out.data());
+					}, work);
+				}
+				if (const auto id = bench_name("matrix", "determinant", "Matrix4f", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						float acc{};
+						for (const auto& m : mats)
+						{
+							acc += m.determinant();
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+				if (const auto id = bench_name("matrix", "transpose", "Matrix4f", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						for (size_t i = 0; i < n; i++)
+						{
+							out[i] = mats[i].transpose();
+						}
+						do_not_optimize(out.data());
+					}, work);
+				}
+			}
+		}
+
+		// sqrt_ce is the constexpr iteration sqrt falls back to at compile time; timing it
+		// at run time shows what a stray runtime call to it costs.
+		inline void scalar_suite(bench_runner& runner, const suite_config& config)
+		{
+			for (size_t n : config.sizes)
+			{
+				std::mt19937 rng{3u};
+				std::uniform_real_distribution<double> dist{1e-3, 1e6};
+				std::vector<double> values(n);
+				for (auto& v : values)
+				{
+					v = dist(rng);
+				}
+				std::vector<std::uint32_t> words(n);
+				for (auto& w : words)
+				{
+					w = static_cast<std::uint32_t>(rng()) >> (rng() % 32);
+				}
+				const throughput work{static_cast<double>(n), static_cast<double>(n * sizeof(double))};
+
+				if (const auto id = bench_name("math", "sqrt", "double", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						double acc{};
+						for (double v : values)
+						{
+							acc += math::sqrt(v);
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+				if (const auto id = bench_name("math", "sqrt_ce", "double", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						double acc{};
+						for (double v : values)
+						{
+							acc += math::sqrt_ce(v);
+						}
+						do_not_optimize(acc);
+					}, work);
+				}
+				const throughput wordWork{static_cast<double>(n), static_cast<double>(n * sizeof(std::uint32_t))};
+				if (const auto id = bench_name("math", "lzcnt", "uint32", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						std::uint32_t acc{};
+						for (std::uint32_t w : words)
+						{
+							acc += math::lzcnt(w);
+						}
+						do_not_optimize(acc);
+					}, wordWork);
+				}
+				if (const auto id = bench_name("math", "lzcnt_ce", "uint32", n); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						std::uint32_t acc{};
+						for (std::uint32_t w : words)
+						{
+							acc += math::lzcnt_ce(w);
+						}
+						do_not_optimize(acc);
+					}, wordWork);
+				}
+			}
+		}
+
+		// Segments with both endpoints uniform in a square, so about a quarter of the pairs
+		// intersect and the branch predictor can't settle on either answer.
+		inline void geo_suite(bench_runner& runner, const suite_config& config)
+		{
+			for (size_t n : config.sizes)
+			{
+				if (const auto id = bench_name("geo", "lines_intersect", "Point2d", n); selected(config, id))
+				{
+					std::mt19937 rng{5u};
+					std::uniform_real_distribution<double> pos{0.0, 100.0};
+					std::vector<std::array<math::Point2d, 4>> pairs(n);
+					for (auto& p : pairs)
+					{
+						for (auto& point : p)
+						{
+							point = math::Point2d{pos(rng), pos(rng)};
+						}
+					}
+					runner.run(id, [&]() {
+						size_t hits = 0;
+						for (const auto& p : pairs)
+						{
+							hits += math::lines_intersect(p[0], p[1], p[2], p[3]) ? 1 : 0;
+						}
+						do_not_optimize(hits);
+					}, throughput{static_cast<double>(n), static_cast<double>(n * sizeof(pairs[0]))});
+				}
+			}
+		}
+
+		// Square products holding about n elements per operand, so the count in the name is
+		// the side length. Items are floating point operations; the naive loop stops at
+		// 512, past which one run takes seconds.
+		inline void dyn_matrix_suite(bench_runner& runner, const suite_config& config)
+		{
+			for (size_t n : config.sizes)
+			{
+				const auto side = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+				std::mt19937 rng{99u};
+				const auto lhs = random_dyn_matrix<float>(side, side, rng);
+				const auto rhs = random_dyn_matrix<float>(side, side, rng);
+				math::DynMatrix<float> out{};
+				const throughput work{2.0 * static_cast<double>(side * side * side),
+									  static_cast<double>(3 * side * side * sizeof(float))};
+
+				if (const auto id = bench_name("dyn_matrix", "gemm", "float", side); selected(config, id))
+				{
+					runner.run(id, [&]() { math::gemm(lhs, rhs, out); do_not_optimize(out.data()); }, work);
+				}
+				if (side > 512)
+				{
+					continue;
+				}
+				if (const auto id = bench_name("dyn_matrix", "gemm_naive", "float", side); selected(config, id))
+				{
+					runner.run(id, [&]() { naive_gemm(lhs, rhs, out); do_not_optimize(out.data()); }, work);
+				}
+			}
+		}
+
+		// n triangles with 8 pixel legs into a 1080p target, flat and interpolated.
+		inline void raster_suite(bench_runner& runner, const suite_config& config)
+		{
+			constexpr std::int32_t width = 1920;
+			constexpr std::int32_t height = 1080;
+			color::TiledImage target{width, height};
+			color::TriangleRasterizer rasterizer{};
+			for (size_t n : config.sizes)
+			{
+				const auto triangles = make_triangles(n, 8.0f, width, height);
+				const throughput work{static_cast<double>(n), static_cast<double>(n * sizeof(color::RasterTriangle))};
+				for (bool interpolate : {false, true})
+				{
+					const auto id = bench_name("raster", interpolate ? "draw_interpolated" : "draw_flat", "RasterTriangle", n);
+					if (selected(config, id))
+					{
+						runner.run(id, [&]() {
+							rasterizer.draw(triangles, target.view(), color::RasterOptions{interpolate, false});
+						}, work);
+					}
+				}
+			}
+		}
+
+		inline void color_suite(bench_runner& runner, const suite_config& config)
+		{
+			for (size_t n : config.sizes)
+			{
+				std::mt19937 rng{9u};
+				std::uniform_real_distribution<float> channel{0.0f, 1.0f};
+				std::vector<color::ColorRGBAf> colors(n);
+				std::vector<color::ColorRGBA8> packed(n);
+				for (size_t i = 0; i < n; i++)
+				{
+					colors[i] = color::ColorRGBAf{channel(rng), channel(rng), channel(rng), channel(rng)};
+					packed[i] = color::ColorRGBA8{static_cast<std::uint8_t>(rng()), static_cast<std::uint8_t>(rng()),
+												  static_cast<std::uint8_t>(rng()), static_cast<std::uint8_t>(rng())};
+				}
+				std::vector<color::ColorRGBAf> out(n);
+				std::vector<color::ColorRGBA8> packedOut(n);
+				const throughput work{static_cast<double>(n), static_cast<double>(n * sizeof(color::ColorRGBAf))};
+
+				const auto name = [&](std::string_view op) { return bench_name("color", op, "RGBA", n); };
+				if (const auto id = name("srgb_to_linear"); selected(config, id))
+				{
+					runner.run(id, [&]() { color::srgb_to_linear(colors, out); do_not_optimize(out.data()); }, work);
+				}
+				if (const auto id = name("linear_to_srgb"); selected(config, id))
+				{
+					runner.run(id, [&]() { color::linear_to_srgb(colors, out); do_not_optimize(out.data()); }, work);
+				}
+				if (const auto id = name("srgb8_to_linear"); selected(config, id))
+				{
+					runner.run(id, [&]() { color::srgb8_to_linear(packed, out); do_not_optimize(out.data()); }, work);
+				}
+				if (const auto id = name("pack"); selected(config, id))
+				{
+					runner.run(id, [&]() { color::pack(colors, packedOut); do_not_optimize(packedOut.data()); }, work);
+				}
+				if (const auto id = name("unpack"); selected(config, id))
+				{
+					runner.run(id, [&]() { color::unpack(packed, out); do_not_optimize(out.data()); }, work);
+				}
+				if (const auto id = name("to_color"); selected(config, id))
+				{
+					runner.run(id, [&]() {
+						for (size_t i = 0; i < n; i++)
+						{
+							out[i] = color::ColorRGBAf::from_color(colors[i].to_color() * 0.5f);
+						}
+						do_not_optimize(out.data());
+					}, work);
+				}
+			}
+		}
+	}
+
+	inline void run_suite(bench_runner& runner, const suite_config& config = {})
+	{
+		detail::vector_suite<float, 3>(runner, config, "Vec3f");
+		detail::vector_suite<float, 4>(runner, config, "Vec4f");
+		detail::vector_suite<double, 4>(runner, config, "Vec4d");
+		detail::vector_mix_suite<float, 3>(runner, config, "Vec3f");
+		detail::vector_mix_suite<float, 4>(runner, config, "Vec4f");
+		detail::vector_mix_suite<double, 4>(runner, config, "Vec4d");
+		detail::matrix_suite(runner, config);
+		detail::dyn_matrix_suite(runner, config);
+		detail::scalar_suite(runner, config);
+		detail::geo_suite(runner, config);
+		detail::color_suite(runner, config);
+		detail::raster_suite(runner, config);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef DYN_MATRIX_BENCH_H
+#define DYN_MATRIX_BENCH_H
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <format>
+#include <initializer_list>
+
+#include <clmMath/clm_dyn_matrix.h>
+
+#include "time_bench.h"
+#include "time_log.h"
+
+namespace clm::bench {
+	template<typename T>
+	math::DynMatrix<T> random_dyn_matrix(size_t rows, size_t cols, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<T> dist{static_cast<T>(-1), static_cast<T>(1)};
+		math::DynMatrix<T> mat{rows, cols};
+		for (size_t i = 0; i < rows; i++)
+		{
+			for (size_t j = 0; j < cols; j++)
+			{
+				mat(i, j) = dist(rng);
+			}
+		}
+		return mat;
+	}
+
+	// Straightforward i-k-j product, the baseline the blocked gemm is measured against.
+	template<typename T>
+	void naive_gemm(const math::DynMatrix<T>& lhs, const math::DynMatrix<T>& rhs, math::DynMatrix<T>& out)
+	{
+		out = math::DynMatrix<T>{lhs.rows(), rhs.cols()};
+		for (size_t i = 0; i < lhs.rows(); i++)
+		{
+			for (size_t k = 0; k < lhs.cols(); k++)
+			{
+				const T a = lhs(i, k);
+				for (size_t j = 0; j < rhs.cols(); j++)
+				{
+					out(i, j) += a * rhs(k, j);
+				}
+			}
+		}
+	}
+
+	inline double gflops(size_t size, const time_log& log)
+	{
+		const auto& deltas = log.get_deltas();
+		if (deltas.empty())
+		{
+			return 0.0;
+		}
+		const double best = std::min_element(deltas.begin(), deltas.end())->count();
+		return 2.0 * static_cast<double>(size) * static_cast<double>(size) * static_cast<double>(size) / best * 1e-9;
+	}
+
+	// Square n x n products at each size; the naive loop is only run up to naiveLimit.
+	template<typename T>
+	void run_gemm_bench(std::initializer_list<size_t> sizes = {128, 256, 512, 1024, 2048},
+						size_t repetitions = 3,
+						size_t naiveLimit = 512)
+	{
+		std::mt19937 rng{99u};
+		for (size_t size : sizes)
+		{
+			const auto lhs = random_dyn_matrix<T>(size, size, rng);
+			const auto rhs = random_dyn_matrix<T>(size, size, rng);
+			math::DynMatrix<T> out{};
+
+			time_log gemmLog{};
+			time_log naiveLog{};
+			for (size_t rep = 0; rep < repetitions; rep++)
+			{
+				time_bench timer{gemmLog};
+				math::gemm(lhs, rhs, out);
+			}
+			if (size <= naiveLimit)
+			{
+				for (size_t rep = 0; rep < repetitions; rep++)
+				{
+					time_bench timer{naiveLog};
+					naive_gemm(lhs, rhs, out);
+				}
+			}
+			std::cout << std::format("gemm {0}x{0}: {1:.2f} GFLOP/s (naive {2:.2f} GFLOP/s)\n",
+									 size, gflops(size, gemmLog), gflops(size, naiveLog));
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <ostream>
+#include <string_view>
+
+namespace clm::bench {
+	// Writes text as a quoted JSON string. Control characters without a short escape come
+	// out as \u00XX, so names holding them still produce valid JSON.
+	inline void write_json_string(std::ostream& out, std::string_view text)
+	{
+		out << '"';
+		for (char c : text)
+		{
+			switch (c)
+			{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					const char hex[] = "0123456789abcdef";
+					out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+				}
+				else
+				{
+					out << c;
+				}
+			}
+		}
+		out << '"';
+	}
+}
+
+#endif
\ No newline at end of file
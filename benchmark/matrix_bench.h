@@ -0,0 +1,233 @@
+#ifndef MATRIX_BENCH_H
+#define MATRIX_BENCH_H
+
+#include <array>
+#include <vector>
+#include <random>
+#include <span>
+#include <iostream>
+#include <format>
+#include <utility>
+#include <algorithm>
+
+#include <clmMath/clm_matrix.h>
+#include <clmMath/clm_transform.h>
+
+#include "time_bench.h"
+#include "time_log.h"
+
+namespace clm::bench {
+	namespace scalar_ref {
+		using mat4f_t = std::array<std::array<float, 4>, 4>;
+
+		// The i-j-k loop of the generic Matrix::operator*.
+		inline mat4f_t mul(const mat4f_t& lhs, const mat4f_t& rhs) noexcept
+		{
+			mat4f_t out{};
+			for (size_t i = 0; i < 4; i++)
+			{
+				for (size_t j = 0; j < 4; j++)
+				{
+					for (size_t k = 0; k < 4; k++)
+					{
+						out[i][j] += lhs[i][k] * rhs[k][j];
+					}
+				}
+			}
+			return out;
+		}
+
+		inline std::array<float, 3> transform_point(const mat4f_t& mat, const std::array<float, 3>& p) noexcept
+		{
+			std::array<float, 3> out{};
+			for (size_t i = 0; i < 3; i++)
+			{
+				out[i] = mat[i][0] * p[0] + mat[i][1] * p[1] + mat[i][2] * p[2] + mat[i][3];
+			}
+			return out;
+		}
+	}
+
+	inline math::Matrix4f random_matrix(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+		math::Matrix4f mat{};
+		for (size_t i = 0; i < 4; i++)
+		{
+			for (size_t j = 0; j < 4; j++)
+			{
+				mat[i][j] = dist(rng);
+			}
+		}
+		return mat;
+	}
+
+	// Chains count 4x4 products through the SIMD Matrix4f path and the scalar reference.
+	inline void bench_matrix_mul(size_t count, size_t repetitions, time_log& simdLog, time_log& scalarLog)
+	{
+		std::mt19937 rng{42u};
+		std::vector<math::Matrix4f> mats(count);
+		std::vector<scalar_ref::mat4f_t> arrs(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			mats[i] = random_matrix(rng);
+			for (size_t r = 0; r < 4; r++)
+			{
+				arrs[i][r] = mats[i][r];
+			}
+		}
+
+		volatile float sink{};
+		for (size_t rep = 0; rep < repetitions; rep++)
+		{
+			{
+				time_bench timer{simdLog};
+				float acc{};
+				for (size_t i = 1; i < count; i++)
+				{
+					acc += (mats[i - 1] * mats[i])[1][2];
+				}
+				sink = acc;
+			}
+			{
+				time_bench timer{scalarLog};
+				float acc{};
+				for (size_t i = 1; i < count; i++)
+				{
+					acc += scalar_ref::mul(arrs[i - 1], arrs[i])[1][2];
+				}
+				sink = acc;
+			}
+		}
+		(void)sink;
+	}
+
+	// Pushes count points through one matrix: scalar loop, AoS span kernel and SoA kernel.
+	inline void bench_transform_points(size_t count, size_t repetitions, time_log& aosLog, time_log& soaLog, time_log& scalarLog)
+	{
+		std::mt19937 rng{7u};
+		std::uniform_real_distribution<float> dist{-100.0f, 100.0f};
+		const math::Matrix4f mat = random_matrix(rng);
+		scalar_ref::mat4f_t arrMat{};
+		for (size_t r = 0; r < 4; r++)
+		{
+			arrMat[r] = mat[r];
+		}
+
+		std::vector<math::Vec3f> points(count);
+		std::vector<std::array<float, 3>> arrPoints(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			points[i] = math::Vec3f{dist(rng), dist(rng), dist(rng)};
+			arrPoints[i] = {points[i][0], points[i][1], points[i][2]};
+		}
+		math::Vec3fBatch batch{std::span<const math::Vec3f>{points}};
+		math::Vec3fBatch batchOut{};
+		std::vector<math::Vec3f> out(count);
+		std::vector<std::array<float, 3>> arrOut(count);
+
+		for (size_t rep = 0; rep < repetitions; rep++)
+		{
+			{
+				time_bench timer{aosLog};
+				math::transform_points(mat, std::span<const math::Vec3f>{points}, std::span<math::Vec3f>{out});
+			}
+			{
+				time_bench timer{soaLog};
+				math::transform_points(mat, batch, batchOut);
+			}
+			{
+				time_bench timer{scalarLog};
+				for (size_t i = 0; i < count; i++)
+				{
+					arrOut[i] = scalar_ref::transform_point(arrMat, arrPoints[i]);
+				}
+			}
+		}
+	}
+
+	// Times determinant() (closed form up to 4x4, LU above) against the cofactor recursion
+	// for the same count random matrices of size dim.
+	template<size_t dim>
+	void bench_determinant(size_t count, time_log& luLog, time_log& cofactorLog)
+	{
+		std::mt19937 rng{static_cast<unsigned>(dim)};
+		std::uniform_real_distribution<double> dist{-1.0, 1.0};
+		std::vector<math::Matrix<dim, double>> mats(count);
+		for (auto& mat : mats)
+		{
+			for (size_t i = 0; i < dim; i++)
+			{
+				for (size_t j = 0; j < dim; j++)
+				{
+					mat[i][j] = dist(rng);
+				}
+			}
+		}
+
+		volatile double sink{};
+		{
+			time_bench timer{luLog};
+			double acc{};
+			for (const auto& mat : mats)
+			{
+				acc += mat.determinant();
+			}
+			sink = acc;
+		}
+		{
+			time_bench timer{cofactorLog};
+			double acc{};
+			for (const auto& mat : mats)
+			{
+				acc += mat.determinant_cofactor();
+			}
+			sink = acc;
+		}
+		(void)sink;
+	}
+
+	// The cofactor expansion is O(dim!), so the matrix count shrinks with dim to keep the
+	// larger sizes finishing in seconds; both methods always see the same matrices.
+	inline void run_determinant_bench(size_t budget = 4'000'000)
+	{
+		[&]<size_t...dims>(std::index_sequence<dims...>) {
+			([&] {
+				constexpr size_t dim = dims + 3;
+				size_t factorial = 1;
+				for (size_t i = 2; i <= dim; i++)
+				{
+					factorial *= i;
+				}
+				const size_t count = std::max<size_t>(1, budget / factorial);
+				time_log luLog{};
+				time_log cofactorLog{};
+				bench_determinant<dim>(count, luLog, cofactorLog);
+				std::cout << std::format("determinant {}x{} over {} matrices (LU / cofactor)\n", dim, dim, count);
+				luLog.print();
+				cofactorLog.print();
+			}(), ...);
+		}(std::make_index_sequence<8>{});
+	}
+
+	inline void run_matrix_bench(size_t count = 1'000'000, size_t repetitions = 10)
+	{
+		time_log simdLog{};
+		time_log scalarLog{};
+		std::cout << "Matrix4f * Matrix4f (SIMD / scalar)\n";
+		bench_matrix_mul(count, repetitions, simdLog, scalarLog);
+		simdLog.print();
+		scalarLog.print();
+
+		time_log aosLog{};
+		time_log soaLog{};
+		time_log refLog{};
+		std::cout << "transform_points (AoS / SoA / scalar)\n";
+		bench_transform_points(count, repetitions, aosLog, soaLog, refLog);
+		aosLog.print();
+		soaLog.print();
+		refLog.print();
+	}
+}
+
+#endif
\ No newline at end of file
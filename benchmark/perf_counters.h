@@ -0,0 +1,225 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware event counts for benchmark scopes, through perf_event_open on Linux. Counters
+// the kernel refuses (no PMU in a VM or container, perf_event_paranoid too strict) are
+// left out one by one; when none open, or on other systems, a group is simply unavailable
+// and samples come back empty.
+namespace clm::bench {
+	enum class perf_counter : std::uint8_t
+	{
+		cycles,
+		instructions,
+		l1d_misses,
+		llc_misses,
+		branch_misses
+	};
+	inline constexpr size_t perf_counter_count = 5;
+
+	inline constexpr std::array<perf_counter, perf_counter_count> all_perf_counters{
+		perf_counter::cycles, perf_counter::instructions, perf_counter::l1d_misses,
+		perf_counter::llc_misses, perf_counter::branch_misses
+	};
+
+	constexpr std::string_view perf_counter_name(perf_counter counter) noexcept
+	{
+		switch (counter)
+		{
+		case perf_counter::cycles: return "cycles";
+		case perf_counter::instructions: return "instructions";
+		case perf_counter::l1d_misses: return "L1d misses";
+		case perf_counter::llc_misses: return "LLC misses";
+		case perf_counter::branch_misses: return "branch misses";
+		}
+		return "";
+	}
+
+	// Counts for the counters whose bit is set in available; the rest read 0.
+	struct counter_sample
+	{
+		std::array<std::uint64_t, perf_counter_count> values{};
+		std::uint32_t available = 0;
+
+		bool has(perf_counter counter) const noexcept
+		{
+			return (available >> static_cast<unsigned>(counter)) & 1u;
+		}
+		std::uint64_t operator[](perf_counter counter) const noexcept
+		{
+			return values[static_cast<size_t>(counter)];
+		}
+		bool empty() const noexcept
+		{
+			return available == 0;
+		}
+		// Instructions per cycle, 0 without both counters.
+		double ipc() const noexcept
+		{
+			const std::uint64_t c = (*this)[perf_counter::cycles];
+			return has(perf_counter::cycles) && has(perf_counter::instructions) && c != 0
+				? static_cast<double>((*this)[perf_counter::instructions]) / static_cast<double>(c) : 0.0;
+		}
+
+		// Counters only one side has are dropped.
+		counter_sample& operator+=(const counter_sample& rhs) noexcept
+		{
+			available = empty() ? rhs.available : available & rhs.available;
+			for (size_t i = 0; i < perf_counter_count; i++)
+			{
+				values[i] += rhs.values[i];
+			}
+			return *this;
+		}
+		friend counter_sample operator-(const counter_sample& end, const counter_sample& start) noexcept
+		{
+			counter_sample delta{};
+			delta.available = end.available & start.available;
+			for (size_t i = 0; i < perf_counter_count; i++)
+			{
+				delta.values[i] = end.values[i] >= start.values[i] ? end.values[i] - start.values[i] : 0;
+			}
+			return delta;
+		}
+	};
+
+	// One perf event group counting the calling thread in user mode from construction on.
+	// read() is a single syscall returning every counter at the same instant, scaled up
+	// when the kernel had to multiplex the group.
+	class perf_counter_group
+	{
+	public:
+		explicit perf_counter_group(std::span<const perf_counter> counters = all_perf_counters) noexcept
+		{
+#if defined(__linux__)
+			for (perf_counter counter : counters)
+			{
+				perf_event_attr attr{};
+				attr.size = sizeof(attr);
+				set_event(attr, counter);
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+				const int leader = m_fds.empty() ? -1 : m_fds.front();
+				const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+				if (fd >= 0)
+				{
+					m_fds.push_back(static_cast<int>(fd));
+					m_slots.push_back(counter);
+				}
+			}
+#else
+			static_cast<void>(counters);
+#endif
+		}
+		~perf_counter_group()
+		{
+#if defined(__linux__)
+			for (int fd : m_fds)
+			{
+				close(fd);
+			}
+#endif
+		}
+		perf_counter_group(const perf_counter_group&) = delete;
+		perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+		bool available() const noexcept
+		{
+			return !m_fds.empty();
+		}
+		bool has(perf_counter counter) const noexcept
+		{
+			for (perf_counter c : m_slots)
+			{
+				if (c == counter)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Running totals; subtract two reads for a scope.
+		counter_sample read() const noexcept
+		{
+			counter_sample sample{};
+#if defined(__linux__)
+			if (m_fds.empty())
+			{
+				return sample;
+			}
+			std::array<std::uint64_t, 3 + perf_counter_count> buffer{};
+			const ssize_t bytes = ::read(m_fds.front(), buffer.data(), sizeof(buffer));
+			if (bytes < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) || buffer[0] != m_slots.size())
+			{
+				return sample;
+			}
+			const std::uint64_t enabled = buffer[1];
+			const std::uint64_t running = buffer[2];
+			// Never scheduled: the zeros are not counts, so nothing is available.
+			if (running == 0)
+			{
+				return sample;
+			}
+			for (size_t i = 0; i < m_slots.size(); i++)
+			{
+				std::uint64_t value = buffer[3 + i];
+				if (running < enabled)
+				{
+					value = static_cast<std::uint64_t>(static_cast<double>(value) * static_cast<double>(enabled) / static_cast<double>(running));
+				}
+				sample.values[static_cast<size_t>(m_slots[i])] = value;
+				sample.available |= 1u << static_cast<unsigned>(m_slots[i]);
+			}
+#endif
+			return sample;
+		}
+
+	private:
+#if defined(__linux__)
+		static void set_event(perf_event_attr& attr, perf_counter counter) noexcept
+		{
+			switch (counter)
+			{
+			case perf_counter::cycles:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case perf_counter::instructions:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case perf_counter::l1d_misses:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case perf_counter::llc_misses:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CACHE_MISSES;
+				break;
+			case perf_counter::branch_misses:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+			}
+		}
+#endif
+
+		std::vector<int> m_fds;
+		std::vector<perf_counter> m_slots;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef RASTER_BENCH_H
+#define RASTER_BENCH_H
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <format>
+#include <algorithm>
+
+#include <clmMath/clm_rasterizer.h>
+
+#include "time_bench.h"
+#include "time_log.h"
+
+namespace clm::bench {
+	// Random triangles with legs of about size pixels over a width x height target.
+	inline std::vector<color::RasterTriangle> make_triangles(size_t count, float size, float width, float height)
+	{
+		std::mt19937 rng{1234u};
+		std::uniform_real_distribution<float> x{0.0f, width - size};
+		std::uniform_real_distribution<float> y{0.0f, height - size};
+		std::uniform_real_distribution<float> offset{0.0f, size};
+		std::uniform_real_distribution<float> channel{0.0f, 1.0f};
+
+		std::vector<color::RasterTriangle> triangles(count);
+		for (auto& tri : triangles)
+		{
+			const float left = x(rng);
+			const float top = y(rng);
+			tri.vertices = {math::Point2f{left + offset(rng), top},
+							math::Point2f{left + size, top + offset(rng)},
+							math::Point2f{left, top + size}};
+			for (auto& c : tri.colors)
+			{
+				c = color::ColorRGBAf{channel(rng), channel(rng), channel(rng), 1.0f};
+			}
+		}
+		return triangles;
+	}
+
+	// Triangles per second at several triangle sizes, flat and interpolated, into a 1080p
+	// target. The best of repetitions is reported, each draw covering count triangles.
+	inline void run_raster_bench(size_t count = 100'000, size_t repetitions = 5)
+	{
+		constexpr std::int32_t width = 1920;
+		constexpr std::int32_t height = 1080;
+		color::TiledImage target{width, height};
+		color::TriangleRasterizer rasterizer{};
+
+		std::cout << "Triangle rasterizer, 1920x1080\n";
+		for (float size : {2.0f, 8.0f, 32.0f, 128.0f})
+		{
+			const auto triangles = make_triangles(count, size, width, height);
+			for (bool interpolate : {false, true})
+			{
+				time_log log{};
+				for (size_t rep = 0; rep < repetitions; rep++)
+				{
+					time_bench timer{log};
+					rasterizer.draw(triangles, target.view(), color::RasterOptions{interpolate, false});
+				}
+				const auto best = std::ranges::min(log.get_deltas());
+				std::cout << std::format("{:>5}px {:<12}\t{:.2f} Mtri/s\n", size, interpolate ? "interpolated" : "flat",
+										 static_cast<double>(count) / best.count() / 1e6);
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
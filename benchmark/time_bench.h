@@ -4,6 +4,9 @@
 #include <chrono>
 
 #include "time_log.h"
+#include "perf_counters.h"
+#include "alloc_tracker.h"
+#include "trace.h"
 
 namespace clm::bench {
 	class time_bench {
@@ -11,18 +14,54 @@ namespace clm::bench {
 		time_bench() = delete;
 		time_bench(time_log& log) noexcept
 			:
-			m_log(log)
+			m_log(log), m_zone(nullptr)
 		{
 			m_start = std::chrono::high_resolution_clock::now();
 		}
+		// Also records the scope as a trace zone while tracing is enabled; see trace.h.
+		time_bench(time_log& log, const char* zone) noexcept
+			:
+			m_log(log), m_zone(zone)
+		{
+			m_start = std::chrono::high_resolution_clock::now();
+		}
+		// Also reads the counter group around the scope and logs the counts with the
+		// delta. An unavailable group costs nothing and logs time only.
+		time_bench(time_log& log, const perf_counter_group& counters, const char* zone = nullptr) noexcept
+			:
+			m_log(log), m_zone(zone), m_counters(counters.available() ? &counters : nullptr)
+		{
+			if (m_counters)
+			{
+				m_startCounts = m_counters->read();
+			}
+			m_start = std::chrono::high_resolution_clock::now();
+		}
 		~time_bench()
 		{
 			timestamp_t end = std::chrono::high_resolution_clock::now();
-			m_log.insert_delta(end - m_start);
+			const alloc_stats allocs = m_allocs.stats();
+			if (m_counters)
+			{
+				m_log.insert_delta(end - m_start, m_counters->read() - m_startCounts);
+			}
+			else
+			{
+				m_log.insert_delta(end - m_start);
+			}
+			if (alloc_tracking_enabled())
+			{
+				m_log.insert_allocations(allocs);
+			}
 		}
 	private:
 		timestamp_t m_start;
 		time_log& m_log;
+		trace_zone m_zone;
+		const perf_counter_group* m_counters = nullptr;
+		counter_sample m_startCounts{};
+		// Counts the scope's heap use when the allocation hooks are installed.
+		alloc_scope m_allocs{};
 	};
 }
 
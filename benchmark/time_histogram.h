@@ -0,0 +1,236 @@
+#ifndef TIME_HISTOGRAM_H
+#define TIME_HISTOGRAM_H
+
+#include <bit>
+#include <array>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+namespace clm::bench {
+	// Log-linear bucketing over nanoseconds, as in HdrHistogram: values below 2^subBucketBits
+	// get a bucket each, and every power of two above is split into 2^(subBucketBits - 1)
+	// equal buckets, so a bucket is never wider than 1/128 of the values in it.
+	struct histogram_buckets
+	{
+		static constexpr unsigned subBucketBits = 8;
+		static constexpr std::uint64_t linearLimit = std::uint64_t{1} << subBucketBits;
+		// index() of the largest 64-bit value, plus one.
+		static constexpr size_t count = (static_cast<size_t>(64 - subBucketBits) << (subBucketBits - 1)) + linearLimit;
+
+		static constexpr size_t index(std::uint64_t ns) noexcept
+		{
+			if (ns < linearLimit)
+			{
+				return static_cast<size_t>(ns);
+			}
+			const unsigned shift = static_cast<unsigned>(std::bit_width(ns)) - subBucketBits;
+			return (static_cast<size_t>(shift) << (subBucketBits - 1)) + static_cast<size_t>(ns >> shift);
+		}
+		static constexpr std::uint64_t lowest(size_t bucket) noexcept
+		{
+			if (bucket < linearLimit)
+			{
+				return bucket;
+			}
+			const unsigned shift = static_cast<unsigned>(bucket >> (subBucketBits - 1)) - 1;
+			return static_cast<std::uint64_t>(bucket - (static_cast<size_t>(shift) << (subBucketBits - 1))) << shift;
+		}
+		static constexpr std::uint64_t highest(size_t bucket) noexcept
+		{
+			return bucket + 1 < count ? lowest(bucket + 1) - 1 : std::numeric_limits<std::uint64_t>::max();
+		}
+	};
+	static_assert(histogram_buckets::index(std::numeric_limits<std::uint64_t>::max()) + 1 == histogram_buckets::count);
+
+	// Plain copy of a time_histogram, for queries and merging.
+	class histogram_snapshot
+	{
+	public:
+		using seconds_t = std::chrono::duration<double>;
+
+		histogram_snapshot()
+			:
+			m_counts(histogram_buckets::count)
+		{}
+
+		std::uint64_t count() const noexcept { return m_total; }
+		seconds_t min() const noexcept
+		{
+			if (m_total == 0)
+			{
+				return seconds_t{};
+			}
+			return to_seconds(has_range() ? m_min : histogram_buckets::lowest(first_bucket()));
+		}
+		seconds_t max() const noexcept
+		{
+			if (m_total == 0)
+			{
+				return seconds_t{};
+			}
+			return to_seconds(has_range() ? m_max : histogram_buckets::highest(last_bucket()));
+		}
+		seconds_t mean() const noexcept
+		{
+			return m_total == 0 ? seconds_t{} : seconds_t{static_cast<double>(m_sum) * 1e-9 / static_cast<double>(m_total)};
+		}
+
+		// Value at or below which a fraction p of the samples fall: the middle of its
+		// bucket, kept within the recorded min and max when the snapshot has them.
+		seconds_t percentile(double p) const noexcept
+		{
+			if (m_total == 0)
+			{
+				return seconds_t{};
+			}
+			const double wanted = std::clamp(p, 0.0, 1.0) * static_cast<double>(m_total);
+			const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(wanted)));
+			std::uint64_t seen = 0;
+			for (size_t i = 0; i < m_counts.size(); i++)
+			{
+				seen += m_counts[i];
+				if (seen >= rank)
+				{
+					const std::uint64_t low = histogram_buckets::lowest(i);
+					const std::uint64_t mid = low + (histogram_buckets::highest(i) - low) / 2;
+					return to_seconds(has_range() ? std::clamp(mid, m_min, m_max) : mid);
+				}
+			}
+			return max();
+		}
+
+		void merge(const histogram_snapshot& other) noexcept
+		{
+			for (size_t i = 0; i < m_counts.size(); i++)
+			{
+				m_counts[i] += other.m_counts[i];
+			}
+			m_total += other.m_total;
+			m_sum += other.m_sum;
+			m_min = std::min(m_min, other.m_min);
+			m_max = std::max(m_max, other.m_max);
+		}
+
+		std::uint64_t bucket_count(size_t bucket) const noexcept { return m_counts[bucket]; }
+
+	private:
+		friend class time_histogram;
+
+		static seconds_t to_seconds(std::uint64_t ns) noexcept
+		{
+			return seconds_t{static_cast<double>(ns) * 1e-9};
+		}
+
+		// A snapshot taken while another thread records can hold a sample's count before
+		// its min and max, leaving m_min above m_max; the bucket bounds stand in then.
+		bool has_range() const noexcept
+		{
+			return m_min <= m_max;
+		}
+		size_t first_bucket() const noexcept
+		{
+			size_t i = 0;
+			while (i + 1 < m_counts.size() && m_counts[i] == 0)
+			{
+				i++;
+			}
+			return i;
+		}
+		size_t last_bucket() const noexcept
+		{
+			size_t i = m_counts.size() - 1;
+			while (i > 0 && m_counts[i] == 0)
+			{
+				i--;
+			}
+			return i;
+		}
+
+		std::vector<std::uint64_t> m_counts;
+		std::uint64_t m_total = 0;
+		std::uint64_t m_sum = 0;
+		std::uint64_t m_min = std::numeric_limits<std::uint64_t>::max();
+		std::uint64_t m_max = 0;
+	};
+
+	// Fixed-size latency histogram with O(1), allocation-free recording. Counters are
+	// relaxed atomics, so one thread may snapshot while others record; give each thread
+	// its own instance and merge the snapshots to keep the counters uncontended.
+	class time_histogram
+	{
+	public:
+		time_histogram() noexcept = default;
+		time_histogram(const time_histogram&) = delete;
+		time_histogram& operator=(const time_histogram&) = delete;
+
+		template<typename Rep, typename Period>
+		void record(std::chrono::duration<Rep, Period> delta) noexcept
+		{
+			const auto ns = std::chrono::round<std::chrono::nanoseconds>(delta).count();
+			record_ns(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+		}
+
+		void record_ns(std::uint64_t ns) noexcept
+		{
+			m_counts[histogram_buckets::index(ns)].fetch_add(1, std::memory_order_relaxed);
+			m_sum.fetch_add(ns, std::memory_order_relaxed);
+			std::uint64_t low = m_min.load(std::memory_order_relaxed);
+			while (ns < low && !m_min.compare_exchange_weak(low, ns, std::memory_order_relaxed))
+			{
+			}
+			std::uint64_t high = m_max.load(std::memory_order_relaxed);
+			while (ns > high && !m_max.compare_exchange_weak(high, ns, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		// With reset, the counts are taken and zeroed bucket by bucket, so a sample
+		// recorded meanwhile lands in exactly one snapshot.
+		histogram_snapshot snapshot(bool reset = false)
+		{
+			histogram_snapshot out{};
+			for (size_t i = 0; i < m_counts.size(); i++)
+			{
+				out.m_counts[i] = reset ? m_counts[i].exchange(0, std::memory_order_relaxed) : m_counts[i].load(std::memory_order_relaxed);
+				out.m_total += out.m_counts[i];
+			}
+			if (reset)
+			{
+				out.m_sum = m_sum.exchange(0, std::memory_order_relaxed);
+				out.m_min = m_min.exchange(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+				out.m_max = m_max.exchange(0, std::memory_order_relaxed);
+			}
+			else
+			{
+				out.m_sum = m_sum.load(std::memory_order_relaxed);
+				out.m_min = m_min.load(std::memory_order_relaxed);
+				out.m_max = m_max.load(std::memory_order_relaxed);
+			}
+			return out;
+		}
+
+		void reset() noexcept
+		{
+			for (auto& c : m_counts)
+			{
+				c.store(0, std::memory_order_relaxed);
+			}
+			m_sum.store(0, std::memory_order_relaxed);
+			m_min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+			m_max.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		std::array<std::atomic<std::uint64_t>, histogram_buckets::count> m_counts{};
+		std::atomic<std::uint64_t> m_sum{0};
+		std::atomic<std::uint64_t> m_min{std::numeric_limits<std::uint64_t>::max()};
+		std::atomic<std::uint64_t> m_max{0};
+	};
+}
+
+#endif
\ No newline at end of file
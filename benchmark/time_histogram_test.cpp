@@ -0,0 +1,74 @@
+// Snapshots a time_histogram while another thread records into it, as the class comment
+// allows, and checks every snapshot stays self-consistent. Exits non-zero on a failure.
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <iostream>
+
+#include "time_histogram.h"
+
+namespace {
+	int failures = 0;
+
+	void check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::cerr << "failed: " << what << '\n';
+			failures++;
+		}
+	}
+
+	void check_snapshot(const clm::bench::histogram_snapshot& s)
+	{
+		if (s.count() == 0)
+		{
+			return;
+		}
+		const auto p50 = s.percentile(0.5);
+		check(s.min() <= s.max(), "min <= max");
+		check(s.min() <= p50 && p50 <= s.max(), "median within [min, max]");
+		check(s.max().count() < 1.0, "max below the largest recorded value");
+	}
+}
+
+int main()
+{
+	clm::bench::time_histogram histogram{};
+	histogram.record_ns(1000);
+	histogram.record_ns(3000);
+	const auto fixed = histogram.snapshot(true);
+	check(fixed.count() == 2, "count of two samples");
+	check(std::abs(fixed.min().count() - 1e-6) < 1e-12 && std::abs(fixed.max().count() - 3e-6) < 1e-12, "exact min and max");
+	check_snapshot(fixed);
+
+	constexpr std::uint64_t samples = 2'000'000;
+	std::atomic<bool> done{false};
+	std::thread writer{[&]() {
+		for (std::uint64_t i = 0; i < samples; i++)
+		{
+			histogram.record_ns(100 + i % 50'000);
+		}
+		done.store(true, std::memory_order_release);
+	}};
+
+	std::uint64_t seen = 0;
+	while (!done.load(std::memory_order_acquire))
+	{
+		const auto s = histogram.snapshot(true);
+		check_snapshot(s);
+		seen += s.count();
+	}
+	writer.join();
+	const auto last = histogram.snapshot(true);
+	check_snapshot(last);
+	seen += last.count();
+	check(seen == samples, "every sample lands in exactly one snapshot");
+
+	if (failures == 0)
+	{
+		std::cout << "time_histogram: ok\n";
+	}
+	return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -1,39 +1,286 @@
 #ifndef TIME_LOG_H
 #define TIME_LOG_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <iostream>
 #include <format>
 #include <vector>
+#include <string>
+
+#include "time_histogram.h"
+#include "perf_counters.h"
+#include "alloc_tracker.h"
 
 namespace clm::bench {
 	using timestamp_t = std::chrono::time_point<std::chrono::high_resolution_clock>;
 
+	// samples keeps every delta. histogram records into a fixed-size time_histogram
+	// instead, which never allocates after construction and is safe to share between
+	// threads, for scopes left on in long-running code.
+	enum class log_mode
+	{
+		samples,
+		histogram
+	};
+
 	class time_log {
 		using time_delta_t = std::chrono::duration<double>;
 	public:
 		time_log() noexcept = default;
+		explicit time_log(log_mode mode)
+			:
+			m_histogram(mode == log_mode::histogram ? std::make_unique<time_histogram>() : nullptr)
+		{}
 		~time_log() noexcept = default;
 
 		void insert_delta(time_delta_t delta)
 		{
+			if (m_histogram)
+			{
+				m_histogram->record(delta);
+				return;
+			}
 			deltas.push_back(delta);
+			if (!counters.empty())
+			{
+				counters.emplace_back();
+			}
+			if (!allocations.empty())
+			{
+				allocations.emplace_back();
+			}
+		}
+		// A delta with the hardware counts of the same scope. In samples mode counts are
+		// kept per delta, in histogram mode only their totals.
+		void insert_delta(time_delta_t delta, const counter_sample& sample)
+		{
+			if (sample.empty())
+			{
+				insert_delta(delta);
+				return;
+			}
+			if (m_histogram)
+			{
+				m_histogram->record(delta);
+			}
+			else
+			{
+				deltas.push_back(delta);
+				counters.resize(deltas.size() - 1);
+				counters.push_back(sample);
+				if (!allocations.empty())
+				{
+					allocations.emplace_back();
+				}
+			}
+			m_counterTotals.add(sample);
+		}
+		// Heap activity of the scope behind the delta inserted last; see alloc_tracker.h.
+		void insert_allocations(const alloc_stats& stats)
+		{
+			if (!m_histogram && !deltas.empty())
+			{
+				allocations.resize(deltas.size() - 1);
+				allocations.push_back(stats);
+			}
+			m_allocTotals.add(stats);
 		}
 
 		void print()
 		{
-			for (const auto& delta : deltas)
+			if (m_histogram)
+			{
+				const histogram_snapshot s = m_histogram->snapshot();
+				std::cout << std::format("Samples: {}\tmin {}\tmean {}\tp50 {}\tp90 {}\tp99 {}\tp99.9 {}\tmax {}\n",
+										 s.count(), s.min(), s.mean(), s.percentile(0.5), s.percentile(0.9),
+										 s.percentile(0.99), s.percentile(0.999), s.max());
+			}
+			else
+			{
+				for (size_t i = 0; i < deltas.size(); i++)
+				{
+					std::cout << std::format("Time delta:\t{}{}{}\n", deltas[i], i < counters.size() ? format_counters(counters[i], 1) : "",
+											 i < allocations.size() ? format_allocations(allocations[i]) : "");
+				}
+			}
+			if (const std::uint64_t scopes = allocation_samples(); scopes != 0)
 			{
-				std::cout << std::format("Time delta:\t{}\n", delta);
+				std::cout << std::format("Allocations ({} scopes):{}\n", scopes, format_allocations(allocation_totals()));
+			}
+			if (const std::uint64_t scopes = counted_samples(); scopes != 0)
+			{
+				std::cout << std::format("Counters per scope ({} scopes):{}\n", scopes, format_counters(counter_totals(), scopes));
 			}
 		}
 
 		void clear() noexcept
 		{
+			if (m_histogram)
+			{
+				m_histogram->reset();
+			}
 			deltas.clear();
+			counters.clear();
+			m_counterTotals.reset();
+			allocations.clear();
+			m_allocTotals.reset();
+		}
+
+		log_mode mode() const noexcept
+		{
+			return m_histogram ? log_mode::histogram : log_mode::samples;
+		}
+		// Null in samples mode.
+		time_histogram* histogram() noexcept
+		{
+			return m_histogram.get();
+		}
+		const time_histogram* histogram() const noexcept
+		{
+			return m_histogram.get();
+		}
+
+		const std::vector<time_delta_t>& get_deltas() const noexcept
+		{
+			return deltas;
+		}
+		// Empty unless scopes were counted; otherwise one entry per delta, empty where a
+		// scope had no counts.
+		const std::vector<counter_sample>& get_counters() const noexcept
+		{
+			return counters;
+		}
+		// Sum over every counted scope, in either mode.
+		counter_sample counter_totals() const noexcept
+		{
+			return m_counterTotals.snapshot();
+		}
+		std::uint64_t counted_samples() const noexcept
+		{
+			return m_counterTotals.scopes.load(std::memory_order_relaxed);
+		}
+		// As for the counters; peak is the largest of any one scope.
+		const std::vector<alloc_stats>& get_allocations() const noexcept
+		{
+			return allocations;
+		}
+		alloc_stats allocation_totals() const noexcept
+		{
+			return m_allocTotals.snapshot();
+		}
+		std::uint64_t allocation_samples() const noexcept
+		{
+			return m_allocTotals.scopes.load(std::memory_order_relaxed);
 		}
 	private:
+		// Atomic so histogram mode stays safe to share between threads. Fields are added
+		// one at a time, so a snapshot taken during an insert may hold part of that scope.
+		struct counter_totals_t
+		{
+			std::array<std::atomic<std::uint64_t>, perf_counter_count> values{};
+			// Counters every scope had, as counter_sample::operator+= keeps them.
+			std::atomic<std::uint32_t> available{~0u};
+			std::atomic<std::uint64_t> scopes{0};
+
+			void add(const counter_sample& sample) noexcept
+			{
+				for (size_t i = 0; i < perf_counter_count; i++)
+				{
+					values[i].fetch_add(sample.values[i], std::memory_order_relaxed);
+				}
+				available.fetch_and(sample.available, std::memory_order_relaxed);
+				scopes.fetch_add(1, std::memory_order_relaxed);
+			}
+			counter_sample snapshot() const noexcept
+			{
+				counter_sample sample{};
+				if (scopes.load(std::memory_order_relaxed) == 0)
+				{
+					return sample;
+				}
+				for (size_t i = 0; i < perf_counter_count; i++)
+				{
+					sample.values[i] = values[i].load(std::memory_order_relaxed);
+				}
+				sample.available = available.load(std::memory_order_relaxed);
+				return sample;
+			}
+			void reset() noexcept
+			{
+				for (auto& value : values)
+				{
+					value.store(0, std::memory_order_relaxed);
+				}
+				available.store(~0u, std::memory_order_relaxed);
+				scopes.store(0, std::memory_order_relaxed);
+			}
+		};
+
+		// The same for alloc_stats; peak is a running maximum.
+		struct alloc_totals_t
+		{
+			std::atomic<std::uint64_t> allocations{0};
+			std::atomic<std::uint64_t> deallocations{0};
+			std::atomic<std::uint64_t> bytes{0};
+			std::atomic<std::uint64_t> peak{0};
+			std::atomic<std::uint64_t> scopes{0};
+
+			void add(const alloc_stats& stats) noexcept
+			{
+				allocations.fetch_add(stats.allocations, std::memory_order_relaxed);
+				deallocations.fetch_add(stats.deallocations, std::memory_order_relaxed);
+				bytes.fetch_add(stats.bytes, std::memory_order_relaxed);
+				std::uint64_t highest = peak.load(std::memory_order_relaxed);
+				while (highest < stats.peak && !peak.compare_exchange_weak(highest, stats.peak, std::memory_order_relaxed))
+				{
+				}
+				scopes.fetch_add(1, std::memory_order_relaxed);
+			}
+			alloc_stats snapshot() const noexcept
+			{
+				return alloc_stats{allocations.load(std::memory_order_relaxed), deallocations.load(std::memory_order_relaxed),
+								   bytes.load(std::memory_order_relaxed), peak.load(std::memory_order_relaxed)};
+			}
+			void reset() noexcept
+			{
+				allocations.store(0, std::memory_order_relaxed);
+				deallocations.store(0, std::memory_order_relaxed);
+				bytes.store(0, std::memory_order_relaxed);
+				peak.store(0, std::memory_order_relaxed);
+				scopes.store(0, std::memory_order_relaxed);
+			}
+		};
+
+		static std::string format_counters(const counter_sample& sample, std::uint64_t scopes)
+		{
+			std::string out;
+			for (perf_counter counter : all_perf_counters)
+			{
+				if (sample.has(counter))
+				{
+					out += std::format("\t{} {}", sample[counter] / scopes, perf_counter_name(counter));
+				}
+			}
+			if (sample.has(perf_counter::cycles) && sample.has(perf_counter::instructions))
+			{
+				out += std::format("\tIPC {:.2f}", sample.ipc());
+			}
+			return out;
+		}
+		static std::string format_allocations(const alloc_stats& stats)
+		{
+			return std::format("\t{} allocs\t{} frees\t{} bytes\tpeak {} bytes", stats.allocations, stats.deallocations, stats.bytes, stats.peak);
+		}
+
 		std::vector<time_delta_t> deltas;
+		std::vector<counter_sample> counters;
+		counter_totals_t m_counterTotals{};
+		std::vector<alloc_stats> allocations;
+		alloc_totals_t m_allocTotals{};
+		std::unique_ptr<time_histogram> m_histogram;
 	};
 }
 
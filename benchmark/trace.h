@@ -0,0 +1,394 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+
+#include "json_string.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define CLM_TRACE_TSC
+#endif
+
+// Timeline tracing of named zones. Each thread writes into its own fixed-size ring buffer
+// with no locks or allocation; a flush drains every buffer and the collected events export
+// as Chrome trace JSON (chrome://tracing, ui.perfetto.dev). Zones are timestamped with the
+// TSC where there is one, converted to steady_clock time at export.
+//
+//	clm::bench::trace_enable(true);
+//	{
+//		CLM_TRACE_ZONE("solve");
+//		...
+//	}
+//	clm::bench::trace_collector collector{};
+//	collector.flush();
+//	collector.write_chrome_trace(file);
+namespace clm::bench {
+	// Raw timestamps, mapped to nanoseconds by a calibration against steady_clock taken on
+	// first use. Assumes an invariant TSC, as on every x86-64 CPU of the last decade.
+	class trace_clock
+	{
+	public:
+		static std::uint64_t now() noexcept
+		{
+#ifdef CLM_TRACE_TSC
+			return __rdtsc();
+#else
+			return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		// Nanoseconds on the steady_clock epoch.
+		static double to_ns(std::uint64_t ticks) noexcept
+		{
+			const calibration& c = get();
+			return c.steadyNs + (static_cast<double>(ticks) - static_cast<double>(c.ticks)) * c.nsPerTick;
+		}
+
+	private:
+		struct calibration
+		{
+			std::uint64_t ticks;
+			double steadyNs;
+			double nsPerTick;
+		};
+
+		static double steady_ns() noexcept
+		{
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Counts ticks over 20 ms of steady_clock.
+		static calibration calibrate() noexcept
+		{
+#ifdef CLM_TRACE_TSC
+			const double startNs = steady_ns();
+			const std::uint64_t startTicks = now();
+			double endNs = startNs;
+			while (endNs - startNs < 2e7)
+			{
+				endNs = steady_ns();
+			}
+			const std::uint64_t endTicks = now();
+			return calibration{startTicks, startNs, (endNs - startNs) / static_cast<double>(endTicks - startTicks)};
+#else
+			using period = std::chrono::steady_clock::period;
+			return calibration{0, 0.0, 1e9 * period::num / period::den};
+#endif
+		}
+
+		static const calibration& get() noexcept
+		{
+			static const calibration c = calibrate();
+			return c;
+		}
+	};
+
+	// name must outlive the trace, which in practice means a string literal.
+	struct trace_event
+	{
+		const char* name;
+		std::uint64_t begin;
+		std::uint64_t end;
+	};
+
+	// Single-producer, single-consumer ring: the owning thread pushes, the flush pops.
+	// When full, new events are dropped and counted rather than blocking the thread.
+	class trace_buffer
+	{
+	public:
+		static constexpr size_t capacity = 1 << 16;
+
+		trace_buffer(std::uint32_t threadId, std::string threadName)
+			:
+			m_events(std::make_unique<trace_event[]>(capacity)), m_threadId(threadId), m_threadName(std::move(threadName))
+		{}
+
+		void push(const trace_event& event) noexcept
+		{
+			const size_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) == capacity)
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			m_events[head & (capacity - 1)] = event;
+			m_head.store(head + 1, std::memory_order_release);
+		}
+
+		template<typename Fn>
+		void drain(Fn&& fn)
+		{
+			const size_t head = m_head.load(std::memory_order_acquire);
+			size_t tail = m_tail.load(std::memory_order_relaxed);
+			for (; tail != head; tail++)
+			{
+				fn(m_events[tail & (capacity - 1)]);
+			}
+			m_tail.store(tail, std::memory_order_release);
+		}
+
+		std::uint32_t thread_id() const noexcept { return m_threadId; }
+		const std::string& thread_name() const noexcept { return m_threadName; }
+		std::uint64_t dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+		// Set when the owning thread exits; nothing is pushed after that, so a buffer seen
+		// retired before a drain is empty after it.
+		void retire() noexcept { m_retired.store(true, std::memory_order_release); }
+		bool retired() const noexcept { return m_retired.load(std::memory_order_acquire); }
+
+	private:
+		std::unique_ptr<trace_event[]> m_events;
+		alignas(64) std::atomic<size_t> m_head{0};
+		alignas(64) std::atomic<size_t> m_tail{0};
+		std::atomic<std::uint64_t> m_dropped{0};
+		std::atomic<bool> m_retired{false};
+		std::uint32_t m_threadId;
+		std::string m_threadName;
+	};
+
+	namespace detail {
+		// The buffers of live threads, and of exited ones until a flush has drained them.
+		struct trace_registry
+		{
+			std::mutex mutex;
+			std::vector<std::shared_ptr<trace_buffer>> buffers;
+			std::uint32_t nextThreadId = 1;
+			std::atomic<bool> enabled{false};
+
+			static trace_registry& get()
+			{
+				static trace_registry registry{};
+				return registry;
+			}
+
+			std::shared_ptr<trace_buffer> add(std::string threadName)
+			{
+				std::lock_guard lock{mutex};
+				buffers.push_back(std::make_shared<trace_buffer>(nextThreadId++, std::move(threadName)));
+				return buffers.back();
+			}
+		};
+
+		inline thread_local std::string traceThreadName{};
+
+		// Retires the thread's buffer when the thread exits, so pool and parallel_for
+		// threads don't each leave a ring behind.
+		struct trace_buffer_owner
+		{
+			std::shared_ptr<trace_buffer> buffer;
+
+			~trace_buffer_owner()
+			{
+				buffer->retire();
+			}
+		};
+
+		inline trace_buffer& thread_buffer()
+		{
+			thread_local const trace_buffer_owner owner{trace_registry::get().add(traceThreadName)};
+			return *owner.buffer;
+		}
+	}
+
+	// Zones record nothing, and skip the clock reads, while tracing is off.
+	inline void trace_enable(bool enabled) noexcept
+	{
+		detail::trace_registry::get().enabled.store(enabled, std::memory_order_relaxed);
+	}
+	inline bool trace_enabled() noexcept
+	{
+		return detail::trace_registry::get().enabled.load(std::memory_order_relaxed);
+	}
+
+	// Shown as the thread's name in the trace; takes effect if called before the thread's
+	// first zone.
+	inline void trace_thread_name(std::string_view name)
+	{
+		detail::traceThreadName = name;
+	}
+
+	// Records [construction, destruction) as one event on the calling thread's buffer.
+	class trace_zone
+	{
+	public:
+		explicit trace_zone(const char* name) noexcept
+			:
+			m_name(trace_enabled() ? name : nullptr), m_begin(m_name ? trace_clock::now() : 0)
+		{}
+		~trace_zone()
+		{
+			if (m_name)
+			{
+				detail::thread_buffer().push(trace_event{m_name, m_begin, trace_clock::now()});
+			}
+		}
+		trace_zone(const trace_zone&) = delete;
+		trace_zone& operator=(const trace_zone&) = delete;
+
+	private:
+		const char* m_name;
+		std::uint64_t m_begin;
+	};
+
+#define CLM_TRACE_CONCAT_IMPL(a, b) a##b
+#define CLM_TRACE_CONCAT(a, b) CLM_TRACE_CONCAT_IMPL(a, b)
+#define CLM_TRACE_ZONE(name) ::clm::bench::trace_zone CLM_TRACE_CONCAT(clmTraceZone, __LINE__){name}
+
+	// Drains the thread buffers into one list of events, on demand or from a background
+	// thread every interval so long runs never overflow the rings.
+	class trace_collector
+	{
+	public:
+		struct event
+		{
+			trace_event zone;
+			std::uint32_t threadId;
+		};
+
+		trace_collector() = default;
+		~trace_collector()
+		{
+			stop();
+		}
+		trace_collector(const trace_collector&) = delete;
+		trace_collector& operator=(const trace_collector&) = delete;
+
+		// The registry lock is held throughout, so two collectors never drain a ring at
+		// once. Buffers of exited threads are released once drained; the thread's name and
+		// drop count stay with the collector for the export.
+		void flush()
+		{
+			auto& registry = detail::trace_registry::get();
+			std::lock_guard registryLock{registry.mutex};
+			std::lock_guard lock{m_mutex};
+			std::erase_if(registry.buffers, [&](const std::shared_ptr<trace_buffer>& buffer) {
+				const bool retired = buffer->retired();
+				const std::uint32_t id = buffer->thread_id();
+				buffer->drain([&](const trace_event& e) { m_events.push_back(event{e, id}); });
+				note_thread(*buffer);
+				return retired;
+			});
+		}
+
+		void start(std::chrono::milliseconds interval = std::chrono::milliseconds{50})
+		{
+			stop();
+			m_flusher = std::jthread{[this, interval](std::stop_token stop) {
+				while (!stop.stop_requested())
+				{
+					std::this_thread::sleep_for(interval);
+					flush();
+				}
+			}};
+		}
+		// Stops the background thread, then flushes once more.
+		void stop()
+		{
+			if (m_flusher.joinable())
+			{
+				m_flusher.request_stop();
+				m_flusher.join();
+				flush();
+			}
+		}
+
+		std::vector<event> events() const
+		{
+			std::lock_guard lock{m_mutex};
+			return m_events;
+		}
+		void clear()
+		{
+			std::lock_guard lock{m_mutex};
+			m_events.clear();
+			m_threads.clear();
+		}
+
+		// Complete ("X") events in microseconds, plus thread name metadata and a count of
+		// the events each thread dropped.
+		void write_chrome_trace(std::ostream& out) const
+		{
+			std::vector<thread_info> threads;
+			std::vector<event> events;
+			{
+				std::lock_guard lock{m_mutex};
+				threads = m_threads;
+				events = m_events;
+			}
+			std::ranges::sort(events, [](const event& a, const event& b) { return a.zone.begin < b.zone.begin; });
+
+			const auto flags = out.flags();
+			const auto precision = out.precision();
+			out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+			bool first = true;
+			const auto separator = [&]() {
+				out << (first ? "\n" : ",\n");
+				first = false;
+			};
+			for (const thread_info& thread : threads)
+			{
+				separator();
+				out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread.id << ", \"args\": {\"name\": ";
+				write_json_string(out, thread.name.empty() ? "thread " + std::to_string(thread.id) : thread.name);
+				out << ", \"dropped\": " << thread.dropped << "}}";
+			}
+			for (const event& e : events)
+			{
+				const double begin = trace_clock::to_ns(e.zone.begin) * 1e-3;
+				const double end = trace_clock::to_ns(e.zone.end) * 1e-3;
+				separator();
+				out << "{\"name\": ";
+				write_json_string(out, e.zone.name);
+				out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.threadId << ", \"ts\": " << begin << ", \"dur\": " << std::max(0.0, end - begin) << "}";
+			}
+			out << "\n]}\n";
+			out.flags(flags);
+			out.precision(precision);
+		}
+
+	private:
+		struct thread_info
+		{
+			std::uint32_t id;
+			std::string name;
+			std::uint64_t dropped;
+		};
+
+		// Called with m_mutex held.
+		void note_thread(const trace_buffer& buffer)
+		{
+			const auto known = std::ranges::find(m_threads, buffer.thread_id(), &thread_info::id);
+			if (known != m_threads.end())
+			{
+				known->dropped = buffer.dropped();
+			}
+			else
+			{
+				m_threads.push_back(thread_info{buffer.thread_id(), buffer.thread_name(), buffer.dropped()});
+			}
+		}
+
+		mutable std::mutex m_mutex;
+		std::vector<event> m_events;
+		std::vector<thread_info> m_threads;
+		std::jthread m_flusher;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#ifndef VECTOR_BENCH_H
+#define VECTOR_BENCH_H
+
+#include <array>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <format>
+
+#include <clmMath/clm_vector.h>
+
+#include "time_bench.h"
+#include "time_log.h"
+
+namespace clm::bench {
+	// Plain std::array loops with the same arithmetic as the generic Vector template,
+	// used as the baseline for the SIMD specializations.
+	namespace scalar_ref {
+		template<typename T, size_t dim>
+		using vec_t = std::array<T, dim>;
+
+		template<typename T, size_t dim>
+		inline vec_t<T, dim> fused(const vec_t<T, dim>& a, const vec_t<T, dim>& b, const vec_t<T, dim>& c, T s) noexcept
+		{
+			vec_t<T, dim> out{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				out[i] = a[i] + b[i] * s - c[i];
+			}
+			return out;
+		}
+
+		template<typename T, size_t dim>
+		inline T dot(const vec_t<T, dim>& a, const vec_t<T, dim>& b) noexcept
+		{
+			T sum{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				sum += a[i] * b[i];
+			}
+			return sum;
+		}
+
+		template<typename T>
+		inline vec_t<T, 3> cross(const vec_t<T, 3>& a, const vec_t<T, 3>& b) noexcept
+		{
+			return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+		}
+
+		template<typename T, size_t dim>
+		inline vec_t<T, dim> unit_vector(const vec_t<T, dim>& a) noexcept
+		{
+			T len = std::sqrt(dot(a, a));
+			vec_t<T, dim> out{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				out[i] = a[i] / len;
+			}
+			return out;
+		}
+	}
+
+	// Times the same operation mix (fused add/scale/sub, dot, cross for dim 3, unit_vector)
+	// over count vectors, once with clm::math::Vector and once with the scalar reference.
+	template<typename T, size_t dim>
+	void bench_vector_ops(size_t count, size_t repetitions, time_log& simdLog, time_log& scalarLog)
+	{
+		std::mt19937 rng{1234u};
+		std::uniform_real_distribution<T> dist{static_cast<T>(0.5), static_cast<T>(2)};
+
+		std::vector<math::Vector<T, dim>> vecs(count);
+		std::vector<scalar_ref::vec_t<T, dim>> arrs(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t j = 0; j < dim; j++)
+			{
+				T val = dist(rng);
+				vecs[i][j] = val;
+				arrs[i][j] = val;
+			}
+		}
+
+		volatile T sink{};
+		const T scale = static_cast<T>(0.75);
+		for (size_t rep = 0; rep < repetitions; rep++)
+		{
+			{
+				time_bench timer{simdLog};
+				T acc{};
+				for (size_t i = 2; i < count; i++)
+				{
+					math::Vector<T, dim> v = vecs[i - 2] + vecs[i - 1] * scale - vecs[i];
+					acc += math::dot(v, vecs[i]);
+					if constexpr (dim == 3)
+					{
+						acc += math::cross(vecs[i - 1], vecs[i])[0];
+					}
+					acc += math::unit_vector(vecs[i])[0];
+				}
+				sink = acc;
+			}
+			{
+				time_bench timer{scalarLog};
+				T acc{};
+				for (size_t i = 2; i < count; i++)
+				{
+					auto v = scalar_ref::fused(arrs[i - 2], arrs[i - 1], arrs[i], scale);
+					acc += scalar_ref::dot(v, arrs[i]);
+					if constexpr (dim == 3)
+					{
+						acc += scalar_ref::cross(arrs[i - 1], arrs[i])[0];
+					}
+					acc += scalar_ref::unit_vector(arrs[i])[0];
+				}
+				sink = acc;
+			}
+		}
+		(void)sink;
+	}
+
+	inline void run_vector_bench(size_t count = 1'000'000, size_t repetitions = 10)
+	{
+		time_log simdLog{};
+		time_log scalarLog{};
+
+		std::cout << "Vec3f (Vector / scalar)\n";
+		bench_vector_ops<float, 3>(count, repetitions, simdLog, scalarLog);
+		simdLog.print();
+		scalarLog.print();
+		simdLog.clear();
+		scalarLog.clear();
+
+		std::cout << "Vec4f (Vector / scalar)\n";
+		bench_vector_ops<float, 4>(count, repetitions, simdLog, scalarLog);
+		simdLog.print();
+		scalarLog.print();
+		simdLog.clear();
+		scalarLog.clear();
+
+		std::cout << "Vec4d (Vector / scalar)\n";
+		bench_vector_ops<double, 4>(count, repetitions, simdLog, scalarLog);
+		simdLog.print();
+		scalarLog.print();
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef CLM_BATCH_MATH_H
+#define CLM_BATCH_MATH_H
+
+#include <span>
+#include <cassert>
+
+#include "clm_dispatch.h"
+
+// Elementwise math over whole arrays through the runtime dispatched kernels. out must be
+// at least as long as in and may be the same array. Error bounds are in ULP of the
+// correctly rounded result, measured over a dense sample of the documented domain on the
+// SSE2, AVX, AVX2 and AVX-512 paths; the scalar level calls the C library instead.
+namespace clm::math {
+	// Exact: correctly rounded, same as std::sqrt.
+	inline void sqrt(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::batch_kernels<float>().sqrt(in.data(), out.data(), in.size());
+	}
+	inline void sqrt(std::span<const double> in, std::span<double> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::batch_kernels<double>().sqrt(in.data(), out.data(), in.size());
+	}
+
+	// Hardware estimate plus one Newton step: at most 4 ULP (SSE/AVX) or 3 ULP (AVX-512)
+	// for normal positive inputs. 0 gives inf and inf gives 0. On SSE/AVX, denormal
+	// inputs are treated as 0.
+	inline void rsqrt(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::approx_kernels().rsqrt(in.data(), out.data(), in.size());
+	}
+
+	// At most 3 ULP for |x| < 8192. A pack with any element outside that range, or inf
+	// or NaN, takes the C library path as a whole, so the result is always defined.
+	inline void sin(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::approx_kernels().sin(in.data(), out.data(), in.size());
+	}
+	inline void cos(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::approx_kernels().cos(in.data(), out.data(), in.size());
+	}
+	// sin and cos with one shared range reduction; same bounds as above.
+	inline void sincos(std::span<const float> in, std::span<float> sinOut, std::span<float> cosOut) noexcept
+	{
+		assert(sinOut.size() >= in.size() && cosOut.size() >= in.size());
+		dispatch::approx_kernels().sincos(in.data(), sinOut.data(), cosOut.data(), in.size());
+	}
+
+	// At most 2 ULP where the result is normal. Results in the denormal range are
+	// within 1 ULP of the smallest denormal; overflow gives inf and NaN stays NaN.
+	inline void exp(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::approx_kernels().exp(in.data(), out.data(), in.size());
+	}
+
+	// At most 1 ULP for every positive input, denormals included. 0 gives -inf,
+	// inf gives inf, and negatives or NaN give NaN.
+	inline void log(std::span<const float> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		dispatch::approx_kernels().log(in.data(), out.data(), in.size());
+	}
+}
+
+#endif
\ No newline at end of file
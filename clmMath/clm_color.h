@@ -1,12 +1,23 @@
 #ifndef CLM_COLOR_H
 #define CLM_COLOR_H
 
-#include <math/clm_vector.h>
+#include <span>
+#include <array>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "clm_vector.h"
+#include "clm_gen_math.h"
+#include "clm_dispatch.h"
 
 namespace clm::color {
 	template<typename T, size_t dim>
 	concept valid_color_type = valid_vec_type<T> && (dim == 3 || dim == 4);
 
+	// Vector with r, g, b members bound to its elements. The members are references, so
+	// a Color3 is much larger than its three values; arrays of colors should use ColorRGB.
 	template<valid_vec_type T>
 	struct Color3 : public math::Vector<T, 3>
 	{
@@ -22,6 +33,16 @@ namespace clm::color {
 			:
 			math::Vector<T, 3>(vec), r(this->elems[0]), g(this->elems[1]), b(this->elems[2])
 		{}
+		// Copies rebind the references to their own elements.
+		Color3(const Color3& rhs)
+			:
+			math::Vector<T, 3>(rhs), r(this->elems[0]), g(this->elems[1]), b(this->elems[2])
+		{}
+		Color3& operator=(const Color3& rhs)
+		{
+			math::Vector<T, 3>::operator=(rhs);
+			return *this;
+		}
 
 		T& r;
 		T& g;
@@ -45,6 +66,15 @@ namespace clm::color {
 			:
 			math::Vector<T, 4>(vec), r(this->elems[0]), g(this->elems[1]), b(this->elems[2]), a(this->elems[3])
 		{}
+		Color4(const Color4& rhs)
+			:
+			math::Vector<T, 4>(rhs), r(this->elems[0]), g(this->elems[1]), b(this->elems[2]), a(this->elems[3])
+		{}
+		Color4& operator=(const Color4& rhs)
+		{
+			math::Vector<T, 4>::operator=(rhs);
+			return *this;
+		}
 
 		T& r;
 		T& g;
@@ -53,6 +83,148 @@ namespace clm::color {
 	};
 	using Color4f = Color4<float>;
 	using Color4d = Color4<double>;
+
+	// Plain colors for storage: trivially copyable, no padding, and laid out as
+	// interleaved channels, so spans of them go straight to the batch functions below.
+	template<valid_vec_type T>
+	struct ColorRGB
+	{
+		T r;
+		T g;
+		T b;
+
+		constexpr bool operator==(const ColorRGB&) const noexcept = default;
+
+		Color3<T> to_color() const
+		{
+			return Color3<T>(r, g, b);
+		}
+		static ColorRGB from_color(const math::Vector<T, 3>& color) noexcept
+		{
+			return ColorRGB{color[0], color[1], color[2]};
+		}
+	};
+
+	template<valid_vec_type T>
+	struct ColorRGBA
+	{
+		T r;
+		T g;
+		T b;
+		T a;
+
+		constexpr bool operator==(const ColorRGBA&) const noexcept = default;
+
+		Color4<T> to_color() const
+		{
+			return Color4<T>(r, g, b, a);
+		}
+		static ColorRGBA from_color(const math::Vector<T, 4>& color) noexcept
+		{
+			return ColorRGBA{color[0], color[1], color[2], color[3]};
+		}
+	};
+
+	using ColorRGBf = ColorRGB<float>;
+	using ColorRGBAf = ColorRGBA<float>;
+	using ColorRGBA8 = ColorRGBA<std::uint8_t>;
+
+	static_assert(sizeof(ColorRGBf) == 3 * sizeof(float) && std::is_trivially_copyable_v<ColorRGBf>);
+	static_assert(sizeof(ColorRGBAf) == 4 * sizeof(float) && std::is_trivially_copyable_v<ColorRGBAf>);
+	static_assert(sizeof(ColorRGBA8) == 4 && std::is_trivially_copyable_v<ColorRGBA8>);
+
+	namespace detail {
+		inline const float* channels(const ColorRGBf* colors) noexcept { return reinterpret_cast<const float*>(colors); }
+		inline float* channels(ColorRGBf* colors) noexcept { return reinterpret_cast<float*>(colors); }
+		inline const float* channels(const ColorRGBAf* colors) noexcept { return reinterpret_cast<const float*>(colors); }
+		inline float* channels(ColorRGBAf* colors) noexcept { return reinterpret_cast<float*>(colors); }
+		inline const std::uint8_t* channels(const ColorRGBA8* colors) noexcept { return reinterpret_cast<const std::uint8_t*>(colors); }
+		inline std::uint8_t* channels(ColorRGBA8* colors) noexcept { return reinterpret_cast<std::uint8_t*>(colors); }
+
+		constexpr double srgb_to_linear(double c) noexcept
+		{
+			return c <= 0.04045 ? c / 12.92 : math::pow_ce((c + 0.055) / 1.055, 2.4);
+		}
+	}
+
+	// The sRGB transfer functions (IEC 61966-2-1) for one channel.
+	inline float srgb_to_linear(float c) noexcept
+	{
+		return c > 0.04045f ? std::pow((c + 0.055f) / 1.055f, 2.4f) : c / 12.92f;
+	}
+	inline float linear_to_srgb(float c) noexcept
+	{
+		return c > 0.0031308f ? std::pow(c, 1.0f / 2.4f) * 1.055f - 0.055f : c * 12.92f;
+	}
+
+	// Linear value of every 8-bit sRGB code, exact to float precision.
+	inline constexpr std::array<float, 256> srgb8ToLinear = math::make_lut<float, 256>([](size_t i) {
+		return detail::srgb_to_linear(i / 255.0);
+	});
+
+	// The batch functions below run through the dispatched kernels, a whole array per call.
+	// out must be at least as long as in and may be the same array. Alpha is always linear
+	// and passes through the transfer functions unchanged. The SIMD levels evaluate the
+	// power segment with the exp/log approximations from clm_batch_math.h, within 4e-7 of
+	// the exact curve over [0, 1].
+	inline void srgb_to_linear(std::span<const ColorRGBf> in, std::span<ColorRGBf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().srgb_to_linear(detail::channels(in.data()), detail::channels(out.data()), in.size(), 3);
+	}
+	inline void srgb_to_linear(std::span<const ColorRGBAf> in, std::span<ColorRGBAf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().srgb_to_linear(detail::channels(in.data()), detail::channels(out.data()), in.size(), 4);
+	}
+	inline void linear_to_srgb(std::span<const ColorRGBf> in, std::span<ColorRGBf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().linear_to_srgb(detail::channels(in.data()), detail::channels(out.data()), in.size(), 3);
+	}
+	inline void linear_to_srgb(std::span<const ColorRGBAf> in, std::span<ColorRGBAf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().linear_to_srgb(detail::channels(in.data()), detail::channels(out.data()), in.size(), 4);
+	}
+
+	// 8-bit channels to and from [0, 1], keeping the encoding. pack clamps, rounds to
+	// nearest and writes 0 for NaN.
+	inline void unpack(std::span<const ColorRGBA8> in, std::span<ColorRGBAf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().unpack_unorm8(detail::channels(in.data()), detail::channels(out.data()), in.size() * 4);
+	}
+	inline void pack(std::span<const ColorRGBAf> in, std::span<ColorRGBA8> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().pack_unorm8(detail::channels(in.data()), detail::channels(out.data()), in.size() * 4);
+	}
+
+	// 8-bit sRGB straight to linear float through srgb8ToLinear, skipping the curve.
+	inline void srgb8_to_linear(std::span<const ColorRGBA8> in, std::span<ColorRGBAf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			const ColorRGBA8 c = in[i];
+			out[i] = ColorRGBAf{srgb8ToLinear[c.r], srgb8ToLinear[c.g], srgb8ToLinear[c.b], c.a / 255.0f};
+		}
+	}
+
+	// rgb *= a.
+	inline void premultiply(std::span<const ColorRGBAf> in, std::span<ColorRGBAf> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().premultiply(detail::channels(in.data()), detail::channels(out.data()), in.size());
+	}
+
+	// Rec. 709 relative luminance of linear colors, one float per color.
+	inline void luminance(std::span<const ColorRGBAf> in, std::span<float> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		math::dispatch::color_kernels().luminance(detail::channels(in.data()), out.data(), in.size());
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "clm_dispatch.h"
+#include "clm_dispatch_kernels.h"
+
+#include <array>
+#include <algorithm>
+
+namespace clm::math::dispatch {
+	namespace {
+		template<typename Table>
+		const Table* pick(const detail::kernel_tables& tables) noexcept
+		{
+			if constexpr (std::same_as<Table, batch_kernel_table<float>>)
+			{
+				return tables.f32;
+			}
+			else if constexpr (std::same_as<Table, batch_kernel_table<double>>)
+			{
+				return tables.f64;
+			}
+			else if constexpr (std::same_as<Table, approx_kernel_table>)
+			{
+				return tables.approx;
+			}
+			else if constexpr (std::same_as<Table, geometry_kernel_table>)
+			{
+				return tables.geometry;
+			}
+			else if constexpr (std::same_as<Table, rect_kernel_table>)
+			{
+				return tables.rect;
+			}
+			else
+			{
+				return tables.color;
+			}
+		}
+
+		// Entry i is the best table compiled in at or below simd_level i. SSE4.1 has no
+		// kernels of its own and shares the SSE2 ones.
+		template<typename Table>
+		std::array<const Table*, util::simd_level_count> build_level_map() noexcept
+		{
+			const std::array<const Table*, util::simd_level_count> compiled{
+				pick<Table>(detail::scalar_tables()),
+				pick<Table>(detail::sse2_tables()),
+				nullptr,
+				pick<Table>(detail::avx_tables()),
+				pick<Table>(detail::avx2_tables()),
+				pick<Table>(detail::avx512_tables())
+			};
+			std::array<const Table*, util::simd_level_count> levels{};
+			const Table* best = compiled[0];
+			for (size_t i = 0; i < util::simd_level_count; i++)
+			{
+				if (compiled[i] != nullptr)
+				{
+					best = compiled[i];
+				}
+				levels[i] = best;
+			}
+			return levels;
+		}
+
+		template<typename Table>
+		const Table& table_for(util::simd_level level) noexcept
+		{
+			static const auto levels = build_level_map<Table>();
+			return *levels[static_cast<size_t>(std::min(level, util::detected_simd_level()))];
+		}
+	}
+
+	template<dispatched_type T>
+	const batch_kernel_table<T>& batch_kernels() noexcept
+	{
+		return table_for<batch_kernel_table<T>>(util::active_simd_level());
+	}
+
+	template<dispatched_type T>
+	const batch_kernel_table<T>& batch_kernels(util::simd_level level) noexcept
+	{
+		return table_for<batch_kernel_table<T>>(level);
+	}
+
+	const approx_kernel_table& approx_kernels() noexcept
+	{
+		return table_for<approx_kernel_table>(util::active_simd_level());
+	}
+
+	const approx_kernel_table& approx_kernels(util::simd_level level) noexcept
+	{
+		return table_for<approx_kernel_table>(level);
+	}
+
+	const geometry_kernel_table& geometry_kernels() noexcept
+	{
+		return table_for<geometry_kernel_table>(util::active_simd_level());
+	}
+
+	const geometry_kernel_table& geometry_kernels(util::simd_level level) noexcept
+	{
+		return table_for<geometry_kernel_table>(level);
+	}
+
+	const rect_kernel_table& rect_kernels() noexcept
+	{
+		return table_for<rect_kernel_table>(util::active_simd_level());
+	}
+
+	const rect_kernel_table& rect_kernels(util::simd_level level) noexcept
+	{
+		return table_for<rect_kernel_table>(level);
+	}
+
+	const color_kernel_table& color_kernels() noexcept
+	{
+		return table_for<color_kernel_table>(util::active_simd_level());
+	}
+
+	const color_kernel_table& color_kernels(util::simd_level level) noexcept
+	{
+		return table_for<color_kernel_table>(level);
+	}
+
+	template const batch_kernel_table<float>& batch_kernels<float>() noexcept;
+	template const batch_kernel_table<double>& batch_kernels<double>() noexcept;
+	template const batch_kernel_table<float>& batch_kernels<float>(util::simd_level) noexcept;
+	template const batch_kernel_table<double>& batch_kernels<double>(util::simd_level) noexcept;
+}
\ No newline at end of file
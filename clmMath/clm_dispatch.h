@@ -0,0 +1,129 @@
+#ifndef CLM_DISPATCH_H
+#define CLM_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+
+#include <clmUtil/clm_cpu.h>
+
+namespace clm::math::dispatch {
+	// Element types with runtime dispatched batch kernels. Everything else stays on the
+	// header kernels built for the compile-time target.
+	template<typename T>
+	concept dispatched_type = std::same_as<T, float> || std::same_as<T, double>;
+
+	// Largest vector dimension the component-array kernels accept.
+	inline constexpr size_t max_kernel_dim = 4;
+
+	// Structure-of-arrays kernels over count elements. Component arrays are passed as
+	// arrays of dim pointers; out may alias an input. One table is compiled per
+	// instruction set in clm_dispatch_<isa>.cpp, each with its own compiler flags.
+	template<dispatched_type T>
+	struct batch_kernel_table
+	{
+		util::simd_level level;
+		void (*add)(const T* lhs, const T* rhs, T* out, size_t count) noexcept;
+		void (*sub)(const T* lhs, const T* rhs, T* out, size_t count) noexcept;
+		void (*scale)(const T* in, T factor, T* out, size_t count) noexcept;
+		void (*sqrt)(const T* in, T* out, size_t count) noexcept;
+		void (*dot)(const T* const* lhs, const T* const* rhs, size_t dim, T* out, size_t count) noexcept;
+		void (*length)(const T* const* in, size_t dim, T* out, size_t count) noexcept;
+		void (*normalize)(const T* const* in, T* const* out, size_t dim, size_t count) noexcept;
+		void (*cross)(const T* const* lhs, const T* const* rhs, T* const* out, size_t count) noexcept;
+		// mat is the top three rows of a row-major 3x4 or 4x4 (row stride 4); w = 1.
+		void (*transform_points)(const T* mat, const T* const* in, T* const* out, size_t count) noexcept;
+	};
+
+	// Elementwise float approximations over count elements; in and out may be the same
+	// array. The error bounds are documented with the wrappers in clm_batch_math.h.
+	struct approx_kernel_table
+	{
+		util::simd_level level;
+		void (*rsqrt)(const float* in, float* out, size_t count) noexcept;
+		void (*sin)(const float* in, float* out, size_t count) noexcept;
+		void (*cos)(const float* in, float* out, size_t count) noexcept;
+		void (*sincos)(const float* in, float* sinOut, float* cosOut, size_t count) noexcept;
+		void (*exp)(const float* in, float* out, size_t count) noexcept;
+		void (*log)(const float* in, float* out, size_t count) noexcept;
+	};
+
+	// Geometry predicates over structure-of-arrays double input.
+	struct geometry_kernel_table
+	{
+		util::simd_level level;
+		// segments holds the x0, y0, x1, y1 arrays. Writes every j in [begin, end) whose
+		// segment intersects segment i (as detail::segments_intersect in clm_geo.h decides)
+		// to out in ascending order and returns how many; out needs room for end - begin.
+		size_t (*segment_hits)(const double* const* segments, size_t i, size_t begin, size_t end, std::uint32_t* out) noexcept;
+	};
+
+	// Rect kernels over structure-of-arrays int32 input. rects holds the left, top, right
+	// and bottom arrays; a single rect argument is {left, top, right, bottom}. Rects are
+	// half-open and empty ones never match, as with Rect in clm_rect.h. Index lists come
+	// out ascending, need room for count entries, and the kernels return their length.
+	struct rect_kernel_table
+	{
+		util::simd_level level;
+		size_t (*intersecting)(const std::int32_t* const* rects, size_t count, const std::int32_t* area, std::uint32_t* out) noexcept;
+		size_t (*containing)(const std::int32_t* const* rects, size_t count, std::int32_t x, std::int32_t y, std::uint32_t* out) noexcept;
+		// Writes every rect clipped to clip to out, which may alias rects, and lists the
+		// ones left non-empty.
+		size_t (*clip)(const std::int32_t* const* rects, size_t count, const std::int32_t* clip, std::int32_t* const* out, std::uint32_t* indices) noexcept;
+		// Bounding union of the non-empty rects, all zero if there are none.
+		void (*bounds)(const std::int32_t* const* rects, size_t count, std::int32_t* out) noexcept;
+		// width * height per rect, 0 for empty ones.
+		void (*area)(const std::int32_t* const* rects, size_t count, std::uint64_t* out) noexcept;
+	};
+
+	// Color kernels over interleaved float pixels of channels components (1, 3 or 4),
+	// count pixels each; out may alias in. With 4 channels the last is alpha and is copied
+	// through unchanged.
+	struct color_kernel_table
+	{
+		util::simd_level level;
+		void (*srgb_to_linear)(const float* in, float* out, size_t count, size_t channels) noexcept;
+		void (*linear_to_srgb)(const float* in, float* out, size_t count, size_t channels) noexcept;
+		// count components, 0..255 to and from 0..1. pack clamps, rounds to nearest and
+		// writes 0 for NaN.
+		void (*unpack_unorm8)(const std::uint8_t* in, float* out, size_t count) noexcept;
+		void (*pack_unorm8)(const float* in, std::uint8_t* out, size_t count) noexcept;
+		// RGBA only: rgb *= a, and Rec. 709 luminance into one float per pixel.
+		void (*premultiply)(const float* in, float* out, size_t count) noexcept;
+		void (*luminance)(const float* in, float* out, size_t count) noexcept;
+		// Porter-Duff compositing of premultiplied RGBA src onto dst, in place: over is
+		// src + dst * (1 - src.a), add is src + dst (unclamped), and multiply is
+		// src * dst + src * (1 - dst.a) + dst * (1 - src.a).
+		void (*blend_over)(const float* src, float* dst, size_t count) noexcept;
+		void (*blend_add)(const float* src, float* dst, size_t count) noexcept;
+		void (*blend_multiply)(const float* src, float* dst, size_t count) noexcept;
+	};
+
+	// Table for util::active_simd_level(), or the best one compiled in below it.
+	template<dispatched_type T>
+	const batch_kernel_table<T>& batch_kernels() noexcept;
+
+	// Table for an explicit level instead of the active one, clamped to what the CPU runs.
+	// Used to compare code paths side by side.
+	template<dispatched_type T>
+	const batch_kernel_table<T>& batch_kernels(util::simd_level level) noexcept;
+
+	const approx_kernel_table& approx_kernels() noexcept;
+	const approx_kernel_table& approx_kernels(util::simd_level level) noexcept;
+
+	const geometry_kernel_table& geometry_kernels() noexcept;
+	const geometry_kernel_table& geometry_kernels(util::simd_level level) noexcept;
+
+	const rect_kernel_table& rect_kernels() noexcept;
+	const rect_kernel_table& rect_kernels(util::simd_level level) noexcept;
+
+	const color_kernel_table& color_kernels() noexcept;
+	const color_kernel_table& color_kernels(util::simd_level level) noexcept;
+
+	extern template const batch_kernel_table<float>& batch_kernels<float>() noexcept;
+	extern template const batch_kernel_table<double>& batch_kernels<double>() noexcept;
+	extern template const batch_kernel_table<float>& batch_kernels<float>(util::simd_level) noexcept;
+	extern template const batch_kernel_table<double>& batch_kernels<double>(util::simd_level) noexcept;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,311 @@
+#ifndef CLM_DISPATCH_APPROX_H
+#define CLM_DISPATCH_APPROX_H
+
+// Polynomial approximations behind dispatch::approx_kernel_table, written once against
+// the float pack interface. Included from clm_dispatch_kernels.h only, and for the same
+// reason everything is in an anonymous namespace. The coefficients are the single
+// precision minimax sets from Cephes (sinf, cosf, expf, logf).
+
+#include "clm_dispatch.h"
+#include "clm_simd_pack.h"
+#include "clm_dispatch_common.h"
+
+namespace clm::math::dispatch {
+	namespace {
+		template<typename P>
+		struct approx
+		{
+			using reg_t = typename P::reg_t;
+			using ireg_t = typename P::ireg_t;
+
+			// The reduction below stays exact while |j| < 2^13; packs with a lane past
+			// trigLimit (or inf) go through the C library instead.
+			static constexpr float trigLimit = 8192.0f;
+
+			// One Newton-Raphson step on the hardware estimate: y' = y * (1.5 - 0.5 * x * y * y).
+			// x * y is formed first so y * y cannot overflow for denormal x. The estimate is
+			// already exact for 0 and inf, which the step would turn into NaN; checking the
+			// estimate rather than x also covers denormals the SSE/AVX estimate flushes to 0.
+			static reg_t rsqrt(reg_t x) noexcept
+			{
+				const reg_t y = P::rsqrt_est(x);
+				const reg_t xyy = P::mul(P::mul(x, y), y);
+				const reg_t refined = P::mul(y, P::fmadd(xyy, P::set1(-0.5f), P::set1(1.5f)));
+				const reg_t inf = P::set1(floatInfinity);
+				return P::select(P::cmp_eq(P::abs(y), inf), y, P::select(P::cmp_eq(x, inf), y, refined));
+			}
+
+			// x = j * pi/2 + y, |y| <= pi/4. pi/2 is split in four; the first three parts have
+			// 11 significant bits, so with |j| < 2^13 their products are exact even without FMA
+			// and y keeps its accuracy next to the zeros of sin and cos.
+			static reg_t reduce(reg_t x, ireg_t& quadrant) noexcept
+			{
+				quadrant = P::to_int(P::mul(x, P::set1(0.636619772367581343f)));
+				const reg_t j = P::to_float(quadrant);
+				reg_t y = P::fmadd(j, P::set1(-1.5703125f), x);
+				y = P::fmadd(j, P::set1(-4.837512969970703125e-4f), y);
+				y = P::fmadd(j, P::set1(-7.549533620476723e-8f), y);
+				return P::fmadd(j, P::set1(-2.5633440682570896e-12f), y);
+			}
+			static reg_t sin_poly(reg_t y, reg_t z) noexcept
+			{
+				reg_t p = P::fmadd(z, P::set1(-1.9515295891e-4f), P::set1(8.3321608736e-3f));
+				p = P::fmadd(p, z, P::set1(-1.6666654611e-1f));
+				return P::fmadd(P::mul(p, z), y, y);
+			}
+			static reg_t cos_poly(reg_t z) noexcept
+			{
+				reg_t p = P::fmadd(z, P::set1(2.443315711809948e-5f), P::set1(-1.388731625493765e-3f));
+				p = P::fmadd(p, z, P::set1(4.166664568298827e-2f));
+				return P::fmadd(P::mul(p, z), z, P::fmadd(z, P::set1(-0.5f), P::set1(1.0f)));
+			}
+			// Quadrant q picks the polynomial (odd quadrants swap sin and cos) and the sign
+			// (quadrants 2 and 3 negate).
+			static reg_t by_quadrant(ireg_t q, reg_t sinY, reg_t cosY) noexcept
+			{
+				const auto swap = P::ieq(P::iand(q, P::iset1(1)), P::iset1(1));
+				const reg_t sign = P::as_float(P::template shl<30>(P::iand(q, P::iset1(2))));
+				return P::bit_xor(P::select(swap, cosY, sinY), sign);
+			}
+
+			static bool needs_libm(reg_t x) noexcept
+			{
+				return P::any(P::cmp_ge(P::abs(x), P::set1(trigLimit)));
+			}
+			template<typename Fn>
+			static reg_t per_lane(reg_t x, Fn fn) noexcept
+			{
+				alignas(64) float lanes[P::width];
+				P::store(lanes, x);
+				for (float& lane : lanes)
+				{
+					lane = fn(lane);
+				}
+				return P::load(lanes);
+			}
+
+			static reg_t sin(reg_t x) noexcept
+			{
+				if (needs_libm(x))
+				{
+					return per_lane(x, [](float v) { return libm_sin(v); });
+				}
+				ireg_t q{};
+				const reg_t y = reduce(x, q);
+				const reg_t z = P::mul(y, y);
+				return by_quadrant(q, sin_poly(y, z), cos_poly(z));
+			}
+			static reg_t cos(reg_t x) noexcept
+			{
+				if (needs_libm(x))
+				{
+					return per_lane(x, [](float v) { return libm_cos(v); });
+				}
+				ireg_t q{};
+				const reg_t y = reduce(x, q);
+				const reg_t z = P::mul(y, y);
+				return by_quadrant(P::iadd(q, P::iset1(1)), sin_poly(y, z), cos_poly(z));
+			}
+			static void sincos(reg_t x, reg_t& sinOut, reg_t& cosOut) noexcept
+			{
+				if (needs_libm(x))
+				{
+					sinOut = per_lane(x, [](float v) { return libm_sin(v); });
+					cosOut = per_lane(x, [](float v) { return libm_cos(v); });
+					return;
+				}
+				ireg_t q{};
+				const reg_t y = reduce(x, q);
+				const reg_t z = P::mul(y, y);
+				const reg_t s = sin_poly(y, z);
+				const reg_t c = cos_poly(z);
+				sinOut = by_quadrant(q, s, c);
+				cosOut = by_quadrant(P::iadd(q, P::iset1(1)), s, c);
+			}
+
+			// exp(x) = 2^n * exp(r), |r| <= ln2 / 2. 2^n is applied as two factors so the
+			// clamped range [-104, 89] still rounds to 0 and overflows to inf on its own.
+			// The operand order of min/max lets NaN lanes through unchanged.
+			static reg_t exp(reg_t x) noexcept
+			{
+				x = P::min(P::set1(89.0f), P::max(P::set1(-104.0f), x));
+				const ireg_t n = P::to_int(P::mul(x, P::set1(1.44269504088896341f)));
+				const reg_t nf = P::to_float(n);
+				reg_t r = P::fmadd(nf, P::set1(-0.693359375f), x);
+				r = P::fmadd(nf, P::set1(2.12194440e-4f), r);
+
+				reg_t p = P::fmadd(r, P::set1(1.9875691500e-4f), P::set1(1.3981999507e-3f));
+				p = P::fmadd(p, r, P::set1(8.3334519073e-3f));
+				p = P::fmadd(p, r, P::set1(4.1665795894e-2f));
+				p = P::fmadd(p, r, P::set1(1.6666665459e-1f));
+				p = P::fmadd(p, r, P::set1(5.0000001201e-1f));
+				p = P::fmadd(p, P::mul(r, r), P::add(r, P::set1(1.0f)));
+
+				const ireg_t half = P::to_int(P::mul(nf, P::set1(0.5f)));
+				const ireg_t bias = P::iset1(127);
+				const reg_t scale0 = P::as_float(P::template shl<23>(P::iadd(half, bias)));
+				const reg_t scale1 = P::as_float(P::template shl<23>(P::iadd(P::isub(n, half), bias)));
+				return P::mul(P::mul(p, scale0), scale1);
+			}
+
+			// log(x) = e * ln2 + log(m) with m folded into [sqrt(1/2), sqrt(2)). Denormals
+			// are scaled up by 2^23 first; 0, negatives, inf and NaN are patched at the end.
+			static reg_t log(reg_t x) noexcept
+			{
+				const auto tiny = P::cmp_lt(x, P::set1(floatMinNormal));
+				const reg_t scaled = P::select(tiny, P::mul(x, P::set1(8388608.0f)), x);
+				reg_t e = P::select(tiny, P::set1(-23.0f), P::zero());
+
+				const ireg_t bits = P::as_int(scaled);
+				e = P::add(e, P::to_float(P::isub(P::template shr<23>(bits), P::iset1(126))));
+				reg_t m = P::as_float(P::ior(P::iand(bits, P::iset1(0x007FFFFF)), P::iset1(0x3F000000)));
+				const auto low = P::cmp_lt(m, P::set1(0.707106781186547524f));
+				e = P::sub(e, P::select(low, P::set1(1.0f), P::zero()));
+				m = P::sub(P::select(low, P::add(m, m), m), P::set1(1.0f));
+
+				const reg_t z = P::mul(m, m);
+				reg_t p = P::fmadd(m, P::set1(7.0376836292e-2f), P::set1(-1.1514610310e-1f));
+				p = P::fmadd(p, m, P::set1(1.1676998740e-1f));
+				p = P::fmadd(p, m, P::set1(-1.2420140846e-1f));
+				p = P::fmadd(p, m, P::set1(1.4249322787e-1f));
+				p = P::fmadd(p, m, P::set1(-1.6668057665e-1f));
+				p = P::fmadd(p, m, P::set1(2.0000714765e-1f));
+				p = P::fmadd(p, m, P::set1(-2.4999993993e-1f));
+				p = P::fmadd(p, m, P::set1(3.3333331174e-1f));
+				reg_t y = P::mul(P::mul(p, m), z);
+				y = P::fmadd(e, P::set1(-2.12194440e-4f), y);
+				y = P::fmadd(z, P::set1(-0.5f), y);
+				reg_t result = P::fmadd(e, P::set1(0.693359375f), P::add(m, y));
+
+				const reg_t inf = P::set1(floatInfinity);
+				result = P::select(P::cmp_eq(x, inf), inf, result);
+				result = P::select(P::cmp_eq(x, P::zero()), P::set1(-floatInfinity), result);
+				return P::select(P::cmp_ge(x, P::zero()), result, P::set1(floatQuietNaN));
+			}
+		};
+
+		// Full packs straight from memory, then the tail through a padded copy so it gets
+		// exactly the same arithmetic as the rest of the array.
+		template<typename P, typename Fn>
+		void map_packs(const float* in, float* out, size_t count, Fn fn) noexcept
+		{
+			size_t i = 0;
+			for (; i + P::width <= count; i += P::width)
+			{
+				P::store(out + i, fn(P::load(in + i)));
+			}
+			if (i < count)
+			{
+				alignas(64) float buf[P::width];
+				fill_lanes(buf, P::width, 1.0f);
+				copy_lanes(in + i, count - i, buf);
+				P::store(buf, fn(P::load(buf)));
+				copy_lanes(buf, count - i, out + i);
+			}
+		}
+
+		template<typename P>
+		struct approx_kernels
+		{
+			using math_t = approx<P>;
+
+			static void rsqrt(const float* in, float* out, size_t count) noexcept
+			{
+				map_packs<P>(in, out, count, [](auto x) { return math_t::rsqrt(x); });
+			}
+			static void sin(const float* in, float* out, size_t count) noexcept
+			{
+				map_packs<P>(in, out, count, [](auto x) { return math_t::sin(x); });
+			}
+			static void cos(const float* in, float* out, size_t count) noexcept
+			{
+				map_packs<P>(in, out, count, [](auto x) { return math_t::cos(x); });
+			}
+			static void exp(const float* in, float* out, size_t count) noexcept
+			{
+				map_packs<P>(in, out, count, [](auto x) { return math_t::exp(x); });
+			}
+			static void log(const float* in, float* out, size_t count) noexcept
+			{
+				map_packs<P>(in, out, count, [](auto x) { return math_t::log(x); });
+			}
+			static void sincos(const float* in, float* sinOut, float* cosOut, size_t count) noexcept
+			{
+				size_t i = 0;
+				typename P::reg_t s{};
+				typename P::reg_t c{};
+				for (; i + P::width <= count; i += P::width)
+				{
+					math_t::sincos(P::load(in + i), s, c);
+					P::store(sinOut + i, s);
+					P::store(cosOut + i, c);
+				}
+				if (i < count)
+				{
+					alignas(64) float buf[P::width]{};
+					copy_lanes(in + i, count - i, buf);
+					math_t::sincos(P::load(buf), s, c);
+					P::store(buf, s);
+					copy_lanes(buf, count - i, sinOut + i);
+					P::store(buf, c);
+					copy_lanes(buf, count - i, cosOut + i);
+				}
+			}
+
+			static constexpr approx_kernel_table table(util::simd_level level) noexcept
+			{
+				return approx_kernel_table{level, &rsqrt, &sin, &cos, &sincos, &exp, &log};
+			}
+		};
+
+		// The scalar level defers to the C library, element by element.
+		struct libm_kernels
+		{
+			template<typename Fn>
+			static void map(const float* in, float* out, size_t count, Fn fn) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					out[i] = fn(in[i]);
+				}
+			}
+
+			static void rsqrt(const float* in, float* out, size_t count) noexcept
+			{
+				map(in, out, count, [](float x) { return 1.0f / libm_sqrt(x); });
+			}
+			static void sin(const float* in, float* out, size_t count) noexcept
+			{
+				map(in, out, count, [](float x) { return libm_sin(x); });
+			}
+			static void cos(const float* in, float* out, size_t count) noexcept
+			{
+				map(in, out, count, [](float x) { return libm_cos(x); });
+			}
+			static void exp(const float* in, float* out, size_t count) noexcept
+			{
+				map(in, out, count, [](float x) { return libm_exp(x); });
+			}
+			static void log(const float* in, float* out, size_t count) noexcept
+			{
+				map(in, out, count, [](float x) { return libm_log(x); });
+			}
+			static void sincos(const float* in, float* sinOut, float* cosOut, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const float x = in[i];
+					sinOut[i] = libm_sin(x);
+					cosOut[i] = libm_cos(x);
+				}
+			}
+
+			static constexpr approx_kernel_table table(util::simd_level level) noexcept
+			{
+				return approx_kernel_table{level, &rsqrt, &sin, &cos, &sincos, &exp, &log};
+			}
+		};
+	}
+}
+
+#endif
\ No newline at end of file
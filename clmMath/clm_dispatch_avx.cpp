@@ -0,0 +1,8 @@
+#include "clm_dispatch_kernels.h"
+
+// Built with /arch:AVX or -mavx (see CMakeLists.txt).
+#if defined(CLM_SIMD_AVX)
+CLM_DEFINE_KERNEL_TABLES(avx, util::simd_level::avx, simd::avx_pack)
+#else
+CLM_DEFINE_EMPTY_KERNEL_TABLES(avx)
+#endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "clm_dispatch_kernels.h"
+
+// Built with /arch:AVX2 or -mavx2 -mfma (see CMakeLists.txt); the AVX packs plus fused
+// multiply-adds and 256-bit integer lanes.
+#if defined(CLM_SIMD_AVX2) && defined(CLM_SIMD_FMA)
+CLM_DEFINE_KERNEL_TABLES(avx2, util::simd_level::avx2, simd::avx2_pack)
+#else
+CLM_DEFINE_EMPTY_KERNEL_TABLES(avx2)
+#endif
\ No newline at end of file
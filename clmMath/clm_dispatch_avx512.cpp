@@ -0,0 +1,8 @@
+#include "clm_dispatch_kernels.h"
+
+// Built with /arch:AVX512 or -mavx512f -mavx2 -mfma (see CMakeLists.txt).
+#if defined(CLM_SIMD_AVX512)
+CLM_DEFINE_KERNEL_TABLES(avx512, util::simd_level::avx512, simd::avx512_pack)
+#else
+CLM_DEFINE_EMPTY_KERNEL_TABLES(avx512)
+#endif
\ No newline at end of file
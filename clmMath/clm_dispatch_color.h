@@ -0,0 +1,281 @@
+#ifndef CLM_DISPATCH_COLOR_H
+#define CLM_DISPATCH_COLOR_H
+
+// Color kernels behind dispatch::color_kernel_table, written against the float pack
+// interface. Included from clm_dispatch_kernels.h only, in an anonymous namespace for the
+// same reason. The sRGB transfer curve's power segment runs through exp and log from
+// clm_dispatch_approx.h.
+
+#include <cstdint>
+
+#include "clm_dispatch.h"
+#include "clm_simd_pack.h"
+#include "clm_dispatch_common.h"
+#include "clm_dispatch_approx.h"
+
+namespace clm::math::dispatch {
+	namespace {
+		// IEC 61966-2-1 constants, shared with the scalar fallback so every level agrees
+		// on where the linear segment ends.
+		inline constexpr float srgbDecodeKnee = 0.04045f;
+		inline constexpr float srgbEncodeKnee = 0.0031308f;
+		inline constexpr float srgbSlope = 12.92f;
+		inline constexpr float srgbOffset = 0.055f;
+		inline constexpr float srgbScale = 1.055f;
+		inline constexpr float srgbGamma = 2.4f;
+
+		inline constexpr float lumaR = 0.2126f;
+		inline constexpr float lumaG = 0.7152f;
+		inline constexpr float lumaB = 0.0722f;
+
+		template<typename P>
+		struct pixel_kernels
+		{
+			using reg_t = typename P::reg_t;
+			using math_t = approx<P>;
+
+			// Every pack starts on a pixel boundary (widths are multiples of four), so the
+			// alpha lanes of RGBA data are the same in every pack.
+			static typename P::mask_t alpha_lanes(size_t channels) noexcept
+			{
+				alignas(64) static constexpr float rgba[16]{0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+				alignas(64) static constexpr float none[16]{};
+				return P::cmp_ge(P::load(channels == 4 ? rgba : none), P::set1(1.0f));
+			}
+
+			static reg_t decode(reg_t c) noexcept
+			{
+				const reg_t t = P::div(P::add(c, P::set1(srgbOffset)), P::set1(srgbScale));
+				const reg_t curve = math_t::exp(P::mul(math_t::log(t), P::set1(srgbGamma)));
+				return P::select(P::cmp_lt(P::set1(srgbDecodeKnee), c), curve, P::div(c, P::set1(srgbSlope)));
+			}
+			static reg_t encode(reg_t c) noexcept
+			{
+				const reg_t curve = math_t::exp(P::div(math_t::log(c), P::set1(srgbGamma)));
+				const reg_t scaled = P::fmadd(curve, P::set1(srgbScale), P::set1(-srgbOffset));
+				return P::select(P::cmp_lt(P::set1(srgbEncodeKnee), c), scaled, P::mul(c, P::set1(srgbSlope)));
+			}
+
+			static void srgb_to_linear(const float* in, float* out, size_t count, size_t channels) noexcept
+			{
+				const auto alpha = alpha_lanes(channels);
+				map_packs<P>(in, out, count * channels, [=](reg_t x) { return P::select(alpha, x, decode(x)); });
+			}
+			static void linear_to_srgb(const float* in, float* out, size_t count, size_t channels) noexcept
+			{
+				const auto alpha = alpha_lanes(channels);
+				map_packs<P>(in, out, count * channels, [=](reg_t x) { return P::select(alpha, x, encode(x)); });
+			}
+
+			static void unpack_unorm8(const std::uint8_t* in, float* out, size_t count) noexcept
+			{
+				const auto unpack = [](const std::uint8_t* src) {
+					return P::div(P::to_float(P::load_u8(src)), P::set1(255.0f));
+				};
+				size_t i = 0;
+				for (; i + P::width <= count; i += P::width)
+				{
+					P::store(out + i, unpack(in + i));
+				}
+				if (i < count)
+				{
+					std::uint8_t bytes[P::width]{};
+					alignas(64) float buf[P::width];
+					copy_lanes(in + i, count - i, bytes);
+					P::store(buf, unpack(bytes));
+					copy_lanes(buf, count - i, out + i);
+				}
+			}
+			// max(x, 0) returns its second operand for NaN lanes.
+			static void pack_unorm8(const float* in, std::uint8_t* out, size_t count) noexcept
+			{
+				const auto pack = [](std::uint8_t* dst, reg_t x) {
+					x = P::min(P::max(x, P::zero()), P::set1(1.0f));
+					P::store_u8(dst, P::to_int(P::mul(x, P::set1(255.0f))));
+				};
+				size_t i = 0;
+				for (; i + P::width <= count; i += P::width)
+				{
+					pack(out + i, P::load(in + i));
+				}
+				if (i < count)
+				{
+					alignas(64) float buf[P::width]{};
+					std::uint8_t bytes[P::width];
+					copy_lanes(in + i, count - i, buf);
+					pack(bytes, P::load(buf));
+					copy_lanes(bytes, count - i, out + i);
+				}
+			}
+
+			static void premultiply(const float* in, float* out, size_t count) noexcept
+			{
+				const auto alpha = alpha_lanes(4);
+				map_packs<P>(in, out, count * 4, [=](reg_t x) { return P::select(alpha, x, P::mul(x, P::spread_alpha(x))); });
+			}
+			static void luminance(const float* in, float* out, size_t count) noexcept
+			{
+				const auto luma = [](const float* src) {
+					reg_t r, g, b, a;
+					P::load_rgba(src, r, g, b, a);
+					return P::fmadd(b, P::set1(lumaB), P::fmadd(g, P::set1(lumaG), P::mul(r, P::set1(lumaR))));
+				};
+				size_t i = 0;
+				for (; i + P::width <= count; i += P::width)
+				{
+					P::store(out + i, luma(in + 4 * i));
+				}
+				if (i < count)
+				{
+					alignas(64) float buf[P::width * 4]{};
+					copy_lanes(in + 4 * i, 4 * (count - i), buf);
+					P::store(buf, luma(buf));
+					copy_lanes(buf, count - i, out + i);
+				}
+			}
+
+			// dst = fn(src, dst) over count RGBA pixels, the tail through padded copies.
+			template<typename Fn>
+			static void blend(const float* src, float* dst, size_t count, Fn fn) noexcept
+			{
+				const size_t floats = count * 4;
+				size_t i = 0;
+				for (; i + P::width <= floats; i += P::width)
+				{
+					P::store(dst + i, fn(P::load(src + i), P::load(dst + i)));
+				}
+				if (i < floats)
+				{
+					alignas(64) float s[P::width]{};
+					alignas(64) float d[P::width]{};
+					copy_lanes(src + i, floats - i, s);
+					copy_lanes(dst + i, floats - i, d);
+					P::store(d, fn(P::load(s), P::load(d)));
+					copy_lanes(d, floats - i, dst + i);
+				}
+			}
+			static void blend_over(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](reg_t s, reg_t d) {
+					return P::fmadd(d, P::sub(P::set1(1.0f), P::spread_alpha(s)), s);
+				});
+			}
+			static void blend_add(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](reg_t s, reg_t d) { return P::add(s, d); });
+			}
+			static void blend_multiply(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](reg_t s, reg_t d) {
+					const reg_t keepDst = P::mul(d, P::sub(P::set1(1.0f), P::spread_alpha(s)));
+					return P::fmadd(s, d, P::fmadd(s, P::sub(P::set1(1.0f), P::spread_alpha(d)), keepDst));
+				});
+			}
+
+			static constexpr color_kernel_table table(util::simd_level level) noexcept
+			{
+				return color_kernel_table{level, &srgb_to_linear, &linear_to_srgb, &unpack_unorm8, &pack_unorm8, &premultiply, &luminance,
+										  &blend_over, &blend_add, &blend_multiply};
+			}
+		};
+
+		// The scalar level, with the C library's powf for the transfer curve.
+		struct libm_pixel_kernels
+		{
+			static float decode(float c) noexcept
+			{
+				return c > srgbDecodeKnee ? libm_pow((c + srgbOffset) / srgbScale, srgbGamma) : c / srgbSlope;
+			}
+			static float encode(float c) noexcept
+			{
+				return c > srgbEncodeKnee ? libm_pow(c, 1.0f / srgbGamma) * srgbScale - srgbOffset : c * srgbSlope;
+			}
+
+			template<typename Fn>
+			static void map(const float* in, float* out, size_t count, size_t channels, Fn fn) noexcept
+			{
+				for (size_t i = 0; i < count * channels; i++)
+				{
+					out[i] = channels == 4 && i % 4 == 3 ? in[i] : fn(in[i]);
+				}
+			}
+
+			static void srgb_to_linear(const float* in, float* out, size_t count, size_t channels) noexcept
+			{
+				map(in, out, count, channels, decode);
+			}
+			static void linear_to_srgb(const float* in, float* out, size_t count, size_t channels) noexcept
+			{
+				map(in, out, count, channels, encode);
+			}
+			static void unpack_unorm8(const std::uint8_t* in, float* out, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					out[i] = in[i] / 255.0f;
+				}
+			}
+			static void pack_unorm8(const float* in, std::uint8_t* out, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const float x = in[i] > 0.0f ? min_of(in[i], 1.0f) : 0.0f;
+					out[i] = static_cast<std::uint8_t>(libm_nearbyint(x * 255.0f));
+				}
+			}
+			static void premultiply(const float* in, float* out, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count * 4; i += 4)
+				{
+					const float a = in[i + 3];
+					out[i] = in[i] * a;
+					out[i + 1] = in[i + 1] * a;
+					out[i + 2] = in[i + 2] * a;
+					out[i + 3] = a;
+				}
+			}
+			static void luminance(const float* in, float* out, size_t count) noexcept
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const float* px = in + 4 * i;
+					out[i] = px[0] * lumaR + px[1] * lumaG + px[2] * lumaB;
+				}
+			}
+
+			template<typename Fn>
+			static void blend(const float* src, float* dst, size_t count, Fn fn) noexcept
+			{
+				for (size_t i = 0; i < count * 4; i += 4)
+				{
+					const float sa = src[i + 3];
+					const float da = dst[i + 3];
+					for (size_t c = 0; c < 4; c++)
+					{
+						dst[i + c] = fn(src[i + c], dst[i + c], sa, da);
+					}
+				}
+			}
+			static void blend_over(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](float s, float d, float sa, float) { return d * (1.0f - sa) + s; });
+			}
+			static void blend_add(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](float s, float d, float, float) { return s + d; });
+			}
+			static void blend_multiply(const float* src, float* dst, size_t count) noexcept
+			{
+				blend(src, dst, count, [](float s, float d, float sa, float da) { return s * d + (s * (1.0f - da) + d * (1.0f - sa)); });
+			}
+
+			static constexpr color_kernel_table table(util::simd_level level) noexcept
+			{
+				return color_kernel_table{level, &srgb_to_linear, &linear_to_srgb, &unpack_unorm8, &pack_unorm8, &premultiply, &luminance,
+										  &blend_over, &blend_add, &blend_multiply};
+			}
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef CLM_DISPATCH_COMMON_H
+#define CLM_DISPATCH_COMMON_H
+
+// Stand-ins for the standard library pieces the dispatch kernels need. std::min, std::copy,
+// std::countr_zero and the float overloads of std::sqrt and friends are inline templates
+// or wrappers, so an unoptimized build emits weak copies of them from every ISA source and
+// the linker keeps whichever it sees first, AVX-512 encoding included. These have internal
+// linkage; the math functions forward to the C library, whose entry points are not inline.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace clm::math::dispatch {
+	namespace {
+		// Initialized in a constant expression, so numeric_limits never has to be emitted.
+		constexpr float floatInfinity = std::numeric_limits<float>::infinity();
+		constexpr float floatMinNormal = std::numeric_limits<float>::min();
+		constexpr float floatQuietNaN = std::numeric_limits<float>::quiet_NaN();
+
+		template<typename T>
+		constexpr T min_of(T lhs, T rhs) noexcept
+		{
+			return rhs < lhs ? rhs : lhs;
+		}
+		template<typename T>
+		constexpr T max_of(T lhs, T rhs) noexcept
+		{
+			return lhs < rhs ? rhs : lhs;
+		}
+
+		template<typename T>
+		void copy_lanes(const T* in, size_t count, T* out) noexcept
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				out[i] = in[i];
+			}
+		}
+		template<typename T>
+		void fill_lanes(T* out, size_t count, T value) noexcept
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				out[i] = value;
+			}
+		}
+
+		// bits must not be 0.
+		inline std::uint32_t lowest_set_bit(std::uint32_t bits) noexcept
+		{
+#if defined(_MSC_VER)
+			unsigned long index = 0;
+			_BitScanForward(&index, bits);
+			return static_cast<std::uint32_t>(index);
+#else
+			return static_cast<std::uint32_t>(__builtin_ctz(bits));
+#endif
+		}
+
+		inline float libm_sqrt(float x) noexcept { return ::sqrtf(x); }
+		inline double libm_sqrt(double x) noexcept { return ::sqrt(x); }
+		inline float libm_sin(float x) noexcept { return ::sinf(x); }
+		inline float libm_cos(float x) noexcept { return ::cosf(x); }
+		inline float libm_exp(float x) noexcept { return ::expf(x); }
+		inline float libm_log(float x) noexcept { return ::logf(x); }
+		inline float libm_pow(float x, float y) noexcept { return ::powf(x, y); }
+		inline float libm_nearbyint(float x) noexcept { return ::nearbyintf(x); }
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#ifndef CLM_DISPATCH_GEOMETRY_H
+#define CLM_DISPATCH_GEOMETRY_H
+
+// Geometry kernels behind dispatch::geometry_kernel_table and dispatch::rect_kernel_table.
+// Included from clm_dispatch_kernels.h only, in an anonymous namespace for the same reason.
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "clm_dispatch.h"
+#include "clm_simd_pack.h"
+#include "clm_dispatch_common.h"
+
+namespace clm::math::dispatch {
+	namespace {
+		// Writes i + lane for every lane set in mask to out[count...] in lane order.
+		template<typename P>
+		void append_lanes(typename P::mask_t mask, size_t i, std::uint32_t* out, size_t& count) noexcept
+		{
+			for (std::uint32_t bits = P::bits(mask); bits != 0; bits &= bits - 1)
+			{
+				out[count++] = static_cast<std::uint32_t>(i + lowest_set_bit(bits));
+			}
+		}
+
+		// wide_t and tail_t are double packs; the tail pack is a parameter because lane is
+		// defined after this header is included.
+		template<typename wide_t, typename tail_t>
+		struct segment_kernels
+		{
+			template<typename P>
+			static typename P::mask_t straddles(typename P::reg_t d1, typename P::reg_t d2) noexcept
+			{
+				const auto zero = P::zero();
+				return P::mask_or(P::mask_and(P::cmp_le(d1, zero), P::cmp_ge(d2, zero)),
+								  P::mask_and(P::cmp_ge(d1, zero), P::cmp_le(d2, zero)));
+			}
+
+			// detail::segments_intersect from clm_geo.h, segment i against a pack of others.
+			// The orientations are written out term for term so every level rounds them the
+			// same way as the scalar version.
+			static size_t segment_hits(const double* const* segments, size_t i, size_t begin, size_t end, std::uint32_t* out) noexcept
+			{
+				const double ax0 = segments[0][i];
+				const double ay0 = segments[1][i];
+				const double ax1 = segments[2][i];
+				const double ay1 = segments[3][i];
+				const double aMinX = min_of(ax0, ax1);
+				const double aMaxX = max_of(ax0, ax1);
+				const double aMinY = min_of(ay0, ay1);
+				const double aMaxY = max_of(ay0, ay1);
+				const double adx = ax1 - ax0;
+				const double ady = ay1 - ay0;
+
+				size_t hits = 0;
+				simd::for_each_pack_as<wide_t, tail_t>(end - begin, [&]<typename P>(size_t offset) {
+					const size_t j = begin + offset;
+					const auto bx0 = P::load(segments[0] + j);
+					const auto by0 = P::load(segments[1] + j);
+					const auto bx1 = P::load(segments[2] + j);
+					const auto by1 = P::load(segments[3] + j);
+
+					auto mask = P::mask_and(P::cmp_le(P::min(bx0, bx1), P::set1(aMaxX)), P::cmp_le(P::set1(aMinX), P::max(bx0, bx1)));
+					mask = P::mask_and(mask, P::mask_and(P::cmp_le(P::min(by0, by1), P::set1(aMaxY)), P::cmp_le(P::set1(aMinY), P::max(by0, by1))));
+
+					const auto d1 = P::sub(P::mul(P::set1(adx), P::sub(by0, P::set1(ay0))), P::mul(P::set1(ady), P::sub(bx0, P::set1(ax0))));
+					const auto d2 = P::sub(P::mul(P::set1(adx), P::sub(by1, P::set1(ay0))), P::mul(P::set1(ady), P::sub(bx1, P::set1(ax0))));
+					const auto bdx = P::sub(bx1, bx0);
+					const auto bdy = P::sub(by1, by0);
+					const auto d3 = P::sub(P::mul(bdx, P::sub(P::set1(ay0), by0)), P::mul(bdy, P::sub(P::set1(ax0), bx0)));
+					const auto d4 = P::sub(P::mul(bdx, P::sub(P::set1(ay1), by0)), P::mul(bdy, P::sub(P::set1(ax1), bx0)));
+					mask = P::mask_and(mask, P::mask_and(straddles<P>(d1, d2), straddles<P>(d3, d4)));
+
+					append_lanes<P>(mask, j, out, hits);
+				});
+				return hits;
+			}
+
+			static constexpr geometry_kernel_table table(util::simd_level level) noexcept
+			{
+				return geometry_kernel_table{level, &segment_hits};
+			}
+		};
+
+		// Over int32 packs; the same formulas as the members of Rect in clm_rect.h.
+		template<typename wide_t, typename tail_t>
+		struct rect_batch_kernels
+		{
+			template<typename P>
+			static typename P::mask_t non_empty(typename P::reg_t left, typename P::reg_t top, typename P::reg_t right, typename P::reg_t bottom) noexcept
+			{
+				return P::mask_and(P::cmp_lt(left, right), P::cmp_lt(top, bottom));
+			}
+
+			static size_t intersecting(const std::int32_t* const* rects, size_t count, const std::int32_t* area, std::uint32_t* out) noexcept
+			{
+				if (area[0] >= area[2] || area[1] >= area[3])
+				{
+					return 0;
+				}
+				size_t hits = 0;
+				simd::for_each_pack_as<wide_t, tail_t>(count, [&]<typename P>(size_t i) {
+					const auto left = P::load(rects[0] + i);
+					const auto top = P::load(rects[1] + i);
+					const auto right = P::load(rects[2] + i);
+					const auto bottom = P::load(rects[3] + i);
+					auto mask = P::mask_and(P::cmp_lt(P::set1(area[0]), right), P::cmp_lt(left, P::set1(area[2])));
+					mask = P::mask_and(mask, P::mask_and(P::cmp_lt(P::set1(area[1]), bottom), P::cmp_lt(top, P::set1(area[3]))));
+					append_lanes<P>(P::mask_and(mask, non_empty<P>(left, top, right, bottom)), i, out, hits);
+				});
+				return hits;
+			}
+
+			static size_t containing(const std::int32_t* const* rects, size_t count, std::int32_t x, std::int32_t y, std::uint32_t* out) noexcept
+			{
+				size_t hits = 0;
+				simd::for_each_pack_as<wide_t, tail_t>(count, [&]<typename P>(size_t i) {
+					const auto px = P::set1(x);
+					const auto py = P::set1(y);
+					auto mask = P::mask_and(P::cmp_lt(px, P::load(rects[2] + i)), P::cmp_lt(py, P::load(rects[3] + i)));
+					mask = P::mask_and_not(mask, P::cmp_gt(P::load(rects[0] + i), px));
+					mask = P::mask_and_not(mask, P::cmp_gt(P::load(rects[1] + i), py));
+					append_lanes<P>(mask, i, out, hits);
+				});
+				return hits;
+			}
+
+			static size_t clip(const std::int32_t* const* rects, size_t count, const std::int32_t* clip, std::int32_t* const* out, std::uint32_t* indices) noexcept
+			{
+				size_t kept = 0;
+				simd::for_each_pack_as<wide_t, tail_t>(count, [&]<typename P>(size_t i) {
+					const auto left = P::max(P::load(rects[0] + i), P::set1(clip[0]));
+					const auto top = P::max(P::load(rects[1] + i), P::set1(clip[1]));
+					const auto right = P::min(P::load(rects[2] + i), P::set1(clip[2]));
+					const auto bottom = P::min(P::load(rects[3] + i), P::set1(clip[3]));
+					P::store(out[0] + i, left);
+					P::store(out[1] + i, top);
+					P::store(out[2] + i, right);
+					P::store(out[3] + i, bottom);
+					append_lanes<P>(non_empty<P>(left, top, right, bottom), i, indices, kept);
+				});
+				return kept;
+			}
+
+			static void bounds(const std::int32_t* const* rects, size_t count, std::int32_t* out) noexcept
+			{
+				constexpr std::int32_t lowest = std::numeric_limits<std::int32_t>::min();
+				constexpr std::int32_t highest = std::numeric_limits<std::int32_t>::max();
+				// Empty rects are swapped for these, which no min or max ever picks.
+				typename wide_t::reg_t wide[4]{wide_t::set1(highest), wide_t::set1(highest), wide_t::set1(lowest), wide_t::set1(lowest)};
+				typename tail_t::reg_t tail[4]{highest, highest, lowest, lowest};
+				simd::for_each_pack_as<wide_t, tail_t>(count, [&]<typename P>(size_t i) {
+					const auto left = P::load(rects[0] + i);
+					const auto top = P::load(rects[1] + i);
+					const auto right = P::load(rects[2] + i);
+					const auto bottom = P::load(rects[3] + i);
+					const auto keep = non_empty<P>(left, top, right, bottom);
+					auto& acc = [&]() -> auto& {
+						if constexpr (std::is_same_v<P, wide_t>)
+						{
+							return wide;
+						}
+						else
+						{
+							return tail;
+						}
+					}();
+					acc[0] = P::min(acc[0], P::select(keep, left, P::set1(highest)));
+					acc[1] = P::min(acc[1], P::select(keep, top, P::set1(highest)));
+					acc[2] = P::max(acc[2], P::select(keep, right, P::set1(lowest)));
+					acc[3] = P::max(acc[3], P::select(keep, bottom, P::set1(lowest)));
+				});
+
+				std::int32_t lanes[4][wide_t::width];
+				for (size_t side = 0; side < 4; side++)
+				{
+					wide_t::store(lanes[side], wide[side]);
+					out[side] = tail[side];
+					for (size_t lane = 0; lane < wide_t::width; lane++)
+					{
+						out[side] = side < 2 ? min_of(out[side], lanes[side][lane]) : max_of(out[side], lanes[side][lane]);
+					}
+				}
+				if (out[0] == highest)
+				{
+					fill_lanes(out, 4, std::int32_t{0});
+				}
+			}
+
+			static void area(const std::int32_t* const* rects, size_t count, std::uint64_t* out) noexcept
+			{
+				simd::for_each_pack_as<wide_t, tail_t>(count, [&]<typename P>(size_t i) {
+					const auto left = P::load(rects[0] + i);
+					const auto top = P::load(rects[1] + i);
+					const auto right = P::load(rects[2] + i);
+					const auto bottom = P::load(rects[3] + i);
+					// The differences can pass INT32_MAX; read as unsigned they are exact.
+					const auto width = P::select(P::cmp_lt(left, right), P::sub(right, left), P::set1(0));
+					const auto height = P::select(P::cmp_lt(top, bottom), P::sub(bottom, top), P::set1(0));
+					P::store_product_u64(out + i, width, height);
+				});
+			}
+
+			static constexpr rect_kernel_table table(util::simd_level level) noexcept
+			{
+				return rect_kernel_table{level, &intersecting, &containing, &clip, &bounds, &area};
+			}
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,270 @@
+#ifndef CLM_DISPATCH_KERNELS_H
+#define CLM_DISPATCH_KERNELS_H
+
+// Kernel bodies shared by the clm_dispatch_<isa>.cpp sources (clm_dispatch.cpp only needs
+// the table getters); not meant to be included anywhere else. Each of those translation units is compiled with different instruction
+// set flags, so everything here lives in an anonymous namespace: if two of them emitted
+// the same external inline function, the linker could keep the AVX-512 copy for callers
+// on a CPU without it. Standard library templates are kept out for the same reason (see
+// clm_dispatch_common.h), and the packs get a separate inline namespace per instruction set.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#include "clm_dispatch.h"
+#include "clm_simd_pack.h"
+#include "clm_dispatch_common.h"
+#include "clm_dispatch_approx.h"
+#include "clm_dispatch_geometry.h"
+#include "clm_dispatch_color.h"
+
+namespace clm::math::dispatch {
+	namespace detail {
+		struct kernel_tables
+		{
+			const batch_kernel_table<float>* f32;
+			const batch_kernel_table<double>* f64;
+			const approx_kernel_table* approx;
+			const geometry_kernel_table* geometry;
+			const rect_kernel_table* rect;
+			const color_kernel_table* color;
+		};
+
+		// Each returns null tables when its source was built without the flags it needs.
+		kernel_tables scalar_tables() noexcept;
+		kernel_tables sse2_tables() noexcept;
+		kernel_tables avx_tables() noexcept;
+		kernel_tables avx2_tables() noexcept;
+		kernel_tables avx512_tables() noexcept;
+	}
+
+	namespace {
+		// Same interface as simd::scalar_pack, but with internal linkage for the loop tails.
+		template<typename T>
+		struct lane
+		{
+			using reg_t = T;
+			static constexpr size_t width = 1;
+
+			static reg_t load(const T* ptr) noexcept { return *ptr; }
+			static void store(T* ptr, reg_t val) noexcept { *ptr = val; }
+			static reg_t set1(T val) noexcept { return val; }
+			static reg_t zero() noexcept { return T{}; }
+			static reg_t add(reg_t lhs, reg_t rhs) noexcept { return lhs + rhs; }
+			static reg_t sub(reg_t lhs, reg_t rhs) noexcept
+			{
+				// Integer lanes wrap like the vector instructions do.
+				if constexpr (std::is_integral_v<T>)
+				{
+					return static_cast<T>(static_cast<std::make_unsigned_t<T>>(lhs) - static_cast<std::make_unsigned_t<T>>(rhs));
+				}
+				else
+				{
+					return lhs - rhs;
+				}
+			}
+			static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return lhs * rhs; }
+			static reg_t div(reg_t lhs, reg_t rhs) noexcept { return lhs / rhs; }
+			static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return a * b + c; }
+			static reg_t sqrt(reg_t val) noexcept { return libm_sqrt(val); }
+
+			using mask_t = bool;
+
+			static reg_t min(reg_t lhs, reg_t rhs) noexcept { return rhs < lhs ? rhs : lhs; }
+			static reg_t max(reg_t lhs, reg_t rhs) noexcept { return lhs < rhs ? rhs : lhs; }
+			static mask_t cmp_le(reg_t lhs, reg_t rhs) noexcept { return lhs <= rhs; }
+			static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return lhs >= rhs; }
+			static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return lhs < rhs; }
+			static mask_t cmp_gt(reg_t lhs, reg_t rhs) noexcept { return lhs > rhs; }
+			static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept { return mask ? ifTrue : ifFalse; }
+			static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return lhs && rhs; }
+			static mask_t mask_or(mask_t lhs, mask_t rhs) noexcept { return lhs || rhs; }
+			static mask_t mask_and_not(mask_t mask, mask_t excluded) noexcept { return mask && !excluded; }
+			static std::uint32_t bits(mask_t mask) noexcept { return mask ? 1u : 0u; }
+			static void store_product_u64(std::uint64_t* out, reg_t lhs, reg_t rhs) noexcept
+			{
+				*out = std::uint64_t{static_cast<std::uint32_t>(lhs)} * static_cast<std::uint32_t>(rhs);
+			}
+		};
+
+		// Turns the runtime dim into a template argument so the component loops unroll.
+		template<typename Fn>
+		void with_dim(size_t dim, Fn&& fn) noexcept
+		{
+			switch (dim)
+			{
+			case 1: fn.template operator()<1>(); break;
+			case 2: fn.template operator()<2>(); break;
+			case 3: fn.template operator()<3>(); break;
+			case 4: fn.template operator()<4>(); break;
+			default: break;
+			}
+		}
+
+		template<typename T, typename wide_t>
+		struct kernels
+		{
+			template<typename Kernel>
+			static void run(size_t count, Kernel&& kernel) noexcept
+			{
+				simd::for_each_pack_as<wide_t, lane<T>>(count, std::forward<Kernel>(kernel));
+			}
+
+			static void add(const T* lhs, const T* rhs, T* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					P::store(out + i, P::add(P::load(lhs + i), P::load(rhs + i)));
+				});
+			}
+
+			static void sub(const T* lhs, const T* rhs, T* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					P::store(out + i, P::sub(P::load(lhs + i), P::load(rhs + i)));
+				});
+			}
+
+			static void scale(const T* in, T factor, T* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					P::store(out + i, P::mul(P::load(in + i), P::set1(factor)));
+				});
+			}
+
+			static void sqrt(const T* in, T* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					P::store(out + i, P::sqrt(P::load(in + i)));
+				});
+			}
+
+			static void dot(const T* const* lhs, const T* const* rhs, size_t dim, T* out, size_t count) noexcept
+			{
+				with_dim(dim, [=]<size_t d>() {
+					run(count, [=]<typename P>(size_t i) {
+						auto sum = P::zero();
+						for (size_t axis = 0; axis < d; axis++)
+						{
+							sum = P::fmadd(P::load(lhs[axis] + i), P::load(rhs[axis] + i), sum);
+						}
+						P::store(out + i, sum);
+					});
+				});
+			}
+
+			static void length(const T* const* in, size_t dim, T* out, size_t count) noexcept
+			{
+				with_dim(dim, [=]<size_t d>() {
+					run(count, [=]<typename P>(size_t i) {
+						auto sum = P::zero();
+						for (size_t axis = 0; axis < d; axis++)
+						{
+							auto c = P::load(in[axis] + i);
+							sum = P::fmadd(c, c, sum);
+						}
+						P::store(out + i, P::sqrt(sum));
+					});
+				});
+			}
+
+			static void normalize(const T* const* in, T* const* out, size_t dim, size_t count) noexcept
+			{
+				with_dim(dim, [=]<size_t d>() {
+					run(count, [=]<typename P>(size_t i) {
+						typename P::reg_t comps[d];
+						auto sum = P::zero();
+						for (size_t axis = 0; axis < d; axis++)
+						{
+							comps[axis] = P::load(in[axis] + i);
+							sum = P::fmadd(comps[axis], comps[axis], sum);
+						}
+						auto len = P::sqrt(sum);
+						for (size_t axis = 0; axis < d; axis++)
+						{
+							P::store(out[axis] + i, P::div(comps[axis], len));
+						}
+					});
+				});
+			}
+
+			static void cross(const T* const* lhs, const T* const* rhs, T* const* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					auto ax = P::load(lhs[0] + i);
+					auto ay = P::load(lhs[1] + i);
+					auto az = P::load(lhs[2] + i);
+					auto bx = P::load(rhs[0] + i);
+					auto by = P::load(rhs[1] + i);
+					auto bz = P::load(rhs[2] + i);
+					P::store(out[0] + i, P::sub(P::mul(ay, bz), P::mul(az, by)));
+					P::store(out[1] + i, P::sub(P::mul(az, bx), P::mul(ax, bz)));
+					P::store(out[2] + i, P::sub(P::mul(ax, by), P::mul(ay, bx)));
+				});
+			}
+
+			static void transform_points(const T* mat, const T* const* in, T* const* out, size_t count) noexcept
+			{
+				run(count, [=]<typename P>(size_t i) {
+					auto x = P::load(in[0] + i);
+					auto y = P::load(in[1] + i);
+					auto z = P::load(in[2] + i);
+					typename P::reg_t rows[3];
+					for (size_t row = 0; row < 3; row++)
+					{
+						const T* m = mat + row * 4;
+						auto sum = P::set1(m[3]);
+						sum = P::fmadd(x, P::set1(m[0]), sum);
+						sum = P::fmadd(y, P::set1(m[1]), sum);
+						rows[row] = P::fmadd(z, P::set1(m[2]), sum);
+					}
+					// Stored after all three rows so out may alias in.
+					for (size_t row = 0; row < 3; row++)
+					{
+						P::store(out[row] + i, rows[row]);
+					}
+				});
+			}
+
+			static constexpr batch_kernel_table<T> table(util::simd_level level) noexcept
+			{
+				return batch_kernel_table<T>{level, &add, &sub, &scale, &sqrt, &dot, &length, &normalize, &cross, &transform_points};
+			}
+		};
+
+		// The scalar source has no int lanes to build approximations on and uses libm.
+		template<typename wide_t>
+		using approx_impl = std::conditional_t<std::is_same_v<wide_t, lane<float>>, libm_kernels, approx_kernels<wide_t>>;
+		template<typename wide_t>
+		using color_impl = std::conditional_t<std::is_same_v<wide_t, lane<float>>, libm_pixel_kernels, pixel_kernels<wide_t>>;
+	}
+}
+
+// Defines detail::<isa>_tables() for one instruction set source. wide_pack is the pack
+// template to build the kernels on; loop tails always use lane.
+#define CLM_DEFINE_KERNEL_TABLES(isa, level, wide_pack) \
+	namespace clm::math::dispatch::detail { \
+		kernel_tables isa##_tables() noexcept \
+		{ \
+			static constexpr batch_kernel_table<float> f32 = kernels<float, wide_pack<float>>::table(level); \
+			static constexpr batch_kernel_table<double> f64 = kernels<double, wide_pack<double>>::table(level); \
+			static constexpr approx_kernel_table approx = approx_impl<wide_pack<float>>::table(level); \
+			static constexpr geometry_kernel_table geometry = segment_kernels<wide_pack<double>, lane<double>>::table(level); \
+			static constexpr rect_kernel_table rect = rect_batch_kernels<wide_pack<std::int32_t>, lane<std::int32_t>>::table(level); \
+			static constexpr color_kernel_table color = color_impl<wide_pack<float>>::table(level); \
+			return kernel_tables{&f32, &f64, &approx, &geometry, &rect, &color}; \
+		} \
+	}
+
+// For a source built without the flags its instruction set needs.
+#define CLM_DEFINE_EMPTY_KERNEL_TABLES(isa) \
+	namespace clm::math::dispatch::detail { \
+		kernel_tables isa##_tables() noexcept \
+		{ \
+			return kernel_tables{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}; \
+		} \
+	}
+
+#endif
\ No newline at end of file
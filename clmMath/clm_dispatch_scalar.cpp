@@ -0,0 +1,4 @@
+#include "clm_dispatch_kernels.h"
+
+// Plain loops, the fallback when nothing else is usable. Built with the default flags.
+CLM_DEFINE_KERNEL_TABLES(scalar, util::simd_level::scalar, lane)
\ No newline at end of file
@@ -0,0 +1,8 @@
+#include "clm_dispatch_kernels.h"
+
+// Built with the default flags, SSE2 being the x86-64 baseline.
+#if defined(CLM_SIMD_SSE)
+CLM_DEFINE_KERNEL_TABLES(sse2, util::simd_level::sse2, simd::sse_pack)
+#else
+CLM_DEFINE_EMPTY_KERNEL_TABLES(sse2)
+#endif
\ No newline at end of file
@@ -0,0 +1,396 @@
+#ifndef CLM_DYN_MATRIX_H
+#define CLM_DYN_MATRIX_H
+
+#include <vector>
+#include <cassert>
+#include <concepts>
+#include <algorithm>
+#include <utility>
+
+#include <clmUtil/clm_aligned_alloc.h>
+#include <clmUtil/clm_parallel.h>
+
+#include "clm_matrix.h"
+#include "clm_simd_pack.h"
+
+namespace clm::math {
+	// Heap-allocated, runtime-sized matrix for sizes where Matrix<dim, T> is impractical.
+	// Storage is row-major; every row starts on a 64-byte boundary and is padded with zeros
+	// out to stride() elements.
+	template<std::floating_point T>
+	class DynMatrix
+	{
+	public:
+		using storage_t = std::vector<T, util::aligned_allocator<T>>;
+
+		DynMatrix() = default;
+		DynMatrix(size_t rows, size_t cols, T fill = T{})
+			:
+			m_rows(rows), m_cols(cols), m_stride(padded_stride(cols)), m_data(rows * padded_stride(cols), T{})
+		{
+			if (fill != T{})
+			{
+				for (size_t i = 0; i < m_rows; i++)
+				{
+					std::fill_n(row(i), m_cols, fill);
+				}
+			}
+		}
+		template<size_t dim>
+		explicit DynMatrix(const Matrix<dim, T>& mat)
+			:
+			DynMatrix(dim, dim)
+		{
+			set_block(0, 0, mat);
+		}
+		~DynMatrix() = default;
+		DynMatrix(const DynMatrix&) = default;
+		DynMatrix(DynMatrix&&) noexcept = default;
+		DynMatrix& operator=(const DynMatrix&) = default;
+		DynMatrix& operator=(DynMatrix&&) noexcept = default;
+
+		static DynMatrix identity(size_t dim)
+		{
+			DynMatrix ident{dim, dim};
+			for (size_t i = 0; i < dim; i++)
+			{
+				ident(i, i) = static_cast<T>(1);
+			}
+			return ident;
+		}
+
+		size_t rows() const noexcept { return m_rows; }
+		size_t cols() const noexcept { return m_cols; }
+		size_t stride() const noexcept { return m_stride; }
+		T* data() noexcept { return m_data.data(); }
+		const T* data() const noexcept { return m_data.data(); }
+		T* row(size_t index) noexcept { return m_data.data() + index * m_stride; }
+		const T* row(size_t index) const noexcept { return m_data.data() + index * m_stride; }
+
+		T& operator()(size_t rowIndex, size_t colIndex) noexcept
+		{
+			assert(rowIndex < m_rows && colIndex < m_cols);
+			return m_data[rowIndex * m_stride + colIndex];
+		}
+		const T& operator()(size_t rowIndex, size_t colIndex) const noexcept
+		{
+			assert(rowIndex < m_rows && colIndex < m_cols);
+			return m_data[rowIndex * m_stride + colIndex];
+		}
+
+		// Copies the dim x dim block whose top-left corner is (rowIndex, colIndex).
+		template<size_t dim>
+		Matrix<dim, T> block(size_t rowIndex, size_t colIndex) const noexcept
+		{
+			assert(rowIndex + dim <= m_rows && colIndex + dim <= m_cols);
+			Matrix<dim, T> out{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				std::copy_n(row(rowIndex + i) + colIndex, dim, out[i].data());
+			}
+			return out;
+		}
+		template<size_t dim>
+		void set_block(size_t rowIndex, size_t colIndex, const Matrix<dim, T>& mat) noexcept
+		{
+			assert(rowIndex + dim <= m_rows && colIndex + dim <= m_cols);
+			for (size_t i = 0; i < dim; i++)
+			{
+				std::copy_n(mat[i].data(), dim, row(rowIndex + i) + colIndex);
+			}
+		}
+
+		DynMatrix transpose() const
+		{
+			constexpr size_t tile = 32;
+			DynMatrix out{m_cols, m_rows};
+			const size_t rowTiles = (m_rows + tile - 1) / tile;
+			util::parallel_for(rowTiles, [&](size_t rowTile) {
+				const size_t iEnd = std::min(m_rows, (rowTile + 1) * tile);
+				for (size_t jb = 0; jb < m_cols; jb += tile)
+				{
+					const size_t jEnd = std::min(m_cols, jb + tile);
+					for (size_t i = rowTile * tile; i < iEnd; i++)
+					{
+						const T* src = row(i);
+						for (size_t j = jb; j < jEnd; j++)
+						{
+							out.row(j)[i] = src[j];
+						}
+					}
+				}
+			}, 1, m_rows * m_cols < parallel_threshold ? 1 : 0);
+			return out;
+		}
+
+		DynMatrix& operator+=(const DynMatrix& rhs) noexcept
+		{
+			assert(m_rows == rhs.m_rows && m_cols == rhs.m_cols);
+			for (size_t i = 0; i < m_rows; i++)
+			{
+				T* dst = row(i);
+				const T* src = rhs.row(i);
+				simd::for_each_pack<T>(m_cols, [=]<typename P>(size_t j) {
+					P::store(dst + j, P::add(P::load(dst + j), P::load(src + j)));
+				});
+			}
+			return *this;
+		}
+		DynMatrix& operator-=(const DynMatrix& rhs) noexcept
+		{
+			assert(m_rows == rhs.m_rows && m_cols == rhs.m_cols);
+			for (size_t i = 0; i < m_rows; i++)
+			{
+				T* dst = row(i);
+				const T* src = rhs.row(i);
+				simd::for_each_pack<T>(m_cols, [=]<typename P>(size_t j) {
+					P::store(dst + j, P::sub(P::load(dst + j), P::load(src + j)));
+				});
+			}
+			return *this;
+		}
+		DynMatrix& operator*=(T factor) noexcept
+		{
+			for (size_t i = 0; i < m_rows; i++)
+			{
+				T* dst = row(i);
+				simd::for_each_pack<T>(m_cols, [=]<typename P>(size_t j) {
+					P::store(dst + j, P::mul(P::load(dst + j), P::set1(factor)));
+				});
+			}
+			return *this;
+		}
+
+		DynMatrix operator+(const DynMatrix& rhs) const
+		{
+			DynMatrix sum{*this};
+			return sum += rhs;
+		}
+		DynMatrix operator-(const DynMatrix& rhs) const
+		{
+			DynMatrix diff{*this};
+			return diff -= rhs;
+		}
+		DynMatrix operator*(T factor) const
+		{
+			DynMatrix scaled{*this};
+			return scaled *= factor;
+		}
+		friend DynMatrix operator*(T factor, const DynMatrix& rhs)
+		{
+			return rhs * factor;
+		}
+		DynMatrix operator*(const DynMatrix& rhs) const;
+
+		// Below this many elements an operation stays on the calling thread.
+		static constexpr size_t parallel_threshold = 64 * 64;
+	private:
+		static constexpr size_t padded_stride(size_t cols) noexcept
+		{
+			constexpr size_t lineElems = 64 / sizeof(T);
+			return (cols + lineElems - 1) / lineElems * lineElems;
+		}
+
+		size_t m_rows = 0;
+		size_t m_cols = 0;
+		size_t m_stride = 0;
+		storage_t m_data{};
+	};
+
+	using DynMatrixf = DynMatrix<float>;
+	using DynMatrixd = DynMatrix<double>;
+
+	namespace gemm_detail {
+		// Goto/BLIS style blocking: a kc x nc slab of B is packed into nr-wide column panels
+		// that stay in L1/L2, each thread packs an mc x kc block of A into mr-high row panels,
+		// and the micro-kernel keeps an mr x nr tile of C in 2 * mr registers.
+		template<typename T>
+		struct blocking
+		{
+			using pack_t = simd::pack<T>;
+			static constexpr size_t mr = 6;
+			static constexpr size_t nr = 2 * pack_t::width;
+			static constexpr size_t kc = 256;
+			static constexpr size_t mc = 12 * mr;
+			static constexpr size_t nc = 4096 / nr * nr;
+		};
+
+		template<typename T>
+		void pack_b(const DynMatrix<T>& b, size_t pc, size_t kb, size_t jc, size_t nb, size_t panel, T* out) noexcept
+		{
+			constexpr size_t nr = blocking<T>::nr;
+			const size_t j0 = jc + panel * nr;
+			const size_t valid = std::min(nr, jc + nb - j0);
+			for (size_t k = 0; k < kb; k++)
+			{
+				const T* src = b.row(pc + k) + j0;
+				T* dst = out + k * nr;
+				for (size_t j = 0; j < valid; j++)
+				{
+					dst[j] = src[j];
+				}
+				for (size_t j = valid; j < nr; j++)
+				{
+					dst[j] = T{};
+				}
+			}
+		}
+
+		template<typename T>
+		void pack_a(const DynMatrix<T>& a, size_t ic, size_t mb, size_t pc, size_t kb, T* out) noexcept
+		{
+			constexpr size_t mr = blocking<T>::mr;
+			for (size_t ir = 0; ir < mb; ir += mr)
+			{
+				const size_t valid = std::min(mr, mb - ir);
+				T* panel = out + ir * kb;
+				for (size_t r = 0; r < mr; r++)
+				{
+					if (r < valid)
+					{
+						const T* src = a.row(ic + ir + r) + pc;
+						for (size_t k = 0; k < kb; k++)
+						{
+							panel[k * mr + r] = src[k];
+						}
+					}
+					else
+					{
+						for (size_t k = 0; k < kb; k++)
+						{
+							panel[k * mr + r] = T{};
+						}
+					}
+				}
+			}
+		}
+
+		// c[0..mValid) x [0..nValid) += ap * bp over kb steps. ldc is C's row stride.
+		template<typename T>
+		void micro_kernel(size_t kb, const T* ap, const T* bp, T* c, size_t ldc, size_t mValid, size_t nValid) noexcept
+		{
+			using P = simd::pack<T>;
+			constexpr size_t mr = blocking<T>::mr;
+			constexpr size_t nr = blocking<T>::nr;
+			constexpr size_t w = P::width;
+
+			typename P::reg_t acc[mr][2];
+			for (size_t r = 0; r < mr; r++)
+			{
+				acc[r][0] = P::zero();
+				acc[r][1] = P::zero();
+			}
+			// The row loop is unrolled by hand so every accumulator gets a fixed register
+			// even at optimization levels that would not unroll it.
+			[&]<size_t...rs>(std::index_sequence<rs...>) {
+				for (size_t k = 0; k < kb; k++)
+				{
+					const auto b0 = P::load(bp);
+					const auto b1 = P::load(bp + w);
+					((acc[rs][0] = P::fmadd(P::set1(ap[rs]), b0, acc[rs][0]),
+					  acc[rs][1] = P::fmadd(P::set1(ap[rs]), b1, acc[rs][1])), ...);
+					ap += mr;
+					bp += nr;
+				}
+			}(std::make_index_sequence<mr>{});
+
+			if (mValid == mr && nValid == nr)
+			{
+				for (size_t r = 0; r < mr; r++)
+				{
+					T* dst = c + r * ldc;
+					P::store(dst, P::add(P::load(dst), acc[r][0]));
+					P::store(dst + w, P::add(P::load(dst + w), acc[r][1]));
+				}
+			}
+			else
+			{
+				alignas(64) T tile[mr * nr];
+				for (size_t r = 0; r < mr; r++)
+				{
+					P::store(tile + r * nr, acc[r][0]);
+					P::store(tile + r * nr + w, acc[r][1]);
+				}
+				for (size_t r = 0; r < mValid; r++)
+				{
+					for (size_t j = 0; j < nValid; j++)
+					{
+						c[r * ldc + j] += tile[r * nr + j];
+					}
+				}
+			}
+		}
+	}
+
+	// out = lhs * rhs. Row blocks of the product are spread across worker threads; products
+	// smaller than about 64^3 multiply-adds run on the calling thread.
+	template<std::floating_point T>
+	void gemm(const DynMatrix<T>& lhs, const DynMatrix<T>& rhs, DynMatrix<T>& out)
+	{
+		assert(lhs.cols() == rhs.rows());
+		if (&out == &lhs || &out == &rhs)
+		{
+			DynMatrix<T> tmp{};
+			gemm(lhs, rhs, tmp);
+			out = std::move(tmp);
+			return;
+		}
+
+		using block_t = gemm_detail::blocking<T>;
+		const size_t m = lhs.rows();
+		const size_t n = rhs.cols();
+		const size_t k = lhs.cols();
+		out = DynMatrix<T>{m, n};
+		if (m == 0 || n == 0 || k == 0)
+		{
+			return;
+		}
+		const size_t maxThreads = (m * n * k < 64 * 64 * 64) ? 1 : 0;
+
+		typename DynMatrix<T>::storage_t packedB(std::min(n, block_t::nc) / block_t::nr * block_t::nr * block_t::kc + block_t::nr * block_t::kc);
+		for (size_t jc = 0; jc < n; jc += block_t::nc)
+		{
+			const size_t nb = std::min(block_t::nc, n - jc);
+			const size_t nPanels = (nb + block_t::nr - 1) / block_t::nr;
+			for (size_t pc = 0; pc < k; pc += block_t::kc)
+			{
+				const size_t kb = std::min(block_t::kc, k - pc);
+				util::parallel_for(nPanels, [&](size_t panel) {
+					gemm_detail::pack_b(rhs, pc, kb, jc, nb, panel, packedB.data() + panel * block_t::nr * kb);
+				}, 8, maxThreads);
+
+				const size_t mBlocks = (m + block_t::mc - 1) / block_t::mc;
+				util::parallel_for(mBlocks, [&](size_t mBlock) {
+					thread_local typename DynMatrix<T>::storage_t packedA{};
+					packedA.resize(block_t::mc * block_t::kc);
+
+					const size_t ic = mBlock * block_t::mc;
+					const size_t mb = std::min(block_t::mc, m - ic);
+					gemm_detail::pack_a(lhs, ic, mb, pc, kb, packedA.data());
+					for (size_t panel = 0; panel < nPanels; panel++)
+					{
+						const size_t jr = panel * block_t::nr;
+						const size_t nValid = std::min(block_t::nr, nb - jr);
+						const T* bp = packedB.data() + panel * block_t::nr * kb;
+						for (size_t ir = 0; ir < mb; ir += block_t::mr)
+						{
+							gemm_detail::micro_kernel(kb, packedA.data() + ir * kb, bp,
+													  out.row(ic + ir) + jc + jr, out.stride(),
+													  std::min(block_t::mr, mb - ir), nValid);
+						}
+					}
+				}, 1, maxThreads);
+			}
+		}
+	}
+
+	template<std::floating_point T>
+	DynMatrix<T> DynMatrix<T>::operator*(const DynMatrix& rhs) const
+	{
+		DynMatrix product{};
+		gemm(*this, rhs, product);
+		return product;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -3,9 +3,15 @@
 
 #include <stdexcept>
 #include <cstdlib>
+#include <cstdint>
 #include <bit>
 #include <numbers>
 #include <concepts>
+#include <cmath>
+#include <limits>
+#include <array>
+#include <algorithm>
+#include <type_traits>
 
 namespace clm::math {
 	extern constexpr float abs(float val) noexcept
@@ -32,8 +38,10 @@ namespace clm::math {
 		}
 	}
 
-	static constexpr float DEFAULT_FLOAT_THRESHOLD = 0.0001f;
-	static constexpr double DEFAULT_DOUBLE_THRESHOLD = 0.000001;
+	// Relative to the estimate, so the same threshold means the same thing for 1e-30 and
+	// 1e30. 0 iterates until the estimate stops improving.
+	static constexpr float DEFAULT_FLOAT_THRESHOLD = 0.0f;
+	static constexpr double DEFAULT_DOUBLE_THRESHOLD = 0.0;
 
 	extern constexpr float sqrt_ce(float val, float threshold = DEFAULT_FLOAT_THRESHOLD) noexcept;
 	extern constexpr double sqrt_ce(double val, double threshold = DEFAULT_DOUBLE_THRESHOLD) noexcept;
@@ -53,30 +61,10 @@ namespace clm::math {
 		size_t iterationCount;
 	};*/
 
+	// Computed in double and rounded once, which makes it correctly rounded in practice.
 	extern constexpr float sqrt_ce(float val, float threshold) noexcept
 	{
-		if (val < 0.0f) {
-			return NAN;
-		}
-		std::uint32_t valConv = std::bit_cast<std::uint32_t>(val);
-		//constexpr std::uint32_t expMask = 0x7F800000u;
-		std::uint32_t exp = valConv >> 23;
-		exp >>= 1;
-		exp += 63;
-
-		constexpr std::uint32_t manMask = 0x007FFFFFu;
-		std::uint32_t mantissa = valConv & manMask;
-		mantissa = (1 << 22) | (mantissa >> 1);
-
-		valConv = (exp << 23) | mantissa;
-		float previous = std::bit_cast<float>(valConv);
-		float current = previous;
-		do {
-			previous = val / current;
-			current = 0.5f * (current + previous);
-		} while (abs(current - previous) > threshold);
-
-		return current;
+		return static_cast<float>(sqrt_ce(static_cast<double>(val), static_cast<double>(threshold)));
 	}
 
 	/*extern constexpr float sqrt_no_priming(float val, float threshold = 0.0001f)
@@ -93,11 +81,152 @@ namespace clm::math {
 	}*/
 
 	static constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+	namespace detail {
+		constexpr double infinity = std::numeric_limits<double>::infinity();
+
+		constexpr bool is_nan(double x) noexcept
+		{
+			return x != x;
+		}
+
+		constexpr bool is_inf(double x) noexcept
+		{
+			return x == infinity || x == -infinity;
+		}
+
+		constexpr bool sign_bit(double x) noexcept
+		{
+			return (std::bit_cast<std::uint64_t>(x) >> 63) != 0;
+		}
+
+		// Nearest integer, ties away from zero. |x| must fit in an int64.
+		constexpr double round_int(double x) noexcept
+		{
+			return static_cast<double>(static_cast<std::int64_t>(x < 0.0 ? x - 0.5 : x + 0.5));
+		}
+
+		constexpr bool is_integer(double x) noexcept
+		{
+			return abs(x) >= 0x1p52 || static_cast<double>(static_cast<std::int64_t>(x)) == x;
+		}
+
+		constexpr bool is_odd_integer(double x) noexcept
+		{
+			return abs(x) < 0x1p53 && is_integer(x) && (static_cast<std::int64_t>(x) & 1) != 0;
+		}
+
+		// x * 2^n with a single rounding, like std::scalbn.
+		constexpr double scale2(double x, int n) noexcept
+		{
+			if (n > 1023) {
+				x *= 0x1p1023;
+				n -= 1023;
+				if (n > 1023) {
+					x *= 0x1p1023;
+					n = std::min(n - 1023, 1023);
+				}
+			}
+			else if (n < -1022) {
+				// 2^-969 = 2^-1022 * 2^53 leaves room so only the last multiply rounds.
+				x *= 0x1p-969;
+				n += 969;
+				if (n < -1022) {
+					x *= 0x1p-969;
+					n = std::max(n + 969, -1022);
+				}
+			}
+			return x * std::bit_cast<double>(static_cast<std::uint64_t>(0x3FF + n) << 52);
+		}
+
+		// Unevaluated sum hi + lo, good for about 106 bits. Only the constant evaluated paths
+		// use it, where the extra precision is what keeps pow and the argument reductions
+		// within an ULP.
+		struct dd
+		{
+			double hi;
+			double lo;
+		};
+
+		constexpr dd quick_two_sum(double a, double b) noexcept
+		{
+			const double s = a + b;
+			return {s, b - (s - a)};
+		}
+
+		constexpr dd two_sum(double a, double b) noexcept
+		{
+			const double s = a + b;
+			const double bb = s - a;
+			return {s, (a - (s - bb)) + (b - bb)};
+		}
+
+		// Dekker's product; exact as long as neither factor is near the overflow threshold.
+		constexpr dd two_prod(double a, double b) noexcept
+		{
+			constexpr double splitter = 134217729.0; // 2^27 + 1
+			const double p = a * b;
+			const double ta = splitter * a;
+			const double aHi = ta - (ta - a);
+			const double aLo = a - aHi;
+			const double tb = splitter * b;
+			const double bHi = tb - (tb - b);
+			const double bLo = b - bHi;
+			return {p, ((aHi * bHi - p) + aHi * bLo + aLo * bHi) + aLo * bLo};
+		}
+
+		constexpr dd operator-(dd a) noexcept
+		{
+			return {-a.hi, -a.lo};
+		}
+
+		constexpr dd operator+(dd a, dd b) noexcept
+		{
+			dd s = two_sum(a.hi, b.hi);
+			const dd t = two_sum(a.lo, b.lo);
+			s.lo += t.hi;
+			s = quick_two_sum(s.hi, s.lo);
+			s.lo += t.lo;
+			return quick_two_sum(s.hi, s.lo);
+		}
+
+		constexpr dd operator-(dd a, dd b) noexcept
+		{
+			return a + -b;
+		}
+
+		constexpr dd operator*(dd a, dd b) noexcept
+		{
+			dd p = two_prod(a.hi, b.hi);
+			p.lo += a.hi * b.lo + a.lo * b.hi;
+			return quick_two_sum(p.hi, p.lo);
+		}
+
+		constexpr dd operator/(dd a, dd b) noexcept
+		{
+			const double q1 = a.hi / b.hi;
+			const dd r = a - b * dd{q1, 0.0};
+			return quick_two_sum(q1, r.hi / b.hi);
+		}
+	}
+
 	extern constexpr double sqrt_ce(double val, double threshold) noexcept
 	{
-		if (val < 0.0f) {
-			return NaN;
+		// NaN, zeros (keeping their sign), negatives and inf.
+		if (!(val > 0.0) || detail::is_inf(val)) {
+			return val < 0.0 ? NaN : val;
+		}
+		// Bring val into [0.5, 4) by an even power of two, undone exactly at the end. This
+		// covers denormals and keeps the residual below clear of underflow.
+		int halfExp = 0;
+		if (val < 0x1p-1022) {
+			val *= 0x1p54;
+			halfExp = -27;
 		}
+		const int valExp = static_cast<int>(std::bit_cast<std::uint64_t>(val) >> 52) - 1023;
+		halfExp += valExp / 2;
+		val = detail::scale2(val, -2 * (valExp / 2));
+
 		std::uint64_t valConv = std::bit_cast<std::uint64_t>(val);
 		//std::uint64_t expMask = 0x7FF0'0000'0000'0000u;
 		std::uint64_t exp = valConv >> 52;
@@ -109,14 +238,30 @@ namespace clm::math {
 		mantissa = (1ull << 51) | (mantissa >> 1);
 
 		valConv = (exp << 52) | mantissa;
-		double previous = std::bit_cast<double>(valConv);
-		double current = previous;
-		do {
-			previous = val / current;
-			current = 0.5 * (current + previous);
-		} while (abs(current - previous) > threshold);
+		double current = std::bit_cast<double>(valConv);
 
-		return current;
+		// After one Newton step the estimate is at or above the root and decreases from
+		// there, so the loop stops when it no longer does, or when the relative step drops
+		// under the threshold.
+		current = 0.5 * (current + val / current);
+		for (int i = 0; i < 64; i++) {
+			const double next = 0.5 * (current + val / current);
+			if (next >= current) {
+				break;
+			}
+			const bool converged = current - next <= threshold * next;
+			current = next;
+			if (converged) {
+				break;
+			}
+		}
+
+		// One correction against the exact residual val - current^2 settles the last ulp.
+		if (threshold == 0.0) {
+			const detail::dd square = detail::two_prod(current, current);
+			current += ((val - square.hi) - square.lo) / (2.0 * current);
+		}
+		return detail::scale2(current, halfExp);
 	}
 
 	template<std::floating_point T>
@@ -140,9 +285,11 @@ namespace clm::math {
 	}
 
 	constexpr std::uint32_t lzcnt_ce(std::uint32_t val) noexcept;
+	// std::countl_zero compiles to lzcnt where the target has it and to bsr otherwise, so
+	// unlike a bare __lzcnt it never relies on an instruction the CPU might lack.
 	constexpr std::uint32_t lzcnt(std::uint32_t val) noexcept
 	{
-		return std::is_constant_evaluated() ? lzcnt_ce(val) : __lzcnt(val);
+		return static_cast<std::uint32_t>(std::countl_zero(val));
 	}
 
 	constexpr std::uint32_t lzcnt_ce(std::uint32_t val) noexcept
@@ -154,6 +301,502 @@ namespace clm::math {
 		}
 		return 32u - count;
 	}
+
+	namespace detail {
+		constexpr dd pi{3.141592653589793, 1.2246467991473532e-16};
+		constexpr dd halfPi{1.5707963267948966, 6.123233995736766e-17};
+		constexpr dd ln2{0.6931471805599453, 2.3190468138462996e-17};
+
+		// pi/2 in four parts. The first three have 33 significant bits, so their products
+		// with any quadrant count below 2^20 are exact.
+		constexpr double halfPiParts[4]{
+			1.5707963267341256, 6.077100506303966e-11, 2.0222662487111665e-21, 8.4784276603689e-32
+		};
+
+		// The first 1280 bits of 2/pi, most significant word first.
+		constexpr std::uint32_t twoOverPi[40]{
+			0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0, 0xDB629599, 0x3C439041, 0xFE5163AB, 0xDEBBC561,
+			0xB7246E3A, 0x424DD2E0, 0x06492EEA, 0x09D1921C, 0xFE1DEB1C, 0xB129A73E, 0xE88235F5, 0x2EBB4484,
+			0xE99C7026, 0xB45F7E41, 0x3991D639, 0x835339F4, 0x9C845F8B, 0xBDF9283B, 0x1FF897FF, 0xDE05980F,
+			0xEF2F118B, 0x5A0A6D1F, 0x6D367ECF, 0x27CB09B7, 0x4F463F66, 0x9E5FEA2D, 0x7527BAC7, 0xEBE5F17B,
+			0x3D0739F7, 0x8A5292EA, 0x6BFB5FB1, 0x1F8D5D08, 0x56033046, 0xFC7B6BAB, 0xF0CFBC20, 0x9AF4361D
+		};
+
+		// x = quadrant * pi/2 + y (mod 2pi), |y| <= pi/4.
+		struct reduced_angle
+		{
+			dd y;
+			unsigned quadrant;
+		};
+
+		// Payne-Hanek reduction for x >= 2^20. x * 2/pi is formed exactly from the 256 bits
+		// of 2/pi that can affect its value mod 4, which leaves more than 100 bits below the
+		// binary point even for the doubles closest to a multiple of pi/2.
+		constexpr reduced_angle reduce_large(double x) noexcept
+		{
+			const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+			const int exponent = static_cast<int>(bits >> 52) - 1075;
+			const std::uint64_t mantissa = (bits & 0x000F'FFFF'FFFF'FFFFull) | 0x0010'0000'0000'0000ull;
+			// Words before this one only add multiples of 4 to the product.
+			const int first = exponent >= 2 ? (exponent - 2) / 32 : 0;
+
+			std::array<std::uint32_t, 10> prod{};
+			const std::uint64_t mantissaLimbs[2]{mantissa & 0xFFFF'FFFFull, mantissa >> 32};
+			for (int i = 0; i < 8; i++) {
+				const std::uint64_t word = twoOverPi[first + 7 - i];
+				std::uint64_t carry = 0;
+				for (int j = 0; j < 2; j++) {
+					const std::uint64_t t = word * mantissaLimbs[j] + prod[i + j] + carry;
+					prod[i + j] = static_cast<std::uint32_t>(t);
+					carry = t >> 32;
+				}
+				prod[i + 2] = static_cast<std::uint32_t>(carry);
+			}
+
+			const auto bit = [&prod](int index) -> std::uint64_t {
+				return index < 0 ? 0 : (prod[index / 32] >> (index % 32)) & 1u;
+			};
+			// Bit index of the units place of the product.
+			const int point = 32 * (first + 8) - exponent;
+			unsigned quadrant = static_cast<unsigned>(bit(point) | (bit(point + 1) << 1));
+			const bool negative = bit(point - 1) != 0;
+			if (negative) {
+				// Fraction of at least 1/2: move to the next quadrant and take 1 - fraction,
+				// which is the two's complement of the bits below the point.
+				quadrant++;
+				std::uint64_t carry = 1;
+				for (std::uint32_t& limb : prod) {
+					const std::uint64_t t = static_cast<std::uint64_t>(~limb) + carry;
+					limb = static_cast<std::uint32_t>(t);
+					carry = t >> 32;
+				}
+			}
+
+			int top = point - 1;
+			while (top >= 0 && bit(top) == 0) {
+				top--;
+			}
+			if (top < 0) {
+				return {{0.0, 0.0}, quadrant & 3u};
+			}
+			const auto chunk = [&bit](int high) {
+				std::uint64_t value = 0;
+				for (int i = high; i > high - 53; i--) {
+					value = (value << 1) | bit(i);
+				}
+				return static_cast<double>(value);
+			};
+			const dd fraction = quick_two_sum(scale2(chunk(top), top - 52 - point),
+											  scale2(chunk(top - 53), top - 105 - point));
+			const dd y = fraction * halfPi;
+			return {negative ? -y : y, quadrant & 3u};
+		}
+
+		// For x >= 0. Below 2^20 a four part Cody-Waite reduction is exact enough.
+		constexpr reduced_angle reduce_half_pi(double x) noexcept
+		{
+			if (x <= 0.7853981633974483) {
+				return {{x, 0.0}, 0u};
+			}
+			if (x >= 0x1p20) {
+				return reduce_large(x);
+			}
+			const double j = round_int(x * 0.6366197723675814);
+			dd y = two_sum(x - j * halfPiParts[0], -j * halfPiParts[1]);
+			y = y - dd{j * halfPiParts[2], 0.0};
+			y = y - dd{j * halfPiParts[3], 0.0};
+			return {y, static_cast<unsigned>(static_cast<std::int64_t>(j)) & 3u};
+		}
+
+		// sin(y.hi + y.lo) for |y| <= pi/4: x - x^3/6 * (1 - x^2/20 * (1 - x^2/42 * ...)).
+		constexpr double sin_kernel(dd y) noexcept
+		{
+			const double x = y.hi;
+			const double z = x * x;
+			double p = 1.0;
+			for (int k = 12; k >= 2; k--) {
+				p = 1.0 - z * p / ((2.0 * k) * (2.0 * k + 1.0));
+			}
+			return x + (y.lo * (1.0 - 0.5 * z) - (x * z) * p / 6.0);
+		}
+
+		// cos(y.hi + y.lo) for |y| <= pi/4: 1 - x^2/2 + x^4/24 * (1 - x^2/30 * ...), with the
+		// rounding error of 1 - x^2/2 carried into the small terms.
+		constexpr double cos_kernel(dd y) noexcept
+		{
+			const double x = y.hi;
+			const double z = x * x;
+			double q = 1.0;
+			for (int k = 12; k >= 3; k--) {
+				q = 1.0 - z * q / ((2.0 * k - 1.0) * (2.0 * k));
+			}
+			const double halfZ = 0.5 * z;
+			const double w = 1.0 - halfZ;
+			return w + (((1.0 - w) - halfZ) + (z * z * q / 24.0 - x * y.lo));
+		}
+
+		// atan(t) - t for |t| < 7/16.
+		constexpr double atan_tail(double t) noexcept
+		{
+			const double z = t * t;
+			double s = 0.0;
+			for (int k = 24; k >= 1; k--) {
+				s = (k % 2 != 0 ? -1.0 : 1.0) / (2.0 * k + 1.0) + z * s;
+			}
+			return t * z * s;
+		}
+
+		// atan(t) for t >= 0 as hi + lo. Break points at atan(1/2), atan(1), atan(3/2) and
+		// pi/2 (as in fdlibm) keep the series argument below 7/16.
+		constexpr dd atan_pos(double t) noexcept
+		{
+			constexpr dd breaks[4]{
+				{0.4636476090008061, 2.2698777452961687e-17},
+				{0.7853981633974483, 3.061616997868383e-17},
+				{0.982793723247329, 1.3903311031230998e-17},
+				{1.5707963267948966, 6.123233995736766e-17}
+			};
+			if (t < 0.4375) {
+				return {t, atan_tail(t)};
+			}
+			size_t id = 3;
+			double u = -1.0 / t;
+			if (t < 0.6875) {
+				id = 0;
+				u = (2.0 * t - 1.0) / (2.0 + t);
+			}
+			else if (t < 1.1875) {
+				id = 1;
+				u = (t - 1.0) / (t + 1.0);
+			}
+			else if (t < 2.4375) {
+				id = 2;
+				u = (t - 1.5) / (1.0 + 1.5 * t);
+			}
+			return {breaks[id].hi, breaks[id].lo + (u + atan_tail(u))};
+		}
+
+		// log(x) for finite x > 0. x = m * 2^e with m in [sqrt(1/2), sqrt(2)), and
+		// log(m) = 2 * atanh(f) = 2 * (f + f^3/3 + f^5/5 + ...) with f = (m - 1) / (m + 1).
+		constexpr dd log_dd(double x) noexcept
+		{
+			int e = 0;
+			if (x < 0x1p-1022) {
+				x *= 0x1p54;
+				e = -54;
+			}
+			const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+			e += static_cast<int>(bits >> 52) - 1023;
+			double m = std::bit_cast<double>((bits & 0x000F'FFFF'FFFF'FFFFull) | 0x3FF0'0000'0000'0000ull);
+			if (m > 1.4142135623730951) {
+				m *= 0.5;
+				e++;
+			}
+			const dd f = dd{m - 1.0, 0.0} / two_sum(m, 1.0);
+			const dd f2 = f * f;
+			// |f| < 0.172, so 21 terms reach 2^-106.
+			dd series{1.0 / 43.0, 0.0};
+			for (int k = 20; k >= 0; k--) {
+				series = dd{1.0, 0.0} / dd{2.0 * k + 1.0, 0.0} + f2 * series;
+			}
+			return dd{static_cast<double>(e), 0.0} * ln2 + dd{2.0, 0.0} * f * series;
+		}
+
+		// exp(a) rounded to double. a = k * ln2 + r, |r| <= ln2 / 2, then a Taylor series
+		// to r^22 / 22!.
+		constexpr double exp_dd(dd a) noexcept
+		{
+			if (is_nan(a.hi)) {
+				return a.hi;
+			}
+			if (a.hi > 709.8) {
+				return infinity;
+			}
+			if (a.hi < -745.2) {
+				return 0.0;
+			}
+			const double k = round_int(a.hi / ln2.hi);
+			const dd r = a - dd{k, 0.0} * ln2;
+			dd sum{1.0, 0.0};
+			for (int n = 22; n >= 1; n--) {
+				sum = dd{1.0, 0.0} + r * sum / dd{static_cast<double>(n), 0.0};
+			}
+			return scale2(sum.hi + sum.lo, static_cast<int>(k));
+		}
+
+		constexpr double sin_d(double x) noexcept
+		{
+			if (is_nan(x) || is_inf(x)) {
+				return x - x;
+			}
+			const bool negative = sign_bit(x);
+			const reduced_angle r = reduce_half_pi(negative ? -x : x);
+			double result = (r.quadrant & 1u) != 0 ? cos_kernel(r.y) : sin_kernel(r.y);
+			if ((r.quadrant & 2u) != 0) {
+				result = -result;
+			}
+			return negative ? -result : result;
+		}
+
+		constexpr double cos_d(double x) noexcept
+		{
+			if (is_nan(x) || is_inf(x)) {
+				return x - x;
+			}
+			const reduced_angle r = reduce_half_pi(sign_bit(x) ? -x : x);
+			const double result = (r.quadrant & 1u) != 0 ? sin_kernel(r.y) : cos_kernel(r.y);
+			return r.quadrant == 1u || r.quadrant == 2u ? -result : result;
+		}
+
+		// Special cases follow C Annex F.
+		constexpr double atan2_d(double y, double x) noexcept
+		{
+			if (is_nan(x) || is_nan(y)) {
+				return x + y;
+			}
+			const bool yNegative = sign_bit(y);
+			const bool xNegative = sign_bit(x);
+			const double ay = yNegative ? -y : y;
+			const double ax = xNegative ? -x : x;
+			double result = 0.0;
+			if (ay == 0.0) {
+				result = xNegative ? pi.hi : 0.0;
+			}
+			else if (ax == 0.0) {
+				result = halfPi.hi;
+			}
+			else if (is_inf(ay)) {
+				result = !is_inf(ax) ? halfPi.hi : (xNegative ? 2.356194490192345 : 0.7853981633974483);
+			}
+			else if (is_inf(ax)) {
+				result = xNegative ? pi.hi : 0.0;
+			}
+			else {
+				const dd a = atan_pos(ay / ax);
+				result = xNegative ? (pi.hi - a.hi) + (pi.lo - a.lo) : a.hi + a.lo;
+			}
+			return yNegative ? -result : result;
+		}
+
+		constexpr double exp_d(double x) noexcept
+		{
+			return exp_dd({x, 0.0});
+		}
+
+		constexpr double log_d(double x) noexcept
+		{
+			if (is_nan(x) || x < 0.0) {
+				return is_nan(x) ? x : NaN;
+			}
+			if (x == 0.0) {
+				return -infinity;
+			}
+			if (is_inf(x)) {
+				return x;
+			}
+			const dd result = log_dd(x);
+			return result.hi + result.lo;
+		}
+
+		// exp(y * log|x|) with both steps in double-double: the product can reach 745, so
+		// a plain double log would cost hundreds of ULP. Special cases follow C Annex F.
+		constexpr double pow_d(double x, double y) noexcept
+		{
+			if (y == 0.0 || x == 1.0) {
+				return 1.0;
+			}
+			if (is_nan(x) || is_nan(y)) {
+				return x + y;
+			}
+			const bool oddY = is_odd_integer(y);
+			const bool flipSign = sign_bit(x) && oddY;
+			if (x == 0.0) {
+				const double result = y < 0.0 ? infinity : 0.0;
+				return flipSign ? -result : result;
+			}
+			const double ax = sign_bit(x) ? -x : x;
+			if (is_inf(y)) {
+				if (ax == 1.0) {
+					return 1.0;
+				}
+				return (ax > 1.0) == (y > 0.0) ? infinity : 0.0;
+			}
+			if (is_inf(x)) {
+				const double result = y < 0.0 ? 0.0 : infinity;
+				return flipSign ? -result : result;
+			}
+			if (x < 0.0 && !is_integer(y)) {
+				return NaN;
+			}
+
+			const dd logX = log_dd(ax);
+			const double estimate = y * logX.hi;
+			double result = 0.0;
+			if (estimate > 710.0) {
+				result = infinity;
+			}
+			else if (estimate >= -746.0) {
+				result = exp_dd(dd{y, 0.0} * logX);
+			}
+			return flipSign ? -result : result;
+		}
+	}
+
+	template<typename T>
+	concept ce_floating_point = std::same_as<T, float> || std::same_as<T, double>;
+
+	// Constant evaluable versions of the <cmath> functions. Both precisions go through
+	// double (double-double where it matters), so results are within 1 ULP for double and
+	// correctly rounded in practice for float, at every magnitude. Special values and
+	// signed zeros behave as in C Annex F.
+	template<ce_floating_point T>
+	constexpr T sin_ce(T x) noexcept
+	{
+		return static_cast<T>(detail::sin_d(x));
+	}
+
+	template<ce_floating_point T>
+	constexpr T cos_ce(T x) noexcept
+	{
+		return static_cast<T>(detail::cos_d(x));
+	}
+
+	template<ce_floating_point T>
+	constexpr T atan2_ce(T y, T x) noexcept
+	{
+		return static_cast<T>(detail::atan2_d(y, x));
+	}
+
+	template<ce_floating_point T>
+	constexpr T exp_ce(T x) noexcept
+	{
+		return static_cast<T>(detail::exp_d(x));
+	}
+
+	template<ce_floating_point T>
+	constexpr T log_ce(T x) noexcept
+	{
+		return static_cast<T>(detail::log_d(x));
+	}
+
+	template<ce_floating_point T>
+	constexpr T pow_ce(T x, T y) noexcept
+	{
+		return static_cast<T>(detail::pow_d(x, y));
+	}
+
+	// The _ce versions at compile time, the C library at run time.
+	template<ce_floating_point T>
+	constexpr T sin(T x) noexcept
+	{
+		return std::is_constant_evaluated() ? sin_ce(x) : std::sin(x);
+	}
+
+	template<ce_floating_point T>
+	constexpr T cos(T x) noexcept
+	{
+		return std::is_constant_evaluated() ? cos_ce(x) : std::cos(x);
+	}
+
+	template<ce_floating_point T>
+	constexpr T atan2(T y, T x) noexcept
+	{
+		return std::is_constant_evaluated() ? atan2_ce(y, x) : std::atan2(y, x);
+	}
+
+	template<ce_floating_point T>
+	constexpr T exp(T x) noexcept
+	{
+		return std::is_constant_evaluated() ? exp_ce(x) : std::exp(x);
+	}
+
+	template<ce_floating_point T>
+	constexpr T log(T x) noexcept
+	{
+		return std::is_constant_evaluated() ? log_ce(x) : std::log(x);
+	}
+
+	template<ce_floating_point T>
+	constexpr T pow(T x, T y) noexcept
+	{
+		return std::is_constant_evaluated() ? pow_ce(x, y) : std::pow(x, y);
+	}
+
+	// Lookup table built at compile time, entry i being fn(i). Being consteval, a table
+	// declared constexpr costs nothing at startup:
+	//
+	//	constexpr auto gamma = make_lut<std::uint8_t, 256>([](size_t i) {
+	//		return math::pow(i / 255.0, 1.0 / 2.2) * 255.0 + 0.5;
+	//	});
+	template<typename T, size_t N, typename Fn>
+	consteval std::array<T, N> make_lut(Fn fn)
+	{
+		std::array<T, N> table{};
+		for (size_t i = 0; i < N; i++) {
+			table[i] = static_cast<T>(fn(i));
+		}
+		return table;
+	}
+
+	// N evenly spaced samples of a function over [first, last], endpoints included, looked
+	// up by argument. Arguments outside the range clamp to the end samples; NaN is not
+	// allowed.
+	template<std::floating_point T, size_t N>
+		requires (N >= 2)
+	class sampled_lut
+	{
+	public:
+		constexpr sampled_lut(const std::array<T, N>& values, T first, T last) noexcept
+			: m_values(values), m_first(first), m_scale(static_cast<T>(N - 1) / (last - first))
+		{
+		}
+
+		constexpr T operator[](size_t index) const noexcept
+		{
+			return m_values[index];
+		}
+
+		constexpr const std::array<T, N>& values() const noexcept
+		{
+			return m_values;
+		}
+
+		constexpr T nearest(T x) const noexcept
+		{
+			return m_values[static_cast<size_t>(position(x) + static_cast<T>(0.5))];
+		}
+
+		constexpr T lerp(T x) const noexcept
+		{
+			const T pos = position(x);
+			const size_t index = std::min(static_cast<size_t>(pos), N - 2);
+			const T t = pos - static_cast<T>(index);
+			return m_values[index] + (m_values[index + 1] - m_values[index]) * t;
+		}
+
+	private:
+		constexpr T position(T x) const noexcept
+		{
+			return clamp((x - m_first) * m_scale, static_cast<T>(0), static_cast<T>(N - 1));
+		}
+
+		std::array<T, N> m_values;
+		T m_first;
+		T m_scale;
+	};
+
+	// constexpr auto sine = make_sampled_lut<float, 1024>([](float x) { return math::sin(x); },
+	//	0.0f, 2.0f * std::numbers::pi_v<float>);
+	template<std::floating_point T, size_t N, typename Fn>
+		requires (N >= 2)
+	consteval sampled_lut<T, N> make_sampled_lut(Fn fn, T first, T last)
+	{
+		const std::array<T, N> values = make_lut<T, N>([&](size_t i) {
+			const double step = (static_cast<double>(last) - static_cast<double>(first)) / static_cast<double>(N - 1);
+			return fn(static_cast<T>(static_cast<double>(first) + step * static_cast<double>(i)));
+		});
+		return sampled_lut<T, N>(values, first, last);
+	}
 }
 
 #endif
\ No newline at end of file
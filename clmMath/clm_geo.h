@@ -2,35 +2,123 @@
 #define CLM_GEO_H
 
 #include <concepts>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
 
 #include "clm_vector.h"
 #include "clm_gen_math.h"
 
 namespace clm::math {
+	namespace detail {
+		// Float coordinates are evaluated in double, where their differences and the
+		// products of those are (nearly) exact, so the orientation signs hold up for
+		// vertical, parallel and touching segments.
+		template<std::floating_point T>
+		using geo_calc_t = std::common_type_t<T, double>;
+
+		// Twice the signed area of (a, b, c): positive when c is left of a -> b, 0 when the
+		// three are collinear.
+		template<std::floating_point T>
+		constexpr geo_calc_t<T> orientation(T ax, T ay, T bx, T by, T cx, T cy) noexcept
+		{
+			using calc_t = geo_calc_t<T>;
+			return (static_cast<calc_t>(bx) - ax) * (static_cast<calc_t>(cy) - ay) -
+				(static_cast<calc_t>(by) - ay) * (static_cast<calc_t>(cx) - ax);
+		}
+
+		template<typename C>
+		constexpr bool straddles(C d1, C d2) noexcept
+		{
+			return (d1 <= C(0) && d2 >= C(0)) || (d1 >= C(0) && d2 <= C(0));
+		}
+
+		// Closed segments a0-a1 and b0-b1: shared endpoints and collinear overlap count.
+		// The bounding box test settles the collinear case the orientations cannot.
+		template<std::floating_point T>
+		constexpr bool segments_intersect(T ax0, T ay0, T ax1, T ay1,
+										  T bx0, T by0, T bx1, T by1) noexcept
+		{
+			if (std::max(std::min(ax0, ax1), std::min(bx0, bx1)) > std::min(std::max(ax0, ax1), std::max(bx0, bx1)) ||
+				std::max(std::min(ay0, ay1), std::min(by0, by1)) > std::min(std::max(ay0, ay1), std::max(by0, by1)))
+			{
+				return false;
+			}
+			return straddles(orientation(ax0, ay0, ax1, ay1, bx0, by0), orientation(ax0, ay0, ax1, ay1, bx1, by1)) &&
+				straddles(orientation(bx0, by0, bx1, by1, ax0, ay0), orientation(bx0, by0, bx1, by1, ax1, ay1));
+		}
+
+		// A point shared by two segments known to intersect. Endpoints lying on the other
+		// segment are returned exactly; collinear overlaps give the overlap's first point in
+		// (x, y) order.
+		template<std::floating_point T>
+		constexpr Point2<T> intersection_point(T ax0, T ay0, T ax1, T ay1,
+											   T bx0, T by0, T bx1, T by1) noexcept
+		{
+			using calc_t = geo_calc_t<T>;
+			const calc_t d1 = orientation(ax0, ay0, ax1, ay1, bx0, by0);
+			const calc_t d2 = orientation(ax0, ay0, ax1, ay1, bx1, by1);
+			const calc_t d3 = orientation(bx0, by0, bx1, by1, ax0, ay0);
+			const calc_t d4 = orientation(bx0, by0, bx1, by1, ax1, ay1);
+			if (d1 == calc_t(0) && d2 == calc_t(0) && d3 == calc_t(0) && d4 == calc_t(0))
+			{
+				const auto lexLess = [](T x0, T y0, T x1, T y1) { return x0 < x1 || (x0 == x1 && y0 < y1); };
+				const bool aForward = lexLess(ax0, ay0, ax1, ay1) || (ax0 == ax1 && ay0 == ay1);
+				const bool bForward = lexLess(bx0, by0, bx1, by1) || (bx0 == bx1 && by0 == by1);
+				const T aStartX = aForward ? ax0 : ax1;
+				const T aStartY = aForward ? ay0 : ay1;
+				const T bStartX = bForward ? bx0 : bx1;
+				const T bStartY = bForward ? by0 : by1;
+				return lexLess(aStartX, aStartY, bStartX, bStartY) ? Point2<T>{bStartX, bStartY} : Point2<T>{aStartX, aStartY};
+			}
+			if (d1 == calc_t(0))
+			{
+				return {bx0, by0};
+			}
+			if (d2 == calc_t(0))
+			{
+				return {bx1, by1};
+			}
+			if (d3 == calc_t(0))
+			{
+				return {ax0, ay0};
+			}
+			if (d4 == calc_t(0))
+			{
+				return {ax1, ay1};
+			}
+			// d1 and d2 have opposite signs, so the crossing is d1 / (d1 - d2) of the way
+			// along b, without a second cross product that could round to 0.
+			const calc_t t = std::clamp(d1 / (d1 - d2), calc_t(0), calc_t(1));
+			return {static_cast<T>(bx0 + t * (static_cast<calc_t>(bx1) - bx0)),
+					static_cast<T>(by0 + t * (static_cast<calc_t>(by1) - by0))};
+		}
+	}
+
+	// Whether the closed segments a1-a2 and b1-b2 share a point. Touching endpoints and
+	// collinear overlap count; vertical and parallel segments need no special handling.
 	template<std::floating_point T>
 	constexpr bool lines_intersect(const Point2<T>& a1, 
 								   const Point2<T>& a2, 
 								   const Point2<T>& b1, 
 								   const Point2<T>& b2)
 	{
-		T Lax = a2[0] - a1[0];
-		T Lay = a2[1] - a1[1];
-		T Lbx = b2[0] - b1[0];
-		T Lby = b2[1] - b1[1];
-
-		T A = Lby - (Lay * Lbx) / Lby;
-		T B = a1[1] - b1[1] + (Lay / Lby) * (b1[0] - a1[0]);
+		return detail::segments_intersect(a1[0], a1[1], a2[0], a2[1], b1[0], b1[1], b2[0], b2[1]);
+	}
 
-		
-		// Consider using a different condition
-		if (A == static_cast<T>(0))
+	// A point shared by the closed segments a1-a2 and b1-b2, if there is one. For collinear
+	// overlaps this is the first point of the overlap in (x, y) order.
+	template<std::floating_point T>
+	constexpr std::optional<Point2<T>> segment_intersection(const Point2<T>& a1,
+															const Point2<T>& a2,
+															const Point2<T>& b1,
+															const Point2<T>& b2)
+	{
+		if (!lines_intersect(a1, a2, b1, b2))
 		{
-			return false;
+			return std::nullopt;
 		}
-
-		T result = B / A;
-		return (result >= static_cast<T>(0) &&
-				result <= static_cast<T>(1));
+		return detail::intersection_point(a1[0], a1[1], a2[0], a2[1], b1[0], b1[1], b2[0], b2[1]);
 	}
 
 	template<std::floating_point T>
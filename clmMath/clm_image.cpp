@@ -0,0 +1,202 @@
+#include "clm_image.h"
+
+#include <algorithm>
+
+#include <clmUtil/clm_parallel.h>
+
+#include "clm_dispatch.h"
+
+namespace clm::color {
+	namespace {
+		using math::Rect;
+		using blend_fn = void (*)(const float* src, float* dst, size_t count) noexcept;
+
+		constexpr std::int32_t tileSize = TiledImage::tileSize;
+
+		// Below this many tiles the work is cheaper than starting threads.
+		constexpr size_t parallelTiles = 64;
+
+		blend_fn blend_kernel(blend_mode mode) noexcept
+		{
+			const auto& kernels = math::dispatch::color_kernels();
+			switch (mode)
+			{
+			case blend_mode::add: return kernels.blend_add;
+			case blend_mode::multiply: return kernels.blend_multiply;
+			default: return kernels.blend_over;
+			}
+		}
+
+		const float* channels(const ColorRGBAf* pixels) noexcept
+		{
+			return reinterpret_cast<const float*>(pixels);
+		}
+		float* channels(ColorRGBAf* pixels) noexcept
+		{
+			return reinterpret_cast<float*>(pixels);
+		}
+
+		Rect tile_rect(std::int32_t tx, std::int32_t ty) noexcept
+		{
+			return Rect{tx * tileSize, ty * tileSize, (tx + 1) * tileSize, (ty + 1) * tileSize};
+		}
+
+		// Calls fn(tx, ty, part) for every tile overlapping area, part being the overlap in
+		// image coordinates. area must lie within the image.
+		template<typename Fn>
+		void for_each_tile(const Rect& area, Fn&& fn)
+		{
+			if (area.empty())
+			{
+				return;
+			}
+			const std::int32_t tx0 = area.left / tileSize;
+			const std::int32_t ty0 = area.top / tileSize;
+			const size_t columns = static_cast<size_t>((area.right - 1) / tileSize - tx0 + 1);
+			const size_t rows = static_cast<size_t>((area.bottom - 1) / tileSize - ty0 + 1);
+			const size_t count = columns * rows;
+			util::parallel_for(count, [&](size_t i) {
+				const std::int32_t tx = tx0 + static_cast<std::int32_t>(i % columns);
+				const std::int32_t ty = ty0 + static_cast<std::int32_t>(i / columns);
+				fn(tx, ty, math::intersection(tile_rect(tx, ty), area));
+			}, 4, count < parallelTiles ? 1 : 0);
+		}
+
+		// Calls fn(srcPixels, dstPixels, count) over the pixels of part (a piece of one dst
+		// tile) and the matching ones of src, offset by (dx, dy), in contiguous runs. A whole
+		// tile lined up with a whole source tile is a single run.
+		template<typename Fn>
+		void for_each_run(const TiledImage& src, std::int32_t dx, std::int32_t dy, TiledImage& dst, const Rect& part, Fn&& fn)
+		{
+			const std::int32_t sx = part.left + dx;
+			const std::int32_t sy = part.top + dy;
+			if (part.width() == tileSize && part.height() == tileSize && sx % tileSize == 0 && sy % tileSize == 0)
+			{
+				fn(src.tile(sx / tileSize, sy / tileSize), dst.tile(part.left / tileSize, part.top / tileSize), TiledImage::tilePixels);
+				return;
+			}
+			for (std::int32_t y = part.top; y < part.bottom; y++)
+			{
+				ColorRGBAf* out = &dst.at(part.left, y);
+				std::int32_t x = sx;
+				std::int32_t remaining = part.width();
+				while (remaining > 0)
+				{
+					const std::int32_t run = std::min(remaining, tileSize - x % tileSize);
+					fn(&src.at(x, y + dy), out, static_cast<size_t>(run));
+					x += run;
+					out += run;
+					remaining -= run;
+				}
+			}
+		}
+
+		// Part of dst covered by src placed at (x, y) of it, and the source offset.
+		struct placement
+		{
+			Rect target;
+			std::int32_t dx;
+			std::int32_t dy;
+		};
+		placement place(const ConstImageView& src, const ImageView& dst, std::int32_t x, std::int32_t y) noexcept
+		{
+			const Rect& from = src.area();
+			const std::int32_t left = dst.area().left + x;
+			const std::int32_t top = dst.area().top + y;
+			const Rect target = math::intersection(dst.area(), Rect{left, top, left + src.width(), top + src.height()});
+			return placement{target, from.left - left, from.top - top};
+		}
+
+		template<typename Fn>
+		void transfer(const ConstImageView& src, const ImageView& dst, Fn&& fn)
+		{
+			const placement p = place(src, dst, 0, 0);
+			for_each_tile(p.target, [&](std::int32_t, std::int32_t, const Rect& part) {
+				for_each_run(src.image(), p.dx, p.dy, dst.image(), part, fn);
+			});
+		}
+	}
+
+	void fill(ImageView dst, const ColorRGBAf& color)
+	{
+		TiledImage& image = dst.image();
+		for_each_tile(dst.area(), [&](std::int32_t tx, std::int32_t ty, const Rect& part) {
+			if (part.width() == tileSize && part.height() == tileSize)
+			{
+				std::fill_n(image.tile(tx, ty), TiledImage::tilePixels, color);
+				return;
+			}
+			for (std::int32_t y = part.top; y < part.bottom; y++)
+			{
+				std::fill_n(&image.at(part.left, y), part.width(), color);
+			}
+		});
+	}
+
+	void copy(ConstImageView src, ImageView dst)
+	{
+		transfer(src, dst, [](const ColorRGBAf* in, ColorRGBAf* out, size_t count) {
+			std::copy_n(in, count, out);
+		});
+	}
+
+	void composite(ConstImageView src, ImageView dst, blend_mode mode)
+	{
+		const blend_fn blend = blend_kernel(mode);
+		transfer(src, dst, [blend](const ColorRGBAf* in, ColorRGBAf* out, size_t count) {
+			blend(channels(in), channels(out), count);
+		});
+	}
+
+	void composite(std::span<const ImageLayer> layers, ImageView dst)
+	{
+		std::vector<placement> placements;
+		std::vector<blend_fn> blends;
+		Rect covered{};
+		for (const ImageLayer& layer : layers)
+		{
+			placements.push_back(place(layer.source, dst, layer.x, layer.y));
+			blends.push_back(blend_kernel(layer.mode));
+			covered = math::bounding_union(covered, placements.back().target);
+		}
+		for_each_tile(math::intersection(covered, dst.area()), [&](std::int32_t, std::int32_t, const Rect& tile) {
+			for (size_t i = 0; i < layers.size(); i++)
+			{
+				const Rect part = math::intersection(tile, placements[i].target);
+				if (part.empty())
+				{
+					continue;
+				}
+				const blend_fn blend = blends[i];
+				for_each_run(layers[i].source.image(), placements[i].dx, placements[i].dy, dst.image(), part,
+							 [blend](const ColorRGBAf* in, ColorRGBAf* out, size_t count) {
+					blend(channels(in), channels(out), count);
+				});
+			}
+		});
+	}
+
+	void read(ConstImageView src, std::span<ColorRGBAf> out)
+	{
+		assert(out.size() >= static_cast<size_t>(src.width()) * src.height());
+		for (std::int32_t y = 0; y < src.height(); y++)
+		{
+			for (std::int32_t x = 0; x < src.width(); x++)
+			{
+				out[static_cast<size_t>(y) * src.width() + x] = src.at(x, y);
+			}
+		}
+	}
+
+	void write(std::span<const ColorRGBAf> in, ImageView dst)
+	{
+		assert(in.size() >= static_cast<size_t>(dst.width()) * dst.height());
+		for (std::int32_t y = 0; y < dst.height(); y++)
+		{
+			for (std::int32_t x = 0; x < dst.width(); x++)
+			{
+				dst.at(x, y) = in[static_cast<size_t>(y) * dst.width() + x];
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef CLM_IMAGE_H
+#define CLM_IMAGE_H
+
+#include <span>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+
+#include <clmUtil/clm_aligned_alloc.h>
+
+#include "clm_rect.h"
+#include "clm_color.h"
+
+// Float RGBA images for compositing. Pixels are premultiplied linear ColorRGBAf, stored in
+// 8x8 tiles of 64 contiguous pixels, so a tile is one kilobyte and the operations below can
+// hand each thread whole tiles. Views address a Rect of an image; every operation clips
+// to the views it is given.
+namespace clm::color {
+	class ImageView;
+	class ConstImageView;
+
+	class TiledImage
+	{
+	public:
+		static constexpr std::int32_t tileSize = 8;
+		static constexpr size_t tilePixels = tileSize * tileSize;
+
+		TiledImage() = default;
+		// Cleared to transparent black.
+		TiledImage(std::int32_t width, std::int32_t height)
+		{
+			resize(width, height);
+		}
+
+		// Discards the contents.
+		void resize(std::int32_t width, std::int32_t height)
+		{
+			assert(width >= 0 && height >= 0);
+			m_width = width;
+			m_height = height;
+			m_tilesX = (width + tileSize - 1) / tileSize;
+			m_tilesY = (height + tileSize - 1) / tileSize;
+			m_pixels.assign(static_cast<size_t>(m_tilesX) * m_tilesY * tilePixels, ColorRGBAf{});
+		}
+
+		std::int32_t width() const noexcept { return m_width; }
+		std::int32_t height() const noexcept { return m_height; }
+		math::Rect bounds() const noexcept { return math::Rect{0, 0, m_width, m_height}; }
+		std::int32_t tiles_x() const noexcept { return m_tilesX; }
+		std::int32_t tiles_y() const noexcept { return m_tilesY; }
+
+		// Index of (x, y) in the tiled storage.
+		size_t offset(std::int32_t x, std::int32_t y) const noexcept
+		{
+			assert(bounds().contains(x, y));
+			const size_t tile = static_cast<size_t>(y / tileSize) * m_tilesX + x / tileSize;
+			return tile * tilePixels + (y % tileSize) * tileSize + x % tileSize;
+		}
+		ColorRGBAf& at(std::int32_t x, std::int32_t y) noexcept
+		{
+			return m_pixels[offset(x, y)];
+		}
+		const ColorRGBAf& at(std::int32_t x, std::int32_t y) const noexcept
+		{
+			return m_pixels[offset(x, y)];
+		}
+		// The 64 pixels of tile (tx, ty), row by row. Edge tiles are padded out to full size.
+		ColorRGBAf* tile(std::int32_t tx, std::int32_t ty) noexcept
+		{
+			return m_pixels.data() + (static_cast<size_t>(ty) * m_tilesX + tx) * tilePixels;
+		}
+		const ColorRGBAf* tile(std::int32_t tx, std::int32_t ty) const noexcept
+		{
+			return m_pixels.data() + (static_cast<size_t>(ty) * m_tilesX + tx) * tilePixels;
+		}
+
+		ImageView view() noexcept;
+		ImageView view(const math::Rect& area) noexcept;
+		ConstImageView view() const noexcept;
+		ConstImageView view(const math::Rect& area) const noexcept;
+
+	private:
+		std::int32_t m_width = 0;
+		std::int32_t m_height = 0;
+		std::int32_t m_tilesX = 0;
+		std::int32_t m_tilesY = 0;
+		std::vector<ColorRGBAf, util::aligned_allocator<ColorRGBAf>> m_pixels;
+	};
+
+	// A Rect of a TiledImage, clipped to its bounds. Coordinates passed to a view are
+	// relative to the top-left of its area.
+	class ConstImageView
+	{
+	public:
+		ConstImageView(const TiledImage& image, const math::Rect& area) noexcept
+			:
+			m_image(&image), m_area(math::intersection(image.bounds(), area))
+		{
+			if (m_area.empty())
+			{
+				m_area = math::Rect{};
+			}
+		}
+
+		const TiledImage& image() const noexcept { return *m_image; }
+		const math::Rect& area() const noexcept { return m_area; }
+		std::int32_t width() const noexcept { return m_area.width(); }
+		std::int32_t height() const noexcept { return m_area.height(); }
+		bool empty() const noexcept { return m_area.empty(); }
+
+		const ColorRGBAf& at(std::int32_t x, std::int32_t y) const noexcept
+		{
+			return m_image->at(m_area.left + x, m_area.top + y);
+		}
+		ConstImageView view(const math::Rect& area) const noexcept
+		{
+			return ConstImageView{*m_image, math::intersection(m_area, offset_rect(area))};
+		}
+
+	protected:
+		math::Rect offset_rect(const math::Rect& area) const noexcept
+		{
+			return math::Rect{area.left + m_area.left, area.top + m_area.top, area.right + m_area.left, area.bottom + m_area.top};
+		}
+
+		const TiledImage* m_image;
+		math::Rect m_area;
+	};
+
+	class ImageView : public ConstImageView
+	{
+	public:
+		ImageView(TiledImage& image, const math::Rect& area) noexcept
+			:
+			ConstImageView(image, area)
+		{}
+
+		TiledImage& image() const noexcept { return const_cast<TiledImage&>(*m_image); }
+
+		ColorRGBAf& at(std::int32_t x, std::int32_t y) const noexcept
+		{
+			return image().at(m_area.left + x, m_area.top + y);
+		}
+		ImageView view(const math::Rect& area) const noexcept
+		{
+			return ImageView{image(), math::intersection(m_area, offset_rect(area))};
+		}
+	};
+
+	inline ImageView TiledImage::view() noexcept { return ImageView{*this, bounds()}; }
+	inline ImageView TiledImage::view(const math::Rect& area) noexcept { return ImageView{*this, area}; }
+	inline ConstImageView TiledImage::view() const noexcept { return ConstImageView{*this, bounds()}; }
+	inline ConstImageView TiledImage::view(const math::Rect& area) const noexcept { return ConstImageView{*this, area}; }
+
+	// Porter-Duff operators on premultiplied color, see dispatch::color_kernel_table.
+	enum class blend_mode
+	{
+		over,
+		add,
+		multiply
+	};
+
+	// A source placed with its top-left at (x, y) of the destination view.
+	struct ImageLayer
+	{
+		ConstImageView source;
+		std::int32_t x = 0;
+		std::int32_t y = 0;
+		blend_mode mode = blend_mode::over;
+	};
+
+	// The operations below split the destination into tiles and spread them over
+	// util::parallel_for once there are enough of them to pay for the threads. Sources
+	// must not share pixels with the destination.
+
+	void fill(ImageView dst, const ColorRGBAf& color);
+	inline void clear(ImageView dst)
+	{
+		fill(dst, ColorRGBAf{});
+	}
+
+	// src onto the top-left of dst, over the size the two have in common.
+	void copy(ConstImageView src, ImageView dst);
+	void composite(ConstImageView src, ImageView dst, blend_mode mode = blend_mode::over);
+
+	// Every layer in order, each tile of dst finishing all of them before the next tile,
+	// so a stack of layers costs one pass over the destination.
+	void composite(std::span<const ImageLayer> layers, ImageView dst);
+
+	// Row-major transfers to and from plain pixel arrays of width() * height() pixels.
+	void read(ConstImageView src, std::span<ColorRGBAf> out);
+	void write(std::span<const ColorRGBAf> in, ImageView dst);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,405 @@
+#ifndef CLM_KD_TREE_H
+#define CLM_KD_TREE_H
+
+#include <span>
+#include <array>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+
+#include <clmUtil/clm_parallel.h>
+
+#include "clm_vector.h"
+
+namespace clm::math {
+	// A point found by KdTree: its position in the span the tree was built from and its
+	// squared distance to the query.
+	template<std::floating_point T>
+	struct KdNeighbor
+	{
+		std::uint32_t index;
+		T distanceSquared;
+	};
+
+	// Static k-d tree over a set of points, for nearest, k-nearest and radius queries.
+	// The points are copied into one array in tree order: the node for a range [lo, hi)
+	// is its midpoint, with the left subtree in [lo, mid) and the right in (mid, hi), so
+	// the tree needs no child links and no allocation per node. Ranges of leafSize points
+	// or fewer are leaves and are scanned. Each node splits along the axis where its
+	// points spread the most.
+	//
+	// Queries are const and may run concurrently. Distances are squared Euclidean; ties
+	// go to the lower index.
+	template<std::floating_point T, size_t dim>
+	class KdTree
+	{
+	public:
+		using point_t = Point<T, dim>;
+		using neighbor_t = KdNeighbor<T>;
+
+		// Index of a missing result: an empty tree, or fewer than k points.
+		static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+		static constexpr size_t leafSize = 8;
+
+		KdTree() = default;
+		explicit KdTree(std::span<const point_t> points)
+		{
+			build(points);
+		}
+
+		// Replaces the contents. The top levels of the tree are split in parallel.
+		void build(std::span<const point_t> points)
+		{
+			assert(points.size() < npos);
+			m_nodes.resize(points.size());
+			m_axes.assign(points.size(), 0);
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					m_nodes[i].coords[axis] = points[i][axis];
+				}
+				m_nodes[i].index = static_cast<std::uint32_t>(i);
+			}
+
+			// Level by level until there are enough subtrees to keep every worker busy,
+			// then each subtree is finished on one thread.
+			std::vector<range> level{{0, m_nodes.size()}};
+			const size_t target = util::worker_count() * 4;
+			while (level.size() < target)
+			{
+				std::vector<range> next;
+				next.reserve(level.size() * 2);
+				for (const range& r : level)
+				{
+					if (r.size() > parallelSplitSize)
+					{
+						const size_t mid = r.mid();
+						next.push_back({r.lo, mid});
+						next.push_back({mid + 1, r.hi});
+					}
+				}
+				if (next.empty())
+				{
+					break;
+				}
+				util::parallel_for(level.size(), [&](size_t i) {
+					if (level[i].size() > parallelSplitSize)
+					{
+						split(level[i]);
+					}
+				});
+				// Ranges too small to split above are finished in the final pass.
+				for (const range& r : level)
+				{
+					if (r.size() <= parallelSplitSize)
+					{
+						next.push_back(r);
+					}
+				}
+				level = std::move(next);
+			}
+			util::parallel_for(level.size(), [&](size_t i) {
+				build_subtree(level[i]);
+			});
+		}
+
+		size_t size() const noexcept
+		{
+			return m_nodes.size();
+		}
+		bool empty() const noexcept
+		{
+			return m_nodes.empty();
+		}
+
+		// Closest point, or {npos, inf} for an empty tree.
+		neighbor_t nearest(const point_t& query) const noexcept
+		{
+			const std::array<T, dim> q = coords_of(query);
+			neighbor_t best{npos, std::numeric_limits<T>::infinity()};
+			search_nearest(q, 0, m_nodes.size(), best);
+			return best;
+		}
+
+		// The k closest points into out, closest first; fewer if the tree is smaller.
+		size_t nearest(const point_t& query, size_t k, std::vector<neighbor_t>& out) const
+		{
+			out.clear();
+			if (k == 0)
+			{
+				return 0;
+			}
+			const std::array<T, dim> q = coords_of(query);
+			out.reserve(std::min(k, m_nodes.size()));
+			search_k(q, k, 0, m_nodes.size(), out);
+			std::sort_heap(out.begin(), out.end(), closer);
+			return out.size();
+		}
+
+		// Every point within radius (inclusive) into out, in no particular order.
+		size_t within(const point_t& query, T radius, std::vector<neighbor_t>& out) const
+		{
+			out.clear();
+			if (radius < T{})
+			{
+				return 0;
+			}
+			search_radius(coords_of(query), radius * radius, 0, m_nodes.size(), out);
+			return out.size();
+		}
+
+		// Batch forms of the queries above, spread across util::worker_count() threads.
+
+		// out[i] is nearest(queries[i]); out needs queries.size() entries.
+		void nearest(std::span<const point_t> queries, std::span<neighbor_t> out) const
+		{
+			assert(out.size() >= queries.size());
+			util::parallel_for(queries.size(), [&](size_t i) {
+				out[i] = nearest(queries[i]);
+			}, batchGrain);
+		}
+
+		// Row i of out (k entries from out[i * k]) is nearest(queries[i], k), padded with
+		// {npos, inf} when the tree has fewer than k points.
+		void nearest(std::span<const point_t> queries, size_t k, std::span<neighbor_t> out) const
+		{
+			assert(out.size() >= queries.size() * k);
+			util::parallel_for((queries.size() + batchGrain - 1) / batchGrain, [&](size_t chunk) {
+				std::vector<neighbor_t> found;
+				const size_t end = std::min(queries.size(), (chunk + 1) * batchGrain);
+				for (size_t i = chunk * batchGrain; i < end; i++)
+				{
+					nearest(queries[i], k, found);
+					std::copy(found.begin(), found.end(), out.begin() + i * k);
+					std::fill(out.begin() + i * k + found.size(), out.begin() + (i + 1) * k,
+							  neighbor_t{npos, std::numeric_limits<T>::infinity()});
+				}
+			});
+		}
+
+		// Element i is within(queries[i], radius).
+		std::vector<std::vector<neighbor_t>> within(std::span<const point_t> queries, T radius) const
+		{
+			std::vector<std::vector<neighbor_t>> out(queries.size());
+			util::parallel_for(queries.size(), [&](size_t i) {
+				within(queries[i], radius, out[i]);
+			}, batchGrain);
+			return out;
+		}
+
+	private:
+		static constexpr size_t parallelSplitSize = 1 << 14;
+		static constexpr size_t batchGrain = 64;
+
+		struct node
+		{
+			std::array<T, dim> coords;
+			std::uint32_t index;
+		};
+
+		struct range
+		{
+			size_t lo;
+			size_t hi;
+
+			size_t size() const noexcept { return hi - lo; }
+			size_t mid() const noexcept { return lo + (hi - lo) / 2; }
+		};
+
+		static std::array<T, dim> coords_of(const point_t& point) noexcept
+		{
+			std::array<T, dim> coords{};
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				coords[axis] = point[axis];
+			}
+			return coords;
+		}
+
+		static bool closer(const neighbor_t& lhs, const neighbor_t& rhs) noexcept
+		{
+			return lhs.distanceSquared < rhs.distanceSquared ||
+				(lhs.distanceSquared == rhs.distanceSquared && lhs.index < rhs.index);
+		}
+
+		static T distance_squared(const std::array<T, dim>& lhs, const std::array<T, dim>& rhs) noexcept
+		{
+			T sum{};
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				const T d = lhs[axis] - rhs[axis];
+				sum += d * d;
+			}
+			return sum;
+		}
+
+		// Puts the median of r along its widest axis at r.mid(), smaller ones before it.
+		void split(const range& r)
+		{
+			std::array<T, dim> lo;
+			std::array<T, dim> hi;
+			lo.fill(std::numeric_limits<T>::infinity());
+			hi.fill(-std::numeric_limits<T>::infinity());
+			for (size_t i = r.lo; i < r.hi; i++)
+			{
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					lo[axis] = std::min(lo[axis], m_nodes[i].coords[axis]);
+					hi[axis] = std::max(hi[axis], m_nodes[i].coords[axis]);
+				}
+			}
+			std::uint8_t axis = 0;
+			for (size_t a = 1; a < dim; a++)
+			{
+				if (hi[a] - lo[a] > hi[axis] - lo[axis])
+				{
+					axis = static_cast<std::uint8_t>(a);
+				}
+			}
+			const size_t mid = r.mid();
+			std::nth_element(m_nodes.begin() + r.lo, m_nodes.begin() + mid, m_nodes.begin() + r.hi,
+				[axis](const node& lhs, const node& rhs) { return lhs.coords[axis] < rhs.coords[axis]; });
+			m_axes[mid] = axis;
+		}
+
+		void build_subtree(const range& r)
+		{
+			if (r.size() <= leafSize)
+			{
+				return;
+			}
+			split(r);
+			build_subtree({r.lo, r.mid()});
+			build_subtree({r.mid() + 1, r.hi});
+		}
+
+		void search_nearest(const std::array<T, dim>& q, size_t lo, size_t hi, neighbor_t& best) const noexcept
+		{
+			if (hi - lo <= leafSize)
+			{
+				for (size_t i = lo; i < hi; i++)
+				{
+					const neighbor_t candidate{m_nodes[i].index, distance_squared(q, m_nodes[i].coords)};
+					if (closer(candidate, best))
+					{
+						best = candidate;
+					}
+				}
+				return;
+			}
+			const size_t mid = lo + (hi - lo) / 2;
+			const node& n = m_nodes[mid];
+			const neighbor_t candidate{n.index, distance_squared(q, n.coords)};
+			if (closer(candidate, best))
+			{
+				best = candidate;
+			}
+			const T diff = q[m_axes[mid]] - n.coords[m_axes[mid]];
+			if (diff < T{})
+			{
+				search_nearest(q, lo, mid, best);
+				if (diff * diff <= best.distanceSquared)
+				{
+					search_nearest(q, mid + 1, hi, best);
+				}
+			}
+			else
+			{
+				search_nearest(q, mid + 1, hi, best);
+				if (diff * diff <= best.distanceSquared)
+				{
+					search_nearest(q, lo, mid, best);
+				}
+			}
+		}
+
+		// heap is a max-heap under closer, holding up to k neighbours.
+		void offer(std::vector<neighbor_t>& heap, size_t k, const neighbor_t& candidate) const
+		{
+			if (heap.size() < k)
+			{
+				heap.push_back(candidate);
+				std::push_heap(heap.begin(), heap.end(), closer);
+			}
+			else if (closer(candidate, heap.front()))
+			{
+				std::pop_heap(heap.begin(), heap.end(), closer);
+				heap.back() = candidate;
+				std::push_heap(heap.begin(), heap.end(), closer);
+			}
+		}
+
+		void search_k(const std::array<T, dim>& q, size_t k, size_t lo, size_t hi, std::vector<neighbor_t>& heap) const
+		{
+			if (hi - lo <= leafSize)
+			{
+				for (size_t i = lo; i < hi; i++)
+				{
+					offer(heap, k, neighbor_t{m_nodes[i].index, distance_squared(q, m_nodes[i].coords)});
+				}
+				return;
+			}
+			const size_t mid = lo + (hi - lo) / 2;
+			const node& n = m_nodes[mid];
+			offer(heap, k, neighbor_t{n.index, distance_squared(q, n.coords)});
+			const T diff = q[m_axes[mid]] - n.coords[m_axes[mid]];
+			const bool goLeft = diff < T{};
+			search_k(q, k, goLeft ? lo : mid + 1, goLeft ? mid : hi, heap);
+			if (heap.size() < k || diff * diff <= heap.front().distanceSquared)
+			{
+				search_k(q, k, goLeft ? mid + 1 : lo, goLeft ? hi : mid, heap);
+			}
+		}
+
+		void search_radius(const std::array<T, dim>& q, T radiusSquared, size_t lo, size_t hi, std::vector<neighbor_t>& out) const
+		{
+			if (hi - lo <= leafSize)
+			{
+				for (size_t i = lo; i < hi; i++)
+				{
+					const T d = distance_squared(q, m_nodes[i].coords);
+					if (d <= radiusSquared)
+					{
+						out.push_back(neighbor_t{m_nodes[i].index, d});
+					}
+				}
+				return;
+			}
+			const size_t mid = lo + (hi - lo) / 2;
+			const node& n = m_nodes[mid];
+			const T d = distance_squared(q, n.coords);
+			if (d <= radiusSquared)
+			{
+				out.push_back(neighbor_t{n.index, d});
+			}
+			const T diff = q[m_axes[mid]] - n.coords[m_axes[mid]];
+			if (diff <= T{} || diff * diff <= radiusSquared)
+			{
+				search_radius(q, radiusSquared, lo, mid, out);
+			}
+			if (diff >= T{} || diff * diff <= radiusSquared)
+			{
+				search_radius(q, radiusSquared, mid + 1, hi, out);
+			}
+		}
+
+		std::vector<node> m_nodes;
+		// Split axis of each interior node, stored at its midpoint.
+		std::vector<std::uint8_t> m_axes;
+	};
+
+	template<std::floating_point T>
+	using KdTree2 = KdTree<T, 2>;
+	using KdTree2f = KdTree<float, 2>;
+	using KdTree2d = KdTree<double, 2>;
+	template<std::floating_point T>
+	using KdTree3 = KdTree<T, 3>;
+	using KdTree3f = KdTree<float, 3>;
+	using KdTree3d = KdTree<double, 3>;
+}
+
+#endif
\ No newline at end of file
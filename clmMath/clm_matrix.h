@@ -3,28 +3,39 @@
 
 #include <array>
 #include <initializer_list>
+#include <algorithm>
+
+#include "clm_vector.h"
+#include "clm_matrix_simd.h"
 
 namespace clm::math {
-	template<size_t dim, typename T> using Elements_t = std::array<std::array<T, dim>, dim>;
-	template<size_t dim, typename T = float> class Matrix
+	template<size_t dim, typename T, size_t cols = dim> using Elements_t = std::array<std::array<T, cols>, dim>;
+
+	// dim x cols matrix, row-major. cols defaults to dim, so Matrix<dim, T> is the square
+	// case; square-only operations (determinant, inverse, identity) require dim == cols.
+	template<size_t dim, typename T = float, size_t cols = dim> class Matrix
 	{
+		using simd_t = simd::mat_traits<(dim == cols ? dim : 0), T>;
 	public:
+		static constexpr size_t row_count = dim;
+		static constexpr size_t col_count = cols;
+
 		constexpr Matrix() = default;
-		constexpr Matrix(Elements_t<dim, T> elements) : m_elements(elements) {}
-		constexpr Matrix(T(&elements)[dim][dim])
+		constexpr Matrix(Elements_t<dim, T, cols> elements) : m_elements(elements) {}
+		constexpr Matrix(T(&elements)[dim][cols])
 			:
 			m_elements({})
 		{
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < cols; j++)
 				{
 					m_elements[i][j] = elements[i][j];
 				}
 			}
 		}
 
-		constexpr Matrix(std::initializer_list<std::array<T, dim>> elements)
+		constexpr Matrix(std::initializer_list<std::array<T, cols>> elements)
 			:
 			m_elements({})
 		{
@@ -34,11 +45,11 @@ namespace clm::math {
 		constexpr ~Matrix() = default;
 		constexpr Matrix(const Matrix&) = default;
 		constexpr Matrix(Matrix&&) = default;
-		constexpr std::array<T, dim>& operator[](size_t row) noexcept
+		constexpr std::array<T, cols>& operator[](size_t row) noexcept
 		{
 			return m_elements[row];
 		}
-		constexpr const std::array<T, dim>& operator[](size_t row) const noexcept
+		constexpr const std::array<T, cols>& operator[](size_t row) const noexcept
 		{
 			return m_elements[row];
 		}
@@ -46,7 +57,7 @@ namespace clm::math {
 		{
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < cols; j++)
 				{
 					m_elements[i][j] = rhs[i][j];
 				}
@@ -56,10 +67,11 @@ namespace clm::math {
 		constexpr const Matrix& operator=(Matrix&& rhs)
 		{
 			m_elements = std::move(rhs.m_elements);
+			return *this;
 		}
-		constexpr Matrix<dim - 1, T> get_reduced_mat(size_t removeRow, size_t removeCol) const noexcept
+		constexpr Matrix<dim - 1, T> get_reduced_mat(size_t removeRow, size_t removeCol) const noexcept requires (dim == cols)
 		{
-			static_assert(dim != 0, L"Can't have matrix of dimension 0.");
+			static_assert(dim != 0, "Can't have matrix of dimension 0.");
 			Matrix<dim - 1, T> reducedMatrix{};
 			size_t iRM{};
 			for (size_t i = 0; i < dim; i += 1)
@@ -99,15 +111,15 @@ namespace clm::math {
 		};
 		Iterator begin() { return Iterator{&m_elements[0][0]}; }
 		ConstIterator begin() const { return ConstIterator{&m_elements[0][0]}; }
-		Iterator end() { return Iterator{(&m_elements[dim - 1][dim - 1]) + 1}; }
-		ConstIterator end() const { return ConstIterator{(&m_elements[dim - 1][dim - 1]) + 1}; }
+		Iterator end() { return Iterator{(&m_elements[dim - 1][cols - 1]) + 1}; }
+		ConstIterator end() const { return ConstIterator{(&m_elements[dim - 1][cols - 1]) + 1}; }
 
-		constexpr const Matrix& operator+(const Matrix& rhs) const noexcept
+		constexpr Matrix operator+(const Matrix& rhs) const noexcept
 		{
-			Matrix<dim, T> sumMatrix{};
+			Matrix sumMatrix{};
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < cols; j++)
 				{
 					sumMatrix[i][j] = this->m_elements[i][j] + rhs[i][j];
 				}
@@ -116,24 +128,35 @@ namespace clm::math {
 		}
 		constexpr Matrix operator-(const Matrix& rhs) const noexcept
 		{
-			Matrix<dim, T> sumMatrix{};
+			Matrix sumMatrix{};
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < cols; j++)
 				{
-					sumMatrix[i][j] = this->m_elements[i][j] + rhs[i][j];
+					sumMatrix[i][j] = this->m_elements[i][j] - rhs[i][j];
 				}
 			}
 			return sumMatrix;
 		}
-		constexpr Matrix operator*(const Matrix& rhs) const noexcept
+		// Shape-checked product: (dim x cols) * (cols x rhsCols) -> (dim x rhsCols).
+		template<size_t rhsCols>
+		constexpr Matrix<dim, T, rhsCols> operator*(const Matrix<cols, T, rhsCols>& rhs) const noexcept
 		{
-			Matrix<dim, T> sumMatrix{};
+			if constexpr (simd_t::enabled && rhsCols == cols)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Matrix product{};
+					simd_t::mul(data(), rhs.data(), product.data());
+					return product;
+				}
+			}
+			Matrix<dim, T, rhsCols> sumMatrix{};
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < rhsCols; j++)
 				{
-					for (size_t k = 0; k < dim; k++)
+					for (size_t k = 0; k < cols; k++)
 					{
 						sumMatrix[i][j] += (this->m_elements[i][k] * rhs[k][j]);
 					}
@@ -141,40 +164,122 @@ namespace clm::math {
 			}
 			return sumMatrix;
 		}
-		template<typename G>
+		constexpr Vector<T, dim> operator*(const Vector<T, cols>& vec) const noexcept
+		{
+			if constexpr (simd_t::enabled)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					Vector<T, dim> product{};
+					simd_t::mul_vec(data(), vec.data(), product.data());
+					return product;
+				}
+			}
+			Vector<T, dim> product{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				T sum{};
+				for (size_t j = 0; j < cols; j++)
+				{
+					sum += m_elements[i][j] * vec[j];
+				}
+				product[i] = sum;
+			}
+			return product;
+		}
+		template<vector_scalar G>
 		constexpr Matrix operator*(G num) const noexcept
 		{
-			Matrix<T, dim> scaledMatrix{};
+			Matrix scaledMatrix{};
 			for (size_t i = 0; i < dim; i++)
 			{
-				for (size_t j = 0; j < dim; j++)
+				for (size_t j = 0; j < cols; j++)
 				{
 					scaledMatrix[i][j] = num * this->m_elements[i][j];
 				}
 			}
 			return scaledMatrix;
 		}
-		template<typename G>
-		friend constexpr Matrix operator*(G num, Matrix& rhs)
+		template<vector_scalar G>
+		friend constexpr Matrix operator*(G num, const Matrix& rhs)
 		{
 			return rhs * num;
 		}
 
-		constexpr Matrix transpose() const noexcept
+		constexpr const T* data() const noexcept
 		{
-			Matrix<dim, T> matrixTranspose{};
-			for (size_t i = 0; i < dim; i++)
+			return m_elements[0].data();
+		}
+		constexpr T* data() noexcept
+		{
+			return m_elements[0].data();
+		}
+
+		constexpr Matrix<cols, T, dim> transpose() const noexcept
+		{
+			Matrix<cols, T, dim> matrixTranspose{};
+			for (size_t i = 0; i < cols; i++)
 			{
 				for (size_t j = 0; j < dim; j++)
 				{
-					matrixTranspose.m_elements[i][j] = m_elements[j][i];
+					matrixTranspose[i][j] = m_elements[j][i];
 				}
 			}
 			return matrixTranspose;
 		}
-		constexpr T determinant() const noexcept
+		static constexpr Matrix identity() noexcept requires (dim == cols)
+		{
+			Matrix ident{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				ident[i][i] = static_cast<T>(1);
+			}
+			return ident;
+		}
+
+		// Closed forms up to 4x4, LU decomposition above that. Integral matrices fall back
+		// to cofactor expansion so the result stays exact.
+		constexpr T determinant() const noexcept requires (dim == cols)
 		{
-			if constexpr (dim == 2)
+			const Elements_t<dim, T>& m = m_elements;
+			if constexpr (dim == 1)
+			{
+				return m[0][0];
+			}
+			else if constexpr (dim == 2)
+			{
+				return (m[0][0] * m[1][1]) - (m[0][1] * m[1][0]);
+			}
+			else if constexpr (dim == 3)
+			{
+				return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+					- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+					+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+			}
+			else if constexpr (dim == 4)
+			{
+				const auto [s, c] = minors_4x4();
+				return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+			}
+			else if constexpr (std::floating_point<T>)
+			{
+				return lu_decompose(*this).determinant();
+			}
+			else
+			{
+				return determinant_cofactor();
+			}
+		}
+
+		// Recursive Laplace expansion along the first column. O(dim!), kept for integral
+		// matrices and as a reference for the LU path.
+		constexpr T determinant_cofactor() const noexcept requires (dim == cols)
+		{
+			if constexpr (dim == 1)
+			{
+				return m_elements[0][0];
+			}
+			else if constexpr (dim == 2)
 			{
 				return (m_elements[0][0] * m_elements[1][1]) - (m_elements[0][1] * m_elements[1][0]);
 			}
@@ -184,14 +289,316 @@ namespace clm::math {
 				for (size_t i = 0; i < dim; i++)
 				{
 					Matrix<dim - 1, T> reducedMatrix = get_reduced_mat(i, 0);
-					calculation += (((i & 1) == 0 ? static_cast<T>(1) : static_cast<T>(-1)) * m_elements[i][0] * reducedMatrix.determinant());
+					calculation += (((i & 1) == 0 ? static_cast<T>(1) : static_cast<T>(-1)) * m_elements[i][0] * reducedMatrix.determinant_cofactor());
 				}
 				return calculation;
 			}
 		}
+
+		// Closed forms up to 4x4, LU decomposition above that. A singular matrix yields
+		// non-finite elements; check determinant() first when that is possible.
+		constexpr Matrix inverse() const noexcept requires (std::floating_point<T> && dim == cols)
+		{
+			const Elements_t<dim, T>& m = m_elements;
+			if constexpr (dim == 1)
+			{
+				return Matrix{{std::array<T, 1>{static_cast<T>(1) / m[0][0]}}};
+			}
+			else if constexpr (dim == 2)
+			{
+				const T invDet = static_cast<T>(1) / determinant();
+				Matrix inv{};
+				inv[0][0] = m[1][1] * invDet;
+				inv[0][1] = -m[0][1] * invDet;
+				inv[1][0] = -m[1][0] * invDet;
+				inv[1][1] = m[0][0] * invDet;
+				return inv;
+			}
+			else if constexpr (dim == 3)
+			{
+				const T invDet = static_cast<T>(1) / determinant();
+				Matrix inv{};
+				for (size_t i = 0; i < 3; i++)
+				{
+					const size_t i1 = (i + 1) % 3;
+					const size_t i2 = (i + 2) % 3;
+					for (size_t j = 0; j < 3; j++)
+					{
+						const size_t j1 = (j + 1) % 3;
+						const size_t j2 = (j + 2) % 3;
+						inv[j][i] = (m[i1][j1] * m[i2][j2] - m[i1][j2] * m[i2][j1]) * invDet;
+					}
+				}
+				return inv;
+			}
+			else if constexpr (dim == 4)
+			{
+				const auto [s, c] = minors_4x4();
+				const T invDet = static_cast<T>(1) / (s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0]);
+				Matrix inv{};
+				inv[0][0] = (m[1][1] * c[5] - m[1][2] * c[4] + m[1][3] * c[3]) * invDet;
+				inv[0][1] = (-m[0][1] * c[5] + m[0][2] * c[4] - m[0][3] * c[3]) * invDet;
+				inv[0][2] = (m[3][1] * s[5] - m[3][2] * s[4] + m[3][3] * s[3]) * invDet;
+				inv[0][3] = (-m[2][1] * s[5] + m[2][2] * s[4] - m[2][3] * s[3]) * invDet;
+				inv[1][0] = (-m[1][0] * c[5] + m[1][2] * c[2] - m[1][3] * c[1]) * invDet;
+				inv[1][1] = (m[0][0] * c[5] - m[0][2] * c[2] + m[0][3] * c[1]) * invDet;
+				inv[1][2] = (-m[3][0] * s[5] + m[3][2] * s[2] - m[3][3] * s[1]) * invDet;
+				inv[1][3] = (m[2][0] * s[5] - m[2][2] * s[2] + m[2][3] * s[1]) * invDet;
+				inv[2][0] = (m[1][0] * c[4] - m[1][1] * c[2] + m[1][3] * c[0]) * invDet;
+				inv[2][1] = (-m[0][0] * c[4] + m[0][1] * c[2] - m[0][3] * c[0]) * invDet;
+				inv[2][2] = (m[3][0] * s[4] - m[3][1] * s[2] + m[3][3] * s[0]) * invDet;
+				inv[2][3] = (-m[2][0] * s[4] + m[2][1] * s[2] - m[2][3] * s[0]) * invDet;
+				inv[3][0] = (-m[1][0] * c[3] + m[1][1] * c[1] - m[1][2] * c[0]) * invDet;
+				inv[3][1] = (m[0][0] * c[3] - m[0][1] * c[1] + m[0][2] * c[0]) * invDet;
+				inv[3][2] = (-m[3][0] * s[3] + m[3][1] * s[1] - m[3][2] * s[0]) * invDet;
+				inv[3][3] = (m[2][0] * s[3] - m[2][1] * s[1] + m[2][2] * s[0]) * invDet;
+				return inv;
+			}
+			else
+			{
+				return lu_decompose(*this).inverse();
+			}
+		}
 	private:
-		Elements_t<dim, T> m_elements;
+		struct Minors4x4
+		{
+			std::array<T, 6> s;
+			std::array<T, 6> c;
+		};
+		// 2x2 minors of the top two rows (s) and bottom two rows (c) of a 4x4.
+		constexpr Minors4x4 minors_4x4() const noexcept requires (dim == 4 && cols == 4)
+		{
+			const Elements_t<dim, T>& m = m_elements;
+			return {
+				{m[0][0] * m[1][1] - m[1][0] * m[0][1],
+				 m[0][0] * m[1][2] - m[1][0] * m[0][2],
+				 m[0][0] * m[1][3] - m[1][0] * m[0][3],
+				 m[0][1] * m[1][2] - m[1][1] * m[0][2],
+				 m[0][1] * m[1][3] - m[1][1] * m[0][3],
+				 m[0][2] * m[1][3] - m[1][2] * m[0][3]},
+				{m[2][0] * m[3][1] - m[3][0] * m[2][1],
+				 m[2][0] * m[3][2] - m[3][0] * m[2][2],
+				 m[2][0] * m[3][3] - m[3][0] * m[2][3],
+				 m[2][1] * m[3][2] - m[3][1] * m[2][2],
+				 m[2][1] * m[3][3] - m[3][1] * m[2][3],
+				 m[2][2] * m[3][3] - m[3][2] * m[2][3]}
+			};
+		}
+
+		alignas(simd_t::alignment) Elements_t<dim, T, cols> m_elements;
 	};
+
+	using Matrix4f = Matrix<4, float>;
+
+	// Row-pivoted LU factorization PA = LU, stored packed: L (unit diagonal) below the
+	// diagonal of lu, U on and above it. permutation[i] is the row of A that ended up in
+	// row i. O(dim^3) to build, O(dim^2) per solve.
+	template<size_t dim, std::floating_point T>
+	struct LUDecomposition
+	{
+		Matrix<dim, T> lu{};
+		std::array<size_t, dim> permutation{};
+		bool oddPermutation = false;
+		bool singular = false;
+
+		constexpr T determinant() const noexcept
+		{
+			if (singular)
+			{
+				return static_cast<T>(0);
+			}
+			T det = oddPermutation ? static_cast<T>(-1) : static_cast<T>(1);
+			for (size_t i = 0; i < dim; i++)
+			{
+				det *= lu[i][i];
+			}
+			return det;
+		}
+
+		constexpr Vector<T, dim> solve(const Vector<T, dim>& rhs) const noexcept
+		{
+			Vector<T, dim> x{};
+			for (size_t i = 0; i < dim; i++)
+			{
+				T sum = rhs[permutation[i]];
+				for (size_t j = 0; j < i; j++)
+				{
+					sum -= lu[i][j] * x[j];
+				}
+				x[i] = sum;
+			}
+			for (size_t i = dim; i-- > 0;)
+			{
+				T sum = x[i];
+				for (size_t j = i + 1; j < dim; j++)
+				{
+					sum -= lu[i][j] * x[j];
+				}
+				x[i] = sum / lu[i][i];
+			}
+			return x;
+		}
+
+		constexpr Matrix<dim, T> inverse() const noexcept
+		{
+			Matrix<dim, T> inv{};
+			for (size_t col = 0; col < dim; col++)
+			{
+				Vector<T, dim> unit{};
+				unit[col] = static_cast<T>(1);
+				const Vector<T, dim> x = solve(unit);
+				for (size_t row = 0; row < dim; row++)
+				{
+					inv[row][col] = x[row];
+				}
+			}
+			return inv;
+		}
+	};
+
+	template<size_t dim, std::floating_point T>
+	constexpr LUDecomposition<dim, T> lu_decompose(const Matrix<dim, T>& mat) noexcept
+	{
+		LUDecomposition<dim, T> dec{mat};
+		Matrix<dim, T>& a = dec.lu;
+		for (size_t i = 0; i < dim; i++)
+		{
+			dec.permutation[i] = i;
+		}
+		for (size_t k = 0; k < dim; k++)
+		{
+			size_t pivot = k;
+			T pivotMag = a[k][k] < 0 ? -a[k][k] : a[k][k];
+			for (size_t i = k + 1; i < dim; i++)
+			{
+				const T mag = a[i][k] < 0 ? -a[i][k] : a[i][k];
+				if (mag > pivotMag)
+				{
+					pivot = i;
+					pivotMag = mag;
+				}
+			}
+			if (pivotMag == static_cast<T>(0))
+			{
+				dec.singular = true;
+				continue;
+			}
+			if (pivot != k)
+			{
+				std::swap(a[k], a[pivot]);
+				std::swap(dec.permutation[k], dec.permutation[pivot]);
+				dec.oddPermutation = !dec.oddPermutation;
+			}
+			const T invPivot = static_cast<T>(1) / a[k][k];
+			for (size_t i = k + 1; i < dim; i++)
+			{
+				const T factor = a[i][k] * invPivot;
+				a[i][k] = factor;
+				for (size_t j = k + 1; j < dim; j++)
+				{
+					a[i][j] -= factor * a[k][j];
+				}
+			}
+		}
+		return dec;
+	}
+
+	// Solves mat * x = rhs by partial-pivoting LU.
+	template<size_t dim, std::floating_point T>
+	constexpr Vector<T, dim> solve(const Matrix<dim, T>& mat, const Vector<T, dim>& rhs) noexcept
+	{
+		return lu_decompose(mat).solve(rhs);
+	}
+
+	// Affine helpers for 4x4 and 3x4 transforms acting on 3-vectors: points get the
+	// translation column (w = 1), directions do not (w = 0). No perspective divide is applied.
+	template<size_t rows, typename T> requires (rows == 3 || rows == 4)
+	constexpr Vector<T, 3> transform_point(const Matrix<rows, T, 4>& mat, const Vector<T, 3>& point) noexcept
+	{
+		using simd_t = simd::mat_traits<4, T>;
+		if constexpr (simd_t::enabled)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				Vector<T, 3> out{};
+				if constexpr (rows == 4)
+				{
+					simd_t::transform_point(mat.data(), point.data(), out.data());
+				}
+				else
+				{
+					simd_t::transform_point(simd_t::load_affine_columns(mat.data()), point.data(), out.data());
+				}
+				return out;
+			}
+		}
+		Vector<T, 3> out{};
+		for (size_t i = 0; i < 3; i++)
+		{
+			out[i] = mat[i][0] * point[0] + mat[i][1] * point[1] + mat[i][2] * point[2] + mat[i][3];
+		}
+		return out;
+	}
+
+	template<size_t rows, typename T> requires (rows == 3 || rows == 4)
+	constexpr Vector<T, 3> transform_vector(const Matrix<rows, T, 4>& mat, const Vector<T, 3>& vec) noexcept
+	{
+		Vector<T, 3> out{};
+		for (size_t i = 0; i < 3; i++)
+		{
+			out[i] = mat[i][0] * vec[0] + mat[i][1] * vec[1] + mat[i][2] * vec[2];
+		}
+		return out;
+	}
+
+	// 3x4 affine transform: the 4x4 with its constant [0 0 0 1] bottom row dropped, 48 bytes
+	// for float instead of 64.
+	template<typename T = float> using Affine3x4 = Matrix<3, T, 4>;
+	using Affine3x4f = Affine3x4<float>;
+
+	// lhs * rhs treating both as 4x4 with the implicit bottom row, i.e. rhs is applied first.
+	template<typename T>
+	constexpr Matrix<3, T, 4> compose(const Matrix<3, T, 4>& lhs, const Matrix<3, T, 4>& rhs) noexcept
+	{
+		Matrix<3, T, 4> out{};
+		for (size_t i = 0; i < 3; i++)
+		{
+			for (size_t j = 0; j < 4; j++)
+			{
+				T sum = j == 3 ? lhs[i][3] : T{};
+				for (size_t k = 0; k < 3; k++)
+				{
+					sum += lhs[i][k] * rhs[k][j];
+				}
+				out[i][j] = sum;
+			}
+		}
+		return out;
+	}
+
+	template<typename T>
+	constexpr Matrix<4, T> to_homogeneous(const Matrix<3, T, 4>& affine) noexcept
+	{
+		Matrix<4, T> out{};
+		for (size_t i = 0; i < 3; i++)
+		{
+			out[i] = affine[i];
+		}
+		out[3][3] = static_cast<T>(1);
+		return out;
+	}
+
+	// Drops the bottom row, which is only lossless when it is [0 0 0 1].
+	template<typename T>
+	constexpr Matrix<3, T, 4> to_affine(const Matrix<4, T>& mat) noexcept
+	{
+		Matrix<3, T, 4> out{};
+		for (size_t i = 0; i < 3; i++)
+		{
+			out[i] = mat[i];
+		}
+		return out;
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef CLM_MATRIX_SIMD_H
+#define CLM_MATRIX_SIMD_H
+
+#include <cstddef>
+#include <concepts>
+
+#include "clm_vector_simd.h"
+
+namespace clm::math::simd {
+	// Register kernels for row-major Matrix<dim, T>. Only the 4x4 float case is hand
+	// written; every other shape keeps the generic loops in clm_matrix.h.
+	template<size_t dim, typename T>
+	struct mat_traits
+	{
+		static constexpr bool enabled = false;
+		static constexpr size_t alignment = alignof(T);
+	};
+
+#ifdef CLM_SIMD_SSE
+	template<>
+	struct mat_traits<4, float>
+	{
+		static constexpr bool enabled = true;
+		static constexpr size_t alignment = 32;
+
+		static __m128 madd(__m128 a, __m128 b, __m128 c) noexcept
+		{
+#ifdef CLM_SIMD_FMA
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+
+		// out = lhs * rhs, all three 16 floats row-major. out may alias lhs or rhs.
+		static void mul(const float* lhs, const float* rhs, float* out) noexcept
+		{
+#ifdef CLM_SIMD_AVX
+			// Two rows of lhs per 256-bit register; each rhs row is duplicated into both
+			// halves so one broadcast-multiply-add serves two output rows.
+			__m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 0));
+			__m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 4));
+			__m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 8));
+			__m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 12));
+			__m256 a01 = _mm256_load_ps(lhs);
+			__m256 a23 = _mm256_load_ps(lhs + 8);
+			_mm256_store_ps(out, combine(a01, b0, b1, b2, b3));
+			_mm256_store_ps(out + 8, combine(a23, b0, b1, b2, b3));
+#else
+			__m128 b0 = _mm_load_ps(rhs + 0);
+			__m128 b1 = _mm_load_ps(rhs + 4);
+			__m128 b2 = _mm_load_ps(rhs + 8);
+			__m128 b3 = _mm_load_ps(rhs + 12);
+			__m128 rows[4];
+			for (size_t i = 0; i < 4; i++)
+			{
+				rows[i] = combine(_mm_load_ps(lhs + 4 * i), b0, b1, b2, b3);
+			}
+			for (size_t i = 0; i < 4; i++)
+			{
+				_mm_store_ps(out + 4 * i, rows[i]);
+			}
+#endif
+		}
+
+		// out = mat * vec for a row-major mat and 4-lane vec.
+		static void mul_vec(const float* mat, const float* vec, float* out) noexcept
+		{
+			_mm_store_ps(out, mul_vec(mat, _mm_load_ps(vec)));
+		}
+		static __m128 mul_vec(const float* mat, __m128 vec) noexcept
+		{
+			__m128 r0 = _mm_mul_ps(_mm_load_ps(mat + 0), vec);
+			__m128 r1 = _mm_mul_ps(_mm_load_ps(mat + 4), vec);
+			__m128 r2 = _mm_mul_ps(_mm_load_ps(mat + 8), vec);
+			__m128 r3 = _mm_mul_ps(_mm_load_ps(mat + 12), vec);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			return _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3));
+		}
+
+		// Columns of a row-major 4x4, the form used when many vectors go through one matrix.
+		struct columns
+		{
+			__m128 c0, c1, c2, c3;
+		};
+		static columns load_columns(const float* mat) noexcept
+		{
+			columns cols{_mm_load_ps(mat + 0), _mm_load_ps(mat + 4), _mm_load_ps(mat + 8), _mm_load_ps(mat + 12)};
+			_MM_TRANSPOSE4_PS(cols.c0, cols.c1, cols.c2, cols.c3);
+			return cols;
+		}
+		// Same for a 3x4 affine matrix (12 floats, only 4-byte aligned); the implicit bottom
+		// row is taken as zero so lane 3 of every transform result is 0.
+		static columns load_affine_columns(const float* mat) noexcept
+		{
+			columns cols{_mm_loadu_ps(mat + 0), _mm_loadu_ps(mat + 4), _mm_loadu_ps(mat + 8), _mm_setzero_ps()};
+			_MM_TRANSPOSE4_PS(cols.c0, cols.c1, cols.c2, cols.c3);
+			return cols;
+		}
+		// Returns mat * (x, y, z, w) where w is 1 for points and 0 for directions.
+		static __m128 transform(const columns& cols, __m128 vec, bool point) noexcept
+		{
+			__m128 out = point ? cols.c3 : _mm_setzero_ps();
+			out = madd(_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)), cols.c0, out);
+			out = madd(_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1)), cols.c1, out);
+			out = madd(_mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2)), cols.c2, out);
+			return out;
+		}
+		// out = mat * (point, 1) for a 16-byte aligned, padded 3-vector.
+		static void transform_point(const float* mat, const float* point, float* out) noexcept
+		{
+			transform_point(load_columns(mat), point, out);
+		}
+		static void transform_point(const columns& cols, const float* point, float* out) noexcept
+		{
+			_mm_store_ps(out, transform(cols, _mm_load_ps(point), true));
+		}
+	private:
+		static __m128 combine(__m128 row, __m128 b0, __m128 b1, __m128 b2, __m128 b3) noexcept
+		{
+			__m128 out = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			out = madd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1, out);
+			out = madd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2, out);
+			return madd(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3, out);
+		}
+#ifdef CLM_SIMD_AVX
+		static __m256 combine(__m256 rows, __m256 b0, __m256 b1, __m256 b2, __m256 b3) noexcept
+		{
+			__m256 out = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+#ifdef CLM_SIMD_FMA
+			out = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), b1, out);
+			out = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), b2, out);
+			return _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), b3, out);
+#else
+			out = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), b1), out);
+			out = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), b2), out);
+			return _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), b3), out);
+#endif
+		}
+#endif
+	};
+#endif
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "clm_rasterizer.h"
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include <clmUtil/clm_parallel.h>
+
+namespace clm::color {
+	namespace {
+		using math::Rect;
+		using fixed_point = math::Vector<std::int64_t, 2>;
+
+		constexpr std::int64_t one = std::int64_t{1} << TriangleRasterizer::subpixelBits;
+		constexpr std::int64_t half = one / 2;
+		constexpr std::int32_t blockSize = TiledImage::tileSize;
+
+		std::int64_t to_fixed(float value) noexcept
+		{
+			return static_cast<std::int64_t>(std::llround(static_cast<double>(value) * one));
+		}
+
+		std::int32_t floor_pixel(std::int64_t value) noexcept
+		{
+			return static_cast<std::int32_t>(value >> TriangleRasterizer::subpixelBits);
+		}
+
+		// Edges with the inside below (horizontal) or to the right own the pixels whose
+		// centres lie exactly on them.
+		bool top_left(std::int64_t dx, std::int64_t dy) noexcept
+		{
+			return dy < 0 || (dy == 0 && dx > 0);
+		}
+
+		// Edge i runs from vertex i to vertex i + 1; at the centre of pixel (px, py) its
+		// function is the cross product of the edge and the vertex-to-centre vector.
+		struct edge
+		{
+			std::int64_t value;
+			std::int64_t stepX;
+			std::int64_t stepY;
+		};
+
+		ColorRGBAf interpolate(const std::array<ColorRGBAf, 3>& colors, const std::array<std::int64_t, 3>& weights, double inverseArea) noexcept
+		{
+			// Edge i weighs the vertex opposite it.
+			const float w0 = static_cast<float>(static_cast<double>(weights[1]) * inverseArea);
+			const float w1 = static_cast<float>(static_cast<double>(weights[2]) * inverseArea);
+			const float w2 = static_cast<float>(static_cast<double>(weights[0]) * inverseArea);
+			const auto mix = [&](float ColorRGBAf::*channel) {
+				return colors[0].*channel * w0 + colors[1].*channel * w1 + colors[2].*channel * w2;
+			};
+			return ColorRGBAf{mix(&ColorRGBAf::r), mix(&ColorRGBAf::g), mix(&ColorRGBAf::b), mix(&ColorRGBAf::a)};
+		}
+
+		void put(ColorRGBAf& dst, const ColorRGBAf& color, bool blend) noexcept
+		{
+			if (!blend)
+			{
+				dst = color;
+				return;
+			}
+			const float keep = 1.0f - color.a;
+			dst = ColorRGBAf{color.r + dst.r * keep, color.g + dst.g * keep, color.b + dst.b * keep, color.a + dst.a * keep};
+		}
+	}
+
+	void TriangleRasterizer::shade(const Setup& tri, const Rect& area, TiledImage& image, const RasterOptions& options)
+	{
+		std::array<edge, 3> edges{};
+		const auto at = [&](size_t i, std::int32_t px, std::int32_t py) {
+			const size_t j = (i + 1) % 3;
+			const std::int64_t sx = px * one + half;
+			const std::int64_t sy = py * one + half;
+			return math::cross(fixed_point{tri.x[j] - tri.x[i], tri.y[j] - tri.y[i]}, fixed_point{sx - tri.x[i], sy - tri.y[i]}) + tri.bias[i];
+		};
+		for (size_t i = 0; i < 3; i++)
+		{
+			const size_t j = (i + 1) % 3;
+			edges[i].stepX = -(tri.y[j] - tri.y[i]) * one;
+			edges[i].stepY = (tri.x[j] - tri.x[i]) * one;
+		}
+		const double inverseArea = 1.0 / static_cast<double>(tri.area);
+		const bool flat = !options.interpolate;
+
+		// One image tile at a time: a tile entirely outside an edge is skipped, and one
+		// entirely inside all three is filled without per-pixel tests.
+		for (std::int32_t by = area.top; by < area.bottom; by = (by / blockSize + 1) * blockSize)
+		{
+			for (std::int32_t bx = area.left; bx < area.right; bx = (bx / blockSize + 1) * blockSize)
+			{
+				const Rect block = math::intersection(area, Rect{bx, by, (bx / blockSize + 1) * blockSize, (by / blockSize + 1) * blockSize});
+				bool outside = false;
+				bool inside = true;
+				for (size_t i = 0; i < 3 && !outside; i++)
+				{
+					const std::int64_t c0 = at(i, block.left, block.top);
+					const std::int64_t c1 = at(i, block.right - 1, block.top);
+					const std::int64_t c2 = at(i, block.left, block.bottom - 1);
+					const std::int64_t c3 = at(i, block.right - 1, block.bottom - 1);
+					outside = std::max({c0, c1, c2, c3}) <= 0;
+					inside = inside && std::min({c0, c1, c2, c3}) > 0;
+				}
+				if (outside)
+				{
+					continue;
+				}
+				if (inside && flat && !options.blend)
+				{
+					for (std::int32_t y = block.top; y < block.bottom; y++)
+					{
+						std::fill_n(&image.at(block.left, y), block.width(), tri.colors[0]);
+					}
+					continue;
+				}
+				for (size_t i = 0; i < 3; i++)
+				{
+					edges[i].value = at(i, block.left, block.top);
+				}
+				for (std::int32_t y = block.top; y < block.bottom; y++)
+				{
+					std::array<std::int64_t, 3> e{edges[0].value, edges[1].value, edges[2].value};
+					ColorRGBAf* row = &image.at(block.left, y);
+					for (std::int32_t x = 0; x < block.width(); x++)
+					{
+						if (e[0] > 0 && e[1] > 0 && e[2] > 0)
+						{
+							const std::array<std::int64_t, 3> weights{e[0] - tri.bias[0], e[1] - tri.bias[1], e[2] - tri.bias[2]};
+							put(row[x], flat ? tri.colors[0] : interpolate(tri.colors, weights, inverseArea), options.blend);
+						}
+						for (size_t i = 0; i < 3; i++)
+						{
+							e[i] += edges[i].stepX;
+						}
+					}
+					for (size_t i = 0; i < 3; i++)
+					{
+						edges[i].value += edges[i].stepY;
+					}
+				}
+			}
+		}
+	}
+
+	void TriangleRasterizer::draw(std::span<const RasterTriangle> triangles, ImageView target, const RasterOptions& options)
+	{
+		const Rect area = target.area();
+		if (area.empty())
+		{
+			return;
+		}
+
+		m_setups.clear();
+		for (const RasterTriangle& triangle : triangles)
+		{
+			Setup tri{};
+			bool valid = true;
+			for (size_t i = 0; i < 3; i++)
+			{
+				const math::Point2f& v = triangle.vertices[i];
+				valid = valid && std::abs(v[0]) < guardBand && std::abs(v[1]) < guardBand;
+				tri.x[i] = to_fixed(v[0]) + area.left * one;
+				tri.y[i] = to_fixed(v[1]) + area.top * one;
+			}
+			if (!valid)
+			{
+				continue;
+			}
+			tri.colors = triangle.colors;
+			tri.area = math::cross(fixed_point{tri.x[1] - tri.x[0], tri.y[1] - tri.y[0]}, fixed_point{tri.x[2] - tri.x[0], tri.y[2] - tri.y[0]});
+			if (tri.area == 0)
+			{
+				continue;
+			}
+			if (tri.area < 0)
+			{
+				std::swap(tri.x[1], tri.x[2]);
+				std::swap(tri.y[1], tri.y[2]);
+				std::swap(tri.colors[1], tri.colors[2]);
+				tri.area = -tri.area;
+			}
+			for (size_t i = 0; i < 3; i++)
+			{
+				const size_t j = (i + 1) % 3;
+				tri.bias[i] = top_left(tri.x[j] - tri.x[i], tri.y[j] - tri.y[i]) ? 1 : 0;
+			}
+			const auto [minX, maxX] = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
+			const auto [minY, maxY] = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
+			tri.bounds = math::intersection(area, Rect{floor_pixel(minX), floor_pixel(minY), floor_pixel(maxX) + 1, floor_pixel(maxY) + 1});
+			if (!tri.bounds.empty())
+			{
+				m_setups.push_back(tri);
+			}
+		}
+
+		// Bins line up with multiples of binSize in the image, so each is whole image tiles.
+		const std::int32_t bx0 = area.left / binSize;
+		const std::int32_t by0 = area.top / binSize;
+		const std::int32_t columns = (area.right - 1) / binSize - bx0 + 1;
+		const std::int32_t rows = (area.bottom - 1) / binSize - by0 + 1;
+		const size_t binCount = static_cast<size_t>(columns) * rows;
+		m_bins.resize(std::max(m_bins.size(), binCount));
+		for (size_t i = 0; i < binCount; i++)
+		{
+			m_bins[i].clear();
+		}
+		for (size_t t = 0; t < m_setups.size(); t++)
+		{
+			const Rect& b = m_setups[t].bounds;
+			for (std::int32_t y = b.top / binSize; y <= (b.bottom - 1) / binSize; y++)
+			{
+				for (std::int32_t x = b.left / binSize; x <= (b.right - 1) / binSize; x++)
+				{
+					m_bins[static_cast<size_t>(y - by0) * columns + (x - bx0)].push_back(static_cast<std::uint32_t>(t));
+				}
+			}
+		}
+
+		TiledImage& image = target.image();
+		util::parallel_for(binCount, [&](size_t i) {
+			const std::int32_t x = (bx0 + static_cast<std::int32_t>(i % columns)) * binSize;
+			const std::int32_t y = (by0 + static_cast<std::int32_t>(i / columns)) * binSize;
+			const Rect bin = math::intersection(area, Rect{x, y, x + binSize, y + binSize});
+			for (std::uint32_t t : m_bins[i])
+			{
+				shade(m_setups[t], math::intersection(bin, m_setups[t].bounds), image, options);
+			}
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef CLM_RASTERIZER_H
+#define CLM_RASTERIZER_H
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "clm_vector.h"
+#include "clm_image.h"
+
+// Software triangle rasterizer for rendering without a GPU. Vertices are snapped to 1/256
+// of a pixel and tested with integer edge functions at pixel centres under the top-left
+// fill rule, so triangles sharing an edge never both cover a pixel or leave a gap.
+// Triangles are binned into 64x64 pixel bins and the bins shaded in parallel, each in
+// submission order: the output does not depend on the number of threads.
+namespace clm::color {
+	struct RasterTriangle
+	{
+		// Pixel coordinates relative to the top-left of the target view, y down.
+		std::array<math::Point2f, 3> vertices;
+		// Premultiplied; only the first is used unless colors are interpolated.
+		std::array<ColorRGBAf, 3> colors;
+	};
+
+	struct RasterOptions
+	{
+		// Barycentric blend of the vertex colors instead of colors[0].
+		bool interpolate = false;
+		// Composite over the target instead of replacing it.
+		bool blend = false;
+	};
+
+	// Holds the bins between draws so a renderer issuing one draw per frame does not
+	// reallocate them.
+	class TriangleRasterizer
+	{
+	public:
+		static constexpr std::int32_t binSize = 64;
+		static constexpr std::int32_t subpixelBits = 8;
+		// Vertices must lie within this many pixels of the target origin; triangles
+		// reaching further are skipped, which keeps the edge functions within 64 bits.
+		static constexpr float guardBand = 32768.0f;
+
+		// Both windings are drawn; degenerate triangles cover nothing.
+		void draw(std::span<const RasterTriangle> triangles, ImageView target, const RasterOptions& options = {});
+
+	private:
+		// A triangle in fixed point, wound so its edge functions are positive inside.
+		struct Setup
+		{
+			std::array<std::int64_t, 3> x;
+			std::array<std::int64_t, 3> y;
+			// Added to each edge function before the > 0 test: 1 on top-left edges.
+			std::array<std::int64_t, 3> bias;
+			std::int64_t area;
+			math::Rect bounds;
+			std::array<ColorRGBAf, 3> colors;
+		};
+
+		// Covers the pixels of tri within area, which lies inside one bin.
+		static void shade(const Setup& tri, const math::Rect& area, TiledImage& image, const RasterOptions& options);
+
+		std::vector<Setup> m_setups;
+		std::vector<std::vector<std::uint32_t>> m_bins;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <clmUtil/clm_system.h>
 #include <utility>
+#include <algorithm>
 
 namespace clm::math {
 	struct Rect
@@ -44,8 +45,78 @@ namespace clm::math {
 			bottom = std::move(rhs.bottom);
 			return *this;
 		}
+
+		constexpr bool operator==(const Rect& rhs) const noexcept = default;
+
+		// Like RECT, right and bottom are exclusive: a rect covers [left, right) x [top, bottom)
+		// and holds nothing when either extent is zero or negative.
+		constexpr std::int32_t width() const noexcept { return right - left; }
+		constexpr std::int32_t height() const noexcept { return bottom - top; }
+		constexpr bool empty() const noexcept { return right <= left || bottom <= top; }
+
+		constexpr bool contains(std::int32_t x, std::int32_t y) const noexcept
+		{
+			return x >= left && x < right && y >= top && y < bottom;
+		}
+		// An empty rhs is contained only where it lies within the bounds.
+		constexpr bool contains(const Rect& rhs) const noexcept
+		{
+			return rhs.left >= left && rhs.right <= right && rhs.top >= top && rhs.bottom <= bottom;
+		}
+		// False whenever either is empty.
+		constexpr bool intersects(const Rect& rhs) const noexcept
+		{
+			return !empty() && !rhs.empty() && left < rhs.right && rhs.left < right && top < rhs.bottom && rhs.top < bottom;
+		}
 	};
 	typedef Rect Rect_t;
+
+	// Overlap of the two; empty (but not necessarily all zero) when they do not intersect.
+	constexpr Rect intersection(const Rect& lhs, const Rect& rhs) noexcept
+	{
+		return Rect{std::max(lhs.left, rhs.left), std::max(lhs.top, rhs.top),
+					std::min(lhs.right, rhs.right), std::min(lhs.bottom, rhs.bottom)};
+	}
+
+	// Smallest rect covering both. Empty operands are ignored.
+	constexpr Rect bounding_union(const Rect& lhs, const Rect& rhs) noexcept
+	{
+		if (lhs.empty())
+		{
+			return rhs;
+		}
+		if (rhs.empty())
+		{
+			return lhs;
+		}
+		return Rect{std::min(lhs.left, rhs.left), std::min(lhs.top, rhs.top),
+					std::max(lhs.right, rhs.right), std::max(lhs.bottom, rhs.bottom)};
+	}
+
+	namespace detail {
+		// dx * dx + dy * dy, saturating at the largest uint64_t instead of wrapping. A gap
+		// below 2^32 squares without overflow, but two of them can still sum past 2^64.
+		constexpr std::uint64_t sum_of_squares(std::uint64_t dx, std::uint64_t dy) noexcept
+		{
+			constexpr std::uint64_t saturated = ~std::uint64_t{0};
+			if (dx > 0xFFFFFFFFu || dy > 0xFFFFFFFFu)
+			{
+				return saturated;
+			}
+			const std::uint64_t sum = dx * dx + dy * dy;
+			return sum < dx * dx ? saturated : sum;
+		}
+	}
+
+	// Squared distance from (x, y) to the nearest covered point, 0 inside. Exact unless
+	// it exceeds the largest uint64_t, which only points about 2^32 apart on both axes do;
+	// those all saturate to that value.
+	constexpr std::uint64_t distance_sq(const Rect& rect, std::int32_t x, std::int32_t y) noexcept
+	{
+		const std::int64_t dx = x < rect.left ? std::int64_t{rect.left} - x : (x >= rect.right ? std::int64_t{x} - rect.right + 1 : 0);
+		const std::int64_t dy = y < rect.top ? std::int64_t{rect.top} - y : (y >= rect.bottom ? std::int64_t{y} - rect.bottom + 1 : 0);
+		return detail::sum_of_squares(static_cast<std::uint64_t>(dx), static_cast<std::uint64_t>(dy));
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#ifndef CLM_RECT_BATCH_H
+#define CLM_RECT_BATCH_H
+
+#include <array>
+#include <vector>
+#include <span>
+#include <cassert>
+#include <cstdint>
+
+#include <clmUtil/clm_aligned_alloc.h>
+
+#include "clm_rect.h"
+#include "clm_dispatch.h"
+
+namespace clm::math {
+	// Structure-of-arrays storage for many Rects: left, top, right and bottom each in
+	// their own 64-byte aligned array, the layout the dispatched Rect kernels take.
+	class RectBatch
+	{
+	public:
+		using side_t = std::vector<std::int32_t, util::aligned_allocator<std::int32_t>>;
+
+		enum side : size_t
+		{
+			left,
+			top,
+			right,
+			bottom
+		};
+
+		RectBatch() = default;
+		explicit RectBatch(size_t count)
+		{
+			resize(count);
+		}
+		explicit RectBatch(std::span<const Rect> rects)
+		{
+			load(rects);
+		}
+		~RectBatch() = default;
+		RectBatch(const RectBatch&) = default;
+		RectBatch(RectBatch&&) noexcept = default;
+		RectBatch& operator=(const RectBatch&) = default;
+		RectBatch& operator=(RectBatch&&) noexcept = default;
+
+		size_t size() const noexcept
+		{
+			return m_sides[0].size();
+		}
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+		void resize(size_t count)
+		{
+			for (auto& values : m_sides)
+			{
+				values.resize(count);
+			}
+		}
+		void reserve(size_t count)
+		{
+			for (auto& values : m_sides)
+			{
+				values.reserve(count);
+			}
+		}
+		void clear() noexcept
+		{
+			for (auto& values : m_sides)
+			{
+				values.clear();
+			}
+		}
+
+		std::int32_t* values(side s) noexcept
+		{
+			return m_sides[s].data();
+		}
+		const std::int32_t* values(side s) const noexcept
+		{
+			return m_sides[s].data();
+		}
+		std::array<std::int32_t*, 4> sides() noexcept
+		{
+			return {values(left), values(top), values(right), values(bottom)};
+		}
+		std::array<const std::int32_t*, 4> sides() const noexcept
+		{
+			return {values(left), values(top), values(right), values(bottom)};
+		}
+
+		Rect get(size_t index) const noexcept
+		{
+			return Rect{m_sides[left][index], m_sides[top][index], m_sides[right][index], m_sides[bottom][index]};
+		}
+		void set(size_t index, const Rect& rect) noexcept
+		{
+			m_sides[left][index] = rect.left;
+			m_sides[top][index] = rect.top;
+			m_sides[right][index] = rect.right;
+			m_sides[bottom][index] = rect.bottom;
+		}
+		void push_back(const Rect& rect)
+		{
+			m_sides[left].push_back(rect.left);
+			m_sides[top].push_back(rect.top);
+			m_sides[right].push_back(rect.right);
+			m_sides[bottom].push_back(rect.bottom);
+		}
+
+		// Transposes an array of Rects into the batch, replacing its contents.
+		void load(std::span<const Rect> rects)
+		{
+			resize(rects.size());
+			for (size_t i = 0; i < rects.size(); i++)
+			{
+				set(i, rects[i]);
+			}
+		}
+		// Transposes the batch back out; out must hold at least size() rects.
+		void store(std::span<Rect> out) const noexcept
+		{
+			assert(out.size() >= size());
+			for (size_t i = 0; i < size(); i++)
+			{
+				out[i] = get(i);
+			}
+		}
+	private:
+		std::array<side_t, 4> m_sides;
+	};
+
+	// The queries below replace the contents of indices with the ascending positions of
+	// the matching rects and return how many there are. Matches agree with Rect::intersects
+	// and Rect::contains, so empty rects never match.
+
+	// Rects intersecting area.
+	inline size_t intersecting(const RectBatch& rects, const Rect& area, std::vector<std::uint32_t>& indices)
+	{
+		const std::int32_t box[4]{area.left, area.top, area.right, area.bottom};
+		indices.resize(rects.size());
+		indices.resize(dispatch::rect_kernels().intersecting(rects.sides().data(), rects.size(), box, indices.data()));
+		return indices.size();
+	}
+
+	// Rects containing (x, y).
+	inline size_t containing(const RectBatch& rects, std::int32_t x, std::int32_t y, std::vector<std::uint32_t>& indices)
+	{
+		indices.resize(rects.size());
+		indices.resize(dispatch::rect_kernels().containing(rects.sides().data(), rects.size(), x, y, indices.data()));
+		return indices.size();
+	}
+
+	// Every rect intersected with area into out, which may be rects itself; indices gets
+	// the ones left non-empty.
+	inline size_t clip(const RectBatch& rects, const Rect& area, RectBatch& out, std::vector<std::uint32_t>& indices)
+	{
+		const std::int32_t box[4]{area.left, area.top, area.right, area.bottom};
+		out.resize(rects.size());
+		indices.resize(rects.size());
+		indices.resize(dispatch::rect_kernels().clip(rects.sides().data(), rects.size(), box, out.sides().data(), indices.data()));
+		return indices.size();
+	}
+
+	// Bounding union of the non-empty rects; all zero if there are none.
+	inline Rect bounds(const RectBatch& rects) noexcept
+	{
+		std::int32_t box[4]{};
+		dispatch::rect_kernels().bounds(rects.sides().data(), rects.size(), box);
+		return Rect{box[0], box[1], box[2], box[3]};
+	}
+
+	// width() * height() of each rect, exact in 64 bits; 0 for empty rects.
+	inline void area(const RectBatch& rects, std::span<std::uint64_t> out) noexcept
+	{
+		assert(out.size() >= rects.size());
+		dispatch::rect_kernels().area(rects.sides().data(), rects.size(), out.data());
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include "clm_segment_intersection.h"
+#include "clm_geo.h"
+#include "clm_dispatch.h"
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <cmath>
+
+namespace clm::math {
+	namespace {
+		using index_pair = std::pair<std::uint32_t, std::uint32_t>;
+
+		// Both input precisions are handled in double, as the predicates in clm_geo.h
+		// already evaluate float input that way. Every segment is stored with its first
+		// endpoint before its second in (x, y) order.
+		struct segment_set
+		{
+			std::vector<double> x0;
+			std::vector<double> y0;
+			std::vector<double> x1;
+			std::vector<double> y1;
+
+			size_t size() const noexcept
+			{
+				return x0.size();
+			}
+
+			bool intersect(std::uint32_t a, std::uint32_t b) const noexcept
+			{
+				return detail::segments_intersect(x0[a], y0[a], x1[a], y1[a], x0[b], y0[b], x1[b], y1[b]);
+			}
+
+			Point2<double> intersection(std::uint32_t a, std::uint32_t b) const noexcept
+			{
+				return detail::intersection_point(x0[a], y0[a], x1[a], y1[a], x0[b], y0[b], x1[b], y1[b]);
+			}
+		};
+
+		template<typename T>
+		segment_set to_soa(std::span<const Point2<T>> starts, std::span<const Point2<T>> ends)
+		{
+			segment_set set;
+			const size_t count = std::min(starts.size(), ends.size());
+			set.x0.reserve(count);
+			set.y0.reserve(count);
+			set.x1.reserve(count);
+			set.y1.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				double ax = starts[i][0];
+				double ay = starts[i][1];
+				double bx = ends[i][0];
+				double by = ends[i][1];
+				if (bx < ax || (bx == ax && by < ay))
+				{
+					std::swap(ax, bx);
+					std::swap(ay, by);
+				}
+				set.x0.push_back(ax);
+				set.y0.push_back(ay);
+				set.x1.push_back(bx);
+				set.y1.push_back(by);
+			}
+			return set;
+		}
+
+		std::vector<index_pair> brute_force(const segment_set& set)
+		{
+			const dispatch::geometry_kernel_table& kernels = dispatch::geometry_kernels();
+			const double* arrays[4]{set.x0.data(), set.y0.data(), set.x1.data(), set.y1.data()};
+			std::vector<std::uint32_t> row(set.size());
+			std::vector<index_pair> pairs;
+			for (size_t i = 0; i + 1 < set.size(); i++)
+			{
+				const size_t hits = kernels.segment_hits(arrays, i, i + 1, set.size(), row.data());
+				for (size_t h = 0; h < hits; h++)
+				{
+					pairs.emplace_back(static_cast<std::uint32_t>(i), row[h]);
+				}
+			}
+			return pairs;
+		}
+
+		// Bentley-Ottmann. Events are visited in (x, y) order, so a vertical segment is
+		// entered at its lower end and left at its upper one.
+		//
+		// The sweep status is a plain vector kept in order by the events themselves:
+		// positions are searched with the current y of each segment, but an element only
+		// ever moves through an explicit swap. Rounding can therefore misplace a segment
+		// locally, but never corrupt the structure the way an inconsistent comparator
+		// corrupts a tree. Any two segments that become neighbours are tested; insertions
+		// and removals keep testing outward while segments still touch the one being
+		// added or removed, which catches several segments meeting at an endpoint.
+		class sweep
+		{
+		public:
+			explicit sweep(const segment_set& set)
+				:
+				m_set(set),
+				m_active(set.size(), false)
+			{
+				m_pairs.reserve(2 * set.size());
+			}
+
+			std::vector<index_pair> run()
+			{
+				std::vector<event> endpoints;
+				endpoints.reserve(2 * m_set.size());
+				for (std::uint32_t i = 0; i < m_set.size(); i++)
+				{
+					if (std::isnan(m_set.x0[i]) || std::isnan(m_set.y0[i]) ||
+						std::isnan(m_set.x1[i]) || std::isnan(m_set.y1[i]))
+					{
+						continue;
+					}
+					endpoints.push_back({m_set.x0[i], m_set.y0[i], event_kind::insert, i, i});
+					endpoints.push_back({m_set.x1[i], m_set.y1[i], event_kind::remove, i, i});
+				}
+				std::sort(endpoints.begin(), endpoints.end(), before);
+
+				size_t next = 0;
+				while (next < endpoints.size() || !m_crossings.empty())
+				{
+					event current{};
+					if (!m_crossings.empty() && (next == endpoints.size() || before(m_crossings.top(), endpoints[next])))
+					{
+						current = m_crossings.top();
+						m_crossings.pop();
+					}
+					else
+					{
+						current = endpoints[next++];
+					}
+					m_x = current.x;
+					m_y = current.y;
+					switch (current.kind)
+					{
+					case event_kind::cross: cross(current.a, current.b); break;
+					case event_kind::insert: insert(current.a); break;
+					case event_kind::remove: remove(current.a); break;
+					}
+				}
+				return std::move(m_hits);
+			}
+
+		private:
+			// At one point, crossings are settled before segments start or end there.
+			enum class event_kind : std::uint8_t
+			{
+				cross,
+				insert,
+				remove
+			};
+
+			struct event
+			{
+				double x;
+				double y;
+				event_kind kind;
+				std::uint32_t a;
+				std::uint32_t b;
+			};
+
+			static bool before(const event& lhs, const event& rhs) noexcept
+			{
+				if (lhs.x != rhs.x) return lhs.x < rhs.x;
+				if (lhs.y != rhs.y) return lhs.y < rhs.y;
+				if (lhs.kind != rhs.kind) return lhs.kind < rhs.kind;
+				if (lhs.a != rhs.a) return lhs.a < rhs.a;
+				return lhs.b < rhs.b;
+			}
+
+			struct after
+			{
+				bool operator()(const event& lhs, const event& rhs) const noexcept
+				{
+					return before(rhs, lhs);
+				}
+			};
+
+			enum pair_flags : std::uint8_t
+			{
+				reported = 1,
+				scheduled = 2,
+				settled = 4
+			};
+
+			static std::uint64_t key(std::uint32_t a, std::uint32_t b) noexcept
+			{
+				return a < b ? (std::uint64_t{a} << 32) | b : (std::uint64_t{b} << 32) | a;
+			}
+
+			// Height of s on the sweep line; a vertical segment is wherever the sweep point
+			// is along it.
+			double y_at(std::uint32_t s) const noexcept
+			{
+				const double x0 = m_set.x0[s];
+				const double x1 = m_set.x1[s];
+				if (x0 == x1)
+				{
+					return std::clamp(m_y, m_set.y0[s], m_set.y1[s]);
+				}
+				if (m_x <= x0)
+				{
+					return m_set.y0[s];
+				}
+				if (m_x >= x1)
+				{
+					return m_set.y1[s];
+				}
+				return m_set.y0[s] + (m_x - x0) * (m_set.y1[s] - m_set.y0[s]) / (x1 - x0);
+			}
+
+			// Whether a runs below b just past a point both pass through: a turns right of b,
+			// or the two are collinear and a has the lower index.
+			bool below_after(std::uint32_t a, std::uint32_t b) const noexcept
+			{
+				const double side = (m_set.x1[b] - m_set.x0[b]) * (m_set.y1[a] - m_set.y0[a]) -
+					(m_set.y1[b] - m_set.y0[b]) * (m_set.x1[a] - m_set.x0[a]);
+				return side < 0.0 || (side == 0.0 && a < b);
+			}
+
+			size_t locate(std::uint32_t s) const noexcept
+			{
+				const double y = y_at(s);
+				const size_t guess = static_cast<size_t>(std::partition_point(m_status.begin(), m_status.end(),
+					[&](std::uint32_t other) { return y_at(other) < y; }) - m_status.begin());
+				for (size_t d = 0; d <= m_status.size(); d++)
+				{
+					if (guess + d < m_status.size() && m_status[guess + d] == s)
+					{
+						return guess + d;
+					}
+					if (d <= guess && d > 0 && m_status[guess - d] == s)
+					{
+						return guess - d;
+					}
+				}
+				return m_status.size();
+			}
+
+			// Reports a and b if they intersect, and schedules the point where their order
+			// on the sweep line gets settled, never earlier than the current event.
+			bool test(std::uint32_t a, std::uint32_t b)
+			{
+				if (a == b || !m_set.intersect(a, b))
+				{
+					return false;
+				}
+				std::uint8_t& flags = m_pairs[key(a, b)];
+				if ((flags & reported) == 0)
+				{
+					flags |= reported;
+					m_hits.emplace_back(std::min(a, b), std::max(a, b));
+				}
+				if ((flags & (scheduled | settled)) == 0)
+				{
+					flags |= scheduled;
+					const Point2<double> p = m_set.intersection(a, b);
+					event crossing{p[0], p[1], event_kind::cross, a, b};
+					if (crossing.x < m_x || (crossing.x == m_x && crossing.y < m_y))
+					{
+						crossing.x = m_x;
+						crossing.y = m_y;
+					}
+					m_crossings.push(crossing);
+				}
+				return true;
+			}
+
+			void test_outward(size_t pos)
+			{
+				const std::uint32_t s = m_status[pos];
+				for (size_t k = pos; k-- > 0;)
+				{
+					if (!test(m_status[k], s))
+					{
+						break;
+					}
+				}
+				for (size_t k = pos + 1; k < m_status.size(); k++)
+				{
+					if (!test(s, m_status[k]))
+					{
+						break;
+					}
+				}
+			}
+
+			void insert(std::uint32_t s)
+			{
+				// Below s at its start point: lower there, or through the point and turning
+				// right of s.
+				const auto it = std::partition_point(m_status.begin(), m_status.end(), [&](std::uint32_t other) {
+					const double y = y_at(other);
+					return y != m_y ? y < m_y : below_after(other, s);
+				});
+				const size_t pos = static_cast<size_t>(it - m_status.begin());
+				m_status.insert(it, s);
+				m_active[s] = true;
+				test_outward(pos);
+			}
+
+			void remove(std::uint32_t s)
+			{
+				const size_t pos = locate(s);
+				if (pos == m_status.size())
+				{
+					return;
+				}
+				test_outward(pos);
+				m_status.erase(m_status.begin() + static_cast<std::ptrdiff_t>(pos));
+				m_active[s] = false;
+				if (pos > 0 && pos < m_status.size())
+				{
+					test(m_status[pos - 1], m_status[pos]);
+				}
+			}
+
+			// Swaps a and b if they are neighbours in the wrong order for past this point.
+			// A pair found apart goes back to unscheduled, so it is tried again when the two
+			// next meet.
+			void cross(std::uint32_t a, std::uint32_t b)
+			{
+				std::uint8_t& flags = m_pairs[key(a, b)];
+				flags &= static_cast<std::uint8_t>(~scheduled);
+				if (!m_active[a] || !m_active[b])
+				{
+					return;
+				}
+				size_t lower = locate(a);
+				if (lower + 1 >= m_status.size() || m_status[lower + 1] != b)
+				{
+					if (lower == 0 || lower >= m_status.size() || m_status[lower - 1] != b)
+					{
+						return;
+					}
+					lower--;
+				}
+				flags |= settled;
+				if (!below_after(m_status[lower + 1], m_status[lower]))
+				{
+					return;
+				}
+				std::swap(m_status[lower], m_status[lower + 1]);
+				if (lower > 0)
+				{
+					test(m_status[lower - 1], m_status[lower]);
+				}
+				if (lower + 2 < m_status.size())
+				{
+					test(m_status[lower + 1], m_status[lower + 2]);
+				}
+			}
+
+			const segment_set& m_set;
+			std::vector<bool> m_active;
+			std::vector<std::uint32_t> m_status;
+			std::priority_queue<event, std::vector<event>, after> m_crossings;
+			std::unordered_map<std::uint64_t, std::uint8_t> m_pairs;
+			std::vector<index_pair> m_hits;
+			double m_x = 0.0;
+			double m_y = 0.0;
+		};
+
+		// Below this many segments the quadratic kernel beats the sweep's bookkeeping.
+		constexpr size_t bruteForceLimit = 2048;
+	}
+
+	template<std::floating_point T>
+	std::vector<segment_hit<T>> find_intersections(std::span<const Point2<T>> starts,
+												   std::span<const Point2<T>> ends,
+												   intersection_method method)
+	{
+		const segment_set set = to_soa(starts, ends);
+		if (method == intersection_method::automatic)
+		{
+			method = set.size() < bruteForceLimit ? intersection_method::brute_force : intersection_method::sweep;
+		}
+		std::vector<index_pair> pairs = method == intersection_method::sweep ? sweep(set).run() : brute_force(set);
+		std::sort(pairs.begin(), pairs.end());
+
+		std::vector<segment_hit<T>> hits;
+		hits.reserve(pairs.size());
+		for (const auto& [first, second] : pairs)
+		{
+			const Point2<double> p = set.intersection(first, second);
+			hits.push_back({first, second, Point2<T>{static_cast<T>(p[0]), static_cast<T>(p[1])}});
+		}
+		return hits;
+	}
+
+	template std::vector<segment_hit<float>> find_intersections<float>(
+		std::span<const Point2<float>>, std::span<const Point2<float>>, intersection_method);
+	template std::vector<segment_hit<double>> find_intersections<double>(
+		std::span<const Point2<double>>, std::span<const Point2<double>>, intersection_method);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef CLM_SEGMENT_INTERSECTION_H
+#define CLM_SEGMENT_INTERSECTION_H
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <concepts>
+
+#include "clm_vector.h"
+
+namespace clm::math {
+	// One intersecting pair, by index into the input spans (first < second), and a point
+	// the two segments share. For collinear overlaps the point is the start of the overlap
+	// in (x, y) order.
+	template<std::floating_point T>
+	struct segment_hit
+	{
+		std::uint32_t first;
+		std::uint32_t second;
+		Point2<T> point;
+	};
+
+	enum class intersection_method
+	{
+		automatic,
+		// Bentley-Ottmann, O((n + k) log n) for k intersections.
+		sweep,
+		// Every pair through the dispatched SIMD kernel, O(n^2); fastest for small n.
+		brute_force
+	};
+
+	// Segment i runs from starts[i] to ends[i]. Returns every pair of closed segments that
+	// share a point, touching endpoints and collinear overlaps included, sorted by
+	// (first, second). Both methods decide intersection with the same orientation test as
+	// lines_intersect and report the same pairs on general input; with several segments
+	// meeting in nearly one point, the sweep's result depends on how the crossing points
+	// round. automatic picks brute_force below about two thousand segments.
+	template<std::floating_point T>
+	std::vector<segment_hit<T>> find_intersections(std::span<const Point2<T>> starts,
+												   std::span<const Point2<T>> ends,
+												   intersection_method method = intersection_method::automatic);
+
+	extern template std::vector<segment_hit<float>> find_intersections<float>(
+		std::span<const Point2<float>>, std::span<const Point2<float>>, intersection_method);
+	extern template std::vector<segment_hit<double>> find_intersections<double>(
+		std::span<const Point2<double>>, std::span<const Point2<double>>, intersection_method);
+}
+
+#endif
\ No newline at end of file
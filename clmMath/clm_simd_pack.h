@@ -0,0 +1,554 @@
+#ifndef CLM_SIMD_PACK_H
+#define CLM_SIMD_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <utility>
+
+#include "clm_vector_simd.h"
+
+// The dispatch sources include this header under their own instruction set flags, next to
+// ordinary code built for the baseline. The packs' member functions are inline with
+// external linkage, so each flag set gets its own inline namespace and with it its own
+// mangled names; otherwise the linker could keep an AVX copy for a caller on an SSE2 CPU.
+#if defined(CLM_SIMD_AVX512)
+#define CLM_SIMD_ISA_NAMESPACE isa_avx512
+#elif defined(CLM_SIMD_AVX2) && defined(CLM_SIMD_FMA)
+#define CLM_SIMD_ISA_NAMESPACE isa_avx2
+#elif defined(CLM_SIMD_AVX)
+#define CLM_SIMD_ISA_NAMESPACE isa_avx
+#elif defined(CLM_SIMD_SSE)
+#define CLM_SIMD_ISA_NAMESPACE isa_sse2
+#else
+#define CLM_SIMD_ISA_NAMESPACE isa_scalar
+#endif
+
+namespace clm::math::simd {
+inline namespace CLM_SIMD_ISA_NAMESPACE {
+	// A pack is the widest register the build targets, viewed as width lanes of T.
+	// Batch kernels are written once against this interface. scalar_pack is the single
+	// lane version used for loop tails, integral types and CLM_NO_SIMD builds.
+	template<typename T>
+	struct scalar_pack
+	{
+		using reg_t = T;
+		static constexpr size_t width = 1;
+
+		static reg_t load(const T* ptr) noexcept { return *ptr; }
+		static void store(T* ptr, reg_t val) noexcept { *ptr = val; }
+		static reg_t set1(T val) noexcept { return val; }
+		static reg_t zero() noexcept { return T{}; }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return lhs + rhs; }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return lhs - rhs; }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return lhs * rhs; }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return lhs / rhs; }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return a * b + c; }
+		static reg_t sqrt(reg_t val) noexcept { return static_cast<T>(std::sqrt(val)); }
+	};
+
+	template<typename T>
+	struct pack : scalar_pack<T> {};
+
+	// The packs for each instruction set carry their own names so the per-ISA dispatch
+	// sources (clm_dispatch.h) can pick one explicitly; pack<T> is whichever is widest in
+	// this build.
+#if defined(CLM_SIMD_SSE)
+	template<typename T> struct sse_pack;
+
+	template<>
+	struct sse_pack<float>
+	{
+		using reg_t = __m128;
+		static constexpr size_t width = 4;
+
+		static reg_t load(const float* ptr) noexcept { return _mm_loadu_ps(ptr); }
+		static void store(float* ptr, reg_t val) noexcept { _mm_storeu_ps(ptr, val); }
+		static reg_t set1(float val) noexcept { return _mm_set1_ps(val); }
+		static reg_t zero() noexcept { return _mm_setzero_ps(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm_add_ps(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm_sub_ps(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm_mul_ps(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm_div_ps(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm_sqrt_ps(val); }
+
+		// Lane masks, integer lanes and bit operations for the polynomial approximations
+		// in clm_dispatch_approx.h. to_int rounds to nearest.
+		using ireg_t = __m128i;
+		using mask_t = __m128;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm_min_ps(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm_max_ps(lhs, rhs); }
+		static reg_t abs(reg_t val) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), val); }
+		static reg_t bit_xor(reg_t lhs, reg_t rhs) noexcept { return _mm_xor_ps(lhs, rhs); }
+		static reg_t rsqrt_est(reg_t val) noexcept { return _mm_rsqrt_ps(val); }
+		static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm_cmplt_ps(lhs, rhs); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm_cmpge_ps(lhs, rhs); }
+		static mask_t cmp_eq(reg_t lhs, reg_t rhs) noexcept { return _mm_cmpeq_ps(lhs, rhs); }
+		static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept
+		{
+			return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+		}
+		static bool any(mask_t mask) noexcept { return _mm_movemask_ps(mask) != 0; }
+
+		static ireg_t to_int(reg_t val) noexcept { return _mm_cvtps_epi32(val); }
+		static reg_t to_float(ireg_t val) noexcept { return _mm_cvtepi32_ps(val); }
+		static ireg_t as_int(reg_t val) noexcept { return _mm_castps_si128(val); }
+		static reg_t as_float(ireg_t val) noexcept { return _mm_castsi128_ps(val); }
+		static ireg_t iset1(std::int32_t val) noexcept { return _mm_set1_epi32(val); }
+		static ireg_t iadd(ireg_t lhs, ireg_t rhs) noexcept { return _mm_add_epi32(lhs, rhs); }
+		static ireg_t isub(ireg_t lhs, ireg_t rhs) noexcept { return _mm_sub_epi32(lhs, rhs); }
+		static ireg_t iand(ireg_t lhs, ireg_t rhs) noexcept { return _mm_and_si128(lhs, rhs); }
+		static ireg_t ior(ireg_t lhs, ireg_t rhs) noexcept { return _mm_or_si128(lhs, rhs); }
+		template<int bits> static ireg_t shl(ireg_t val) noexcept { return _mm_slli_epi32(val, bits); }
+		template<int bits> static ireg_t shr(ireg_t val) noexcept { return _mm_srli_epi32(val, bits); }
+		static mask_t ieq(ireg_t lhs, ireg_t rhs) noexcept { return _mm_castsi128_ps(_mm_cmpeq_epi32(lhs, rhs)); }
+
+		// Pixel operations for the color kernels (clm_dispatch_color.h). load_u8 widens
+		// width bytes to int lanes; store_u8 narrows them back, saturating to [0, 255].
+		// spread_alpha copies lane 3 of every group of four over the group, and load_rgba
+		// splits width interleaved RGBA pixels into one register per channel.
+		static ireg_t load_u8(const std::uint8_t* ptr) noexcept
+		{
+			std::int32_t bytes;
+			std::memcpy(&bytes, ptr, sizeof(bytes));
+			const __m128i zero = _mm_setzero_si128();
+			return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+		}
+		static void store_u8(std::uint8_t* ptr, ireg_t val) noexcept
+		{
+			const __m128i words = _mm_packs_epi32(val, val);
+			const std::int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+			std::memcpy(ptr, &bytes, sizeof(bytes));
+		}
+		static reg_t spread_alpha(reg_t val) noexcept { return _mm_shuffle_ps(val, val, 0xFF); }
+		static void load_rgba(const float* ptr, reg_t& r, reg_t& g, reg_t& b, reg_t& a) noexcept
+		{
+			r = _mm_loadu_ps(ptr);
+			g = _mm_loadu_ps(ptr + 4);
+			b = _mm_loadu_ps(ptr + 8);
+			a = _mm_loadu_ps(ptr + 12);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+		}
+	};
+
+	template<>
+	struct sse_pack<double>
+	{
+		using reg_t = __m128d;
+		static constexpr size_t width = 2;
+
+		static reg_t load(const double* ptr) noexcept { return _mm_loadu_pd(ptr); }
+		static void store(double* ptr, reg_t val) noexcept { _mm_storeu_pd(ptr, val); }
+		static reg_t set1(double val) noexcept { return _mm_set1_pd(val); }
+		static reg_t zero() noexcept { return _mm_setzero_pd(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm_add_pd(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm_sub_pd(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm_mul_pd(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm_div_pd(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm_sqrt_pd(val); }
+
+		// Comparisons and lane masks for the geometry kernels (clm_dispatch_geometry.h).
+		// bits gives one bit per lane, lane 0 in bit 0.
+		using mask_t = __m128d;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm_min_pd(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm_max_pd(lhs, rhs); }
+		static mask_t cmp_le(reg_t lhs, reg_t rhs) noexcept { return _mm_cmple_pd(lhs, rhs); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm_cmpge_pd(lhs, rhs); }
+		static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return _mm_and_pd(lhs, rhs); }
+		static mask_t mask_or(mask_t lhs, mask_t rhs) noexcept { return _mm_or_pd(lhs, rhs); }
+		static std::uint32_t bits(mask_t mask) noexcept { return static_cast<std::uint32_t>(_mm_movemask_pd(mask)); }
+	};
+
+	namespace detail {
+		// 32-bit integer lanes for the SSE2 and AVX sources; AVX has no 256-bit integer
+		// instructions, so both use xmm registers. The isa parameter gives each source its
+		// own instantiation, so the linker cannot swap the VEX encoded copy in for the SSE2 one.
+		template<int isa>
+		struct int32x4_pack
+		{
+			using reg_t = __m128i;
+			using mask_t = __m128i;
+			static constexpr size_t width = 4;
+
+			static reg_t load(const std::int32_t* ptr) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+			static void store(std::int32_t* ptr, reg_t val) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), val); }
+			static reg_t set1(std::int32_t val) noexcept { return _mm_set1_epi32(val); }
+			static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm_sub_epi32(lhs, rhs); }
+			static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm_cmplt_epi32(lhs, rhs); }
+			static mask_t cmp_gt(reg_t lhs, reg_t rhs) noexcept { return _mm_cmpgt_epi32(lhs, rhs); }
+			static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept
+			{
+				return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+			}
+			// pminsd and pmaxsd need SSE4.1.
+			static reg_t min(reg_t lhs, reg_t rhs) noexcept { return select(cmp_lt(lhs, rhs), lhs, rhs); }
+			static reg_t max(reg_t lhs, reg_t rhs) noexcept { return select(cmp_gt(lhs, rhs), lhs, rhs); }
+			static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return _mm_and_si128(lhs, rhs); }
+			static mask_t mask_and_not(mask_t mask, mask_t excluded) noexcept { return _mm_andnot_si128(excluded, mask); }
+			static std::uint32_t bits(mask_t mask) noexcept { return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask))); }
+			// Products of the lanes read as unsigned, widened to 64 bits: width values to out.
+			static void store_product_u64(std::uint64_t* out, reg_t lhs, reg_t rhs) noexcept
+			{
+				const __m128i zero = _mm_setzero_si128();
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_mul_epu32(_mm_unpacklo_epi32(lhs, zero), _mm_unpacklo_epi32(rhs, zero)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2), _mm_mul_epu32(_mm_unpackhi_epi32(lhs, zero), _mm_unpackhi_epi32(rhs, zero)));
+			}
+		};
+	}
+
+	// Only the operations the Rect kernels (clm_dispatch_geometry.h) need.
+	template<>
+	struct sse_pack<std::int32_t> : detail::int32x4_pack<0> {};
+#endif
+#if defined(CLM_SIMD_AVX)
+	template<typename T> struct avx_pack;
+
+	template<>
+	struct avx_pack<float>
+	{
+		using reg_t = __m256;
+		static constexpr size_t width = 8;
+
+		static reg_t load(const float* ptr) noexcept { return _mm256_loadu_ps(ptr); }
+		static void store(float* ptr, reg_t val) noexcept { _mm256_storeu_ps(ptr, val); }
+		static reg_t set1(float val) noexcept { return _mm256_set1_ps(val); }
+		static reg_t zero() noexcept { return _mm256_setzero_ps(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm256_add_ps(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm256_sub_ps(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm256_mul_ps(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm256_div_ps(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm256_sqrt_ps(val); }
+
+		// Same extra operations as sse_pack<float>. AVX has no 256-bit integer arithmetic,
+		// so those run as two 128-bit halves here and natively in avx2_pack.
+		using ireg_t = __m256i;
+		using mask_t = __m256;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm256_min_ps(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm256_max_ps(lhs, rhs); }
+		static reg_t abs(reg_t val) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), val); }
+		static reg_t bit_xor(reg_t lhs, reg_t rhs) noexcept { return _mm256_xor_ps(lhs, rhs); }
+		static reg_t rsqrt_est(reg_t val) noexcept { return _mm256_rsqrt_ps(val); }
+		static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmp_ps(lhs, rhs, _CMP_GE_OQ); }
+		static mask_t cmp_eq(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ); }
+		static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+		static bool any(mask_t mask) noexcept { return _mm256_movemask_ps(mask) != 0; }
+
+		static ireg_t to_int(reg_t val) noexcept { return _mm256_cvtps_epi32(val); }
+		static reg_t to_float(ireg_t val) noexcept { return _mm256_cvtepi32_ps(val); }
+		static ireg_t as_int(reg_t val) noexcept { return _mm256_castps_si256(val); }
+		static reg_t as_float(ireg_t val) noexcept { return _mm256_castsi256_ps(val); }
+		static ireg_t iset1(std::int32_t val) noexcept { return _mm256_set1_epi32(val); }
+		static ireg_t iand(ireg_t lhs, ireg_t rhs) noexcept { return as_int(_mm256_and_ps(as_float(lhs), as_float(rhs))); }
+		static ireg_t ior(ireg_t lhs, ireg_t rhs) noexcept { return as_int(_mm256_or_ps(as_float(lhs), as_float(rhs))); }
+		static ireg_t iadd(ireg_t lhs, ireg_t rhs) noexcept { return halves(lhs, rhs, [](__m128i a, __m128i b) { return _mm_add_epi32(a, b); }); }
+		static ireg_t isub(ireg_t lhs, ireg_t rhs) noexcept { return halves(lhs, rhs, [](__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }); }
+		template<int bits> static ireg_t shl(ireg_t val) noexcept { return halves(val, val, [](__m128i a, __m128i) { return _mm_slli_epi32(a, bits); }); }
+		template<int bits> static ireg_t shr(ireg_t val) noexcept { return halves(val, val, [](__m128i a, __m128i) { return _mm_srli_epi32(a, bits); }); }
+		static mask_t ieq(ireg_t lhs, ireg_t rhs) noexcept { return as_float(halves(lhs, rhs, [](__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); })); }
+
+		static ireg_t load_u8(const std::uint8_t* ptr) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)), zero);
+			return _mm256_insertf128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(words, zero)), _mm_unpackhi_epi16(words, zero), 1);
+		}
+		static void store_u8(std::uint8_t* ptr, ireg_t val) noexcept
+		{
+			const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(val), _mm256_extractf128_si256(val, 1));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), _mm_packus_epi16(words, words));
+		}
+		static reg_t spread_alpha(reg_t val) noexcept { return _mm256_permute_ps(val, 0xFF); }
+		// Each 128-bit half takes four pixels, so the in-lane transpose leaves the channels
+		// in pixel order.
+		static void load_rgba(const float* ptr, reg_t& r, reg_t& g, reg_t& b, reg_t& a) noexcept
+		{
+			reg_t v[4];
+			for (size_t k = 0; k < 4; k++)
+			{
+				v[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(ptr + 4 * k)), _mm_loadu_ps(ptr + 16 + 4 * k), 1);
+			}
+			const reg_t t0 = _mm256_unpacklo_ps(v[0], v[1]);
+			const reg_t t1 = _mm256_unpackhi_ps(v[0], v[1]);
+			const reg_t t2 = _mm256_unpacklo_ps(v[2], v[3]);
+			const reg_t t3 = _mm256_unpackhi_ps(v[2], v[3]);
+			r = _mm256_shuffle_ps(t0, t2, 0x44);
+			g = _mm256_shuffle_ps(t0, t2, 0xEE);
+			b = _mm256_shuffle_ps(t1, t3, 0x44);
+			a = _mm256_shuffle_ps(t1, t3, 0xEE);
+		}
+	private:
+		template<typename Op>
+		static ireg_t halves(ireg_t lhs, ireg_t rhs, Op op) noexcept
+		{
+			const __m128i lo = op(_mm256_castsi256_si128(lhs), _mm256_castsi256_si128(rhs));
+			const __m128i hi = op(_mm256_extractf128_si256(lhs, 1), _mm256_extractf128_si256(rhs, 1));
+			return _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+		}
+	};
+
+	template<>
+	struct avx_pack<double>
+	{
+		using reg_t = __m256d;
+		static constexpr size_t width = 4;
+
+		static reg_t load(const double* ptr) noexcept { return _mm256_loadu_pd(ptr); }
+		static void store(double* ptr, reg_t val) noexcept { _mm256_storeu_pd(ptr, val); }
+		static reg_t set1(double val) noexcept { return _mm256_set1_pd(val); }
+		static reg_t zero() noexcept { return _mm256_setzero_pd(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm256_add_pd(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm256_sub_pd(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm256_mul_pd(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm256_div_pd(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm256_sqrt_pd(val); }
+
+		using mask_t = __m256d;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm256_min_pd(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm256_max_pd(lhs, rhs); }
+		static mask_t cmp_le(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmp_pd(lhs, rhs, _CMP_GE_OQ); }
+		static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return _mm256_and_pd(lhs, rhs); }
+		static mask_t mask_or(mask_t lhs, mask_t rhs) noexcept { return _mm256_or_pd(lhs, rhs); }
+		static std::uint32_t bits(mask_t mask) noexcept { return static_cast<std::uint32_t>(_mm256_movemask_pd(mask)); }
+	};
+
+	template<>
+	struct avx_pack<std::int32_t> : detail::int32x4_pack<1> {};
+#endif
+#if defined(CLM_SIMD_AVX2) && defined(CLM_SIMD_FMA)
+	// AVX2 with FMA3: fused multiply-adds and 256-bit integer lanes. Only the members
+	// whose code differs from avx_pack are redefined, so every inline function keeps a
+	// single body no matter which instruction set flags a source is built with.
+	template<typename T> struct avx2_pack;
+
+	template<>
+	struct avx2_pack<float> : avx_pack<float>
+	{
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+		static ireg_t iadd(ireg_t lhs, ireg_t rhs) noexcept { return _mm256_add_epi32(lhs, rhs); }
+		static ireg_t isub(ireg_t lhs, ireg_t rhs) noexcept { return _mm256_sub_epi32(lhs, rhs); }
+		template<int bits> static ireg_t shl(ireg_t val) noexcept { return _mm256_slli_epi32(val, bits); }
+		template<int bits> static ireg_t shr(ireg_t val) noexcept { return _mm256_srli_epi32(val, bits); }
+		static mask_t ieq(ireg_t lhs, ireg_t rhs) noexcept { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(lhs, rhs)); }
+	};
+
+	template<>
+	struct avx2_pack<double> : avx_pack<double>
+	{
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+	};
+
+	template<>
+	struct avx2_pack<std::int32_t>
+	{
+		using reg_t = __m256i;
+		using mask_t = __m256i;
+		static constexpr size_t width = 8;
+
+		static reg_t load(const std::int32_t* ptr) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+		static void store(std::int32_t* ptr, reg_t val) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), val); }
+		static reg_t set1(std::int32_t val) noexcept { return _mm256_set1_epi32(val); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm256_sub_epi32(lhs, rhs); }
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm256_min_epi32(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm256_max_epi32(lhs, rhs); }
+		static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmpgt_epi32(rhs, lhs); }
+		static mask_t cmp_gt(reg_t lhs, reg_t rhs) noexcept { return _mm256_cmpgt_epi32(lhs, rhs); }
+		static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept { return _mm256_blendv_epi8(ifFalse, ifTrue, mask); }
+		static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return _mm256_and_si256(lhs, rhs); }
+		static mask_t mask_and_not(mask_t mask, mask_t excluded) noexcept { return _mm256_andnot_si256(excluded, mask); }
+		static std::uint32_t bits(mask_t mask) noexcept { return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); }
+		static void store_product_u64(std::uint64_t* out, reg_t lhs, reg_t rhs) noexcept
+		{
+			const __m256i lo = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(lhs)), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(rhs)));
+			const __m256i hi = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(lhs, 1)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(rhs, 1)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lo);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4), hi);
+		}
+	};
+#endif
+#if defined(CLM_SIMD_AVX512)
+	template<typename T> struct avx512_pack;
+
+	template<>
+	struct avx512_pack<float>
+	{
+		using reg_t = __m512;
+		static constexpr size_t width = 16;
+
+		static reg_t load(const float* ptr) noexcept { return _mm512_loadu_ps(ptr); }
+		static void store(float* ptr, reg_t val) noexcept { _mm512_storeu_ps(ptr, val); }
+		static reg_t set1(float val) noexcept { return _mm512_set1_ps(val); }
+		static reg_t zero() noexcept { return _mm512_setzero_ps(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm512_add_ps(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm512_sub_ps(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm512_mul_ps(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm512_div_ps(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm512_sqrt_ps(val); }
+
+		// Same extra operations as sse_pack<float>, with AVX-512 mask registers as masks.
+		using ireg_t = __m512i;
+		using mask_t = __mmask16;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm512_min_ps(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm512_max_ps(lhs, rhs); }
+		static reg_t abs(reg_t val) noexcept { return _mm512_abs_ps(val); }
+		static reg_t bit_xor(reg_t lhs, reg_t rhs) noexcept { return as_float(_mm512_xor_si512(as_int(lhs), as_int(rhs))); }
+		static reg_t rsqrt_est(reg_t val) noexcept { return _mm512_rsqrt14_ps(val); }
+		static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LT_OQ); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_GE_OQ); }
+		static mask_t cmp_eq(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_EQ_OQ); }
+		static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept { return _mm512_mask_blend_ps(mask, ifFalse, ifTrue); }
+		static bool any(mask_t mask) noexcept { return mask != 0; }
+
+		static ireg_t to_int(reg_t val) noexcept { return _mm512_cvtps_epi32(val); }
+		static reg_t to_float(ireg_t val) noexcept { return _mm512_cvtepi32_ps(val); }
+		static ireg_t as_int(reg_t val) noexcept { return _mm512_castps_si512(val); }
+		static reg_t as_float(ireg_t val) noexcept { return _mm512_castsi512_ps(val); }
+		static ireg_t iset1(std::int32_t val) noexcept { return _mm512_set1_epi32(val); }
+		static ireg_t iadd(ireg_t lhs, ireg_t rhs) noexcept { return _mm512_add_epi32(lhs, rhs); }
+		static ireg_t isub(ireg_t lhs, ireg_t rhs) noexcept { return _mm512_sub_epi32(lhs, rhs); }
+		static ireg_t iand(ireg_t lhs, ireg_t rhs) noexcept { return _mm512_and_si512(lhs, rhs); }
+		static ireg_t ior(ireg_t lhs, ireg_t rhs) noexcept { return _mm512_or_si512(lhs, rhs); }
+		template<int bits> static ireg_t shl(ireg_t val) noexcept { return _mm512_slli_epi32(val, bits); }
+		template<int bits> static ireg_t shr(ireg_t val) noexcept { return _mm512_srli_epi32(val, bits); }
+		static mask_t ieq(ireg_t lhs, ireg_t rhs) noexcept { return _mm512_cmpeq_epi32_mask(lhs, rhs); }
+
+		static ireg_t load_u8(const std::uint8_t* ptr) noexcept { return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))); }
+		static void store_u8(std::uint8_t* ptr, ireg_t val) noexcept
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), _mm512_cvtusepi32_epi8(_mm512_max_epi32(val, _mm512_setzero_si512())));
+		}
+		static reg_t spread_alpha(reg_t val) noexcept { return _mm512_permute_ps(val, 0xFF); }
+		// Each 128-bit quarter takes four pixels, as in avx_pack.
+		static void load_rgba(const float* ptr, reg_t& r, reg_t& g, reg_t& b, reg_t& a) noexcept
+		{
+			reg_t v[4];
+			for (size_t k = 0; k < 4; k++)
+			{
+				v[k] = _mm512_castps128_ps512(_mm_loadu_ps(ptr + 4 * k));
+				v[k] = _mm512_insertf32x4(v[k], _mm_loadu_ps(ptr + 16 + 4 * k), 1);
+				v[k] = _mm512_insertf32x4(v[k], _mm_loadu_ps(ptr + 32 + 4 * k), 2);
+				v[k] = _mm512_insertf32x4(v[k], _mm_loadu_ps(ptr + 48 + 4 * k), 3);
+			}
+			const reg_t t0 = _mm512_unpacklo_ps(v[0], v[1]);
+			const reg_t t1 = _mm512_unpackhi_ps(v[0], v[1]);
+			const reg_t t2 = _mm512_unpacklo_ps(v[2], v[3]);
+			const reg_t t3 = _mm512_unpackhi_ps(v[2], v[3]);
+			r = _mm512_shuffle_ps(t0, t2, 0x44);
+			g = _mm512_shuffle_ps(t0, t2, 0xEE);
+			b = _mm512_shuffle_ps(t1, t3, 0x44);
+			a = _mm512_shuffle_ps(t1, t3, 0xEE);
+		}
+	};
+
+	template<>
+	struct avx512_pack<double>
+	{
+		using reg_t = __m512d;
+		static constexpr size_t width = 8;
+
+		static reg_t load(const double* ptr) noexcept { return _mm512_loadu_pd(ptr); }
+		static void store(double* ptr, reg_t val) noexcept { _mm512_storeu_pd(ptr, val); }
+		static reg_t set1(double val) noexcept { return _mm512_set1_pd(val); }
+		static reg_t zero() noexcept { return _mm512_setzero_pd(); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm512_add_pd(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm512_sub_pd(lhs, rhs); }
+		static reg_t mul(reg_t lhs, reg_t rhs) noexcept { return _mm512_mul_pd(lhs, rhs); }
+		static reg_t div(reg_t lhs, reg_t rhs) noexcept { return _mm512_div_pd(lhs, rhs); }
+		static reg_t fmadd(reg_t a, reg_t b, reg_t c) noexcept { return _mm512_fmadd_pd(a, b, c); }
+		static reg_t sqrt(reg_t val) noexcept { return _mm512_sqrt_pd(val); }
+
+		using mask_t = __mmask8;
+
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm512_min_pd(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm512_max_pd(lhs, rhs); }
+		static mask_t cmp_le(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_LE_OQ); }
+		static mask_t cmp_ge(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmp_pd_mask(lhs, rhs, _CMP_GE_OQ); }
+		static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return static_cast<mask_t>(lhs & rhs); }
+		static mask_t mask_or(mask_t lhs, mask_t rhs) noexcept { return static_cast<mask_t>(lhs | rhs); }
+		static std::uint32_t bits(mask_t mask) noexcept { return mask; }
+	};
+
+	template<>
+	struct avx512_pack<std::int32_t>
+	{
+		using reg_t = __m512i;
+		using mask_t = __mmask16;
+		static constexpr size_t width = 16;
+
+		static reg_t load(const std::int32_t* ptr) noexcept { return _mm512_loadu_si512(ptr); }
+		static void store(std::int32_t* ptr, reg_t val) noexcept { _mm512_storeu_si512(ptr, val); }
+		static reg_t set1(std::int32_t val) noexcept { return _mm512_set1_epi32(val); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm512_sub_epi32(lhs, rhs); }
+		static reg_t min(reg_t lhs, reg_t rhs) noexcept { return _mm512_min_epi32(lhs, rhs); }
+		static reg_t max(reg_t lhs, reg_t rhs) noexcept { return _mm512_max_epi32(lhs, rhs); }
+		static mask_t cmp_lt(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmplt_epi32_mask(lhs, rhs); }
+		static mask_t cmp_gt(reg_t lhs, reg_t rhs) noexcept { return _mm512_cmpgt_epi32_mask(lhs, rhs); }
+		static reg_t select(mask_t mask, reg_t ifTrue, reg_t ifFalse) noexcept { return _mm512_mask_blend_epi32(mask, ifFalse, ifTrue); }
+		static mask_t mask_and(mask_t lhs, mask_t rhs) noexcept { return static_cast<mask_t>(lhs & rhs); }
+		static mask_t mask_and_not(mask_t mask, mask_t excluded) noexcept { return static_cast<mask_t>(mask & ~excluded); }
+		static std::uint32_t bits(mask_t mask) noexcept { return mask; }
+		static void store_product_u64(std::uint64_t* out, reg_t lhs, reg_t rhs) noexcept
+		{
+			const __m512i lo = _mm512_mul_epu32(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(lhs)), _mm512_cvtepu32_epi64(_mm512_castsi512_si256(rhs)));
+			const __m512i hi = _mm512_mul_epu32(_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(lhs, 1)), _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(rhs, 1)));
+			_mm512_storeu_si512(out, lo);
+			_mm512_storeu_si512(out + 8, hi);
+		}
+	};
+#endif
+
+#if defined(CLM_SIMD_AVX512)
+	template<> struct pack<float> : avx512_pack<float> {};
+	template<> struct pack<double> : avx512_pack<double> {};
+#elif defined(CLM_SIMD_AVX2) && defined(CLM_SIMD_FMA)
+	template<> struct pack<float> : avx2_pack<float> {};
+	template<> struct pack<double> : avx2_pack<double> {};
+#elif defined(CLM_SIMD_AVX)
+	template<> struct pack<float> : avx_pack<float> {};
+	template<> struct pack<double> : avx_pack<double> {};
+#elif defined(CLM_SIMD_SSE)
+	template<> struct pack<float> : sse_pack<float> {};
+	template<> struct pack<double> : sse_pack<double> {};
+#endif
+
+	// Runs kernel over [0, count) one wide_t at a time, then finishes the tail with
+	// tail_t. The kernel is a template lambda taking the pack type and the index.
+	template<typename wide_t, typename tail_t, typename Kernel>
+	inline void for_each_pack_as(size_t count, Kernel&& kernel)
+	{
+		size_t i = 0;
+		if constexpr (wide_t::width > 1)
+		{
+			for (; i + wide_t::width <= count; i += wide_t::width)
+			{
+				kernel.template operator()<wide_t>(i);
+			}
+		}
+		for (; i < count; i++)
+		{
+			kernel.template operator()<tail_t>(i);
+		}
+	}
+
+	// for_each_pack_as with the widest pack of the build and single lane tails.
+	template<typename T, typename Kernel>
+	inline void for_each_pack(size_t count, Kernel&& kernel)
+	{
+		for_each_pack_as<pack<T>, scalar_pack<T>>(count, std::forward<Kernel>(kernel));
+	}
+}
+}
+
+#endif
\ No newline at end of file
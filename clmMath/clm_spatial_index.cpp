@@ -0,0 +1,605 @@
+#include "clm_spatial_index.h"
+
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <limits>
+#include <cassert>
+
+namespace clm::math {
+	namespace {
+		using candidate = std::pair<std::uint64_t, std::uint32_t>;
+
+		// Keeps the k smallest (distance, id) pairs seen so far in a max-heap.
+		class nearest_set
+		{
+		public:
+			explicit nearest_set(size_t k) : m_k(k) {}
+
+			bool full() const noexcept
+			{
+				return m_heap.size() == m_k;
+			}
+
+			std::uint64_t worst() const noexcept
+			{
+				return m_heap.front().first;
+			}
+
+			void offer(std::uint64_t distance, std::uint32_t id)
+			{
+				const candidate c{distance, id};
+				if (!full())
+				{
+					m_heap.push_back(c);
+					std::push_heap(m_heap.begin(), m_heap.end());
+				}
+				else if (c < m_heap.front())
+				{
+					std::pop_heap(m_heap.begin(), m_heap.end());
+					m_heap.back() = c;
+					std::push_heap(m_heap.begin(), m_heap.end());
+				}
+			}
+
+			size_t append_to(std::vector<std::uint32_t>& out)
+			{
+				std::sort_heap(m_heap.begin(), m_heap.end());
+				for (const candidate& c : m_heap)
+				{
+					out.push_back(c.second);
+				}
+				return m_heap.size();
+			}
+
+		private:
+			size_t m_k;
+			std::vector<candidate> m_heap;
+		};
+
+		// Same as distance_sq(rect, x, y) for a span of whole coordinates [lo, hi).
+		std::int64_t axis_gap(std::int64_t v, std::int64_t lo, std::int64_t hi) noexcept
+		{
+			return v < lo ? lo - v : (v >= hi ? v - hi + 1 : 0);
+		}
+	}
+
+	RectGrid::RectGrid(const Rect& bounds, std::int32_t cellSize)
+		:
+		m_bounds(bounds),
+		m_cellSize(std::max(cellSize, 1))
+	{
+		const std::int64_t width = std::max<std::int64_t>(std::int64_t{bounds.right} - bounds.left, 1);
+		const std::int64_t height = std::max<std::int64_t>(std::int64_t{bounds.bottom} - bounds.top, 1);
+		m_columns = static_cast<std::int32_t>((width + m_cellSize - 1) / m_cellSize);
+		m_rows = static_cast<std::int32_t>((height + m_cellSize - 1) / m_cellSize);
+		m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+	}
+
+	std::int32_t RectGrid::cell_x(std::int64_t x) const noexcept
+	{
+		return static_cast<std::int32_t>(std::clamp<std::int64_t>((x - m_bounds.left) / m_cellSize, 0, m_columns - 1));
+	}
+
+	std::int32_t RectGrid::cell_y(std::int64_t y) const noexcept
+	{
+		return static_cast<std::int32_t>(std::clamp<std::int64_t>((y - m_bounds.top) / m_cellSize, 0, m_rows - 1));
+	}
+
+	RectGrid::CellRange RectGrid::cells_of(const Rect& rect) const noexcept
+	{
+		return CellRange{cell_x(rect.left), cell_y(rect.top),
+						 cell_x(std::int64_t{rect.right} - 1), cell_y(std::int64_t{rect.bottom} - 1)};
+	}
+
+	void RectGrid::link(std::uint32_t id, const Rect& rect)
+	{
+		if (rect.empty())
+		{
+			return;
+		}
+		const CellRange range = cells_of(rect);
+		for (std::int32_t cy = range.y0; cy <= range.y1; cy++)
+		{
+			for (std::int32_t cx = range.x0; cx <= range.x1; cx++)
+			{
+				cell(cx, cy).push_back(RectEntry{rect, id});
+			}
+		}
+	}
+
+	void RectGrid::unlink(std::uint32_t id, const Rect& rect)
+	{
+		if (rect.empty())
+		{
+			return;
+		}
+		const CellRange range = cells_of(rect);
+		for (std::int32_t cy = range.y0; cy <= range.y1; cy++)
+		{
+			for (std::int32_t cx = range.x0; cx <= range.x1; cx++)
+			{
+				std::vector<RectEntry>& entries = cell(cx, cy);
+				const auto it = std::find_if(entries.begin(), entries.end(), [id](const RectEntry& e) { return e.id == id; });
+				assert(it != entries.end());
+				*it = entries.back();
+				entries.pop_back();
+			}
+		}
+	}
+
+	void RectGrid::build(std::span<const RectEntry> entries)
+	{
+		clear();
+		m_rects.reserve(entries.size());
+		std::vector<std::uint32_t> counts(m_cells.size(), 0);
+		for (const RectEntry& entry : entries)
+		{
+			if (entry.rect.empty())
+			{
+				continue;
+			}
+			const CellRange range = cells_of(entry.rect);
+			for (std::int32_t cy = range.y0; cy <= range.y1; cy++)
+			{
+				for (std::int32_t cx = range.x0; cx <= range.x1; cx++)
+				{
+					counts[static_cast<size_t>(cy) * m_columns + cx]++;
+				}
+			}
+		}
+		for (size_t i = 0; i < m_cells.size(); i++)
+		{
+			m_cells[i].reserve(counts[i]);
+		}
+		for (const RectEntry& entry : entries)
+		{
+			insert(entry.id, entry.rect);
+		}
+	}
+
+	void RectGrid::clear() noexcept
+	{
+		for (std::vector<RectEntry>& entries : m_cells)
+		{
+			entries.clear();
+		}
+		m_rects.clear();
+	}
+
+	bool RectGrid::insert(std::uint32_t id, const Rect& rect)
+	{
+		if (!m_rects.try_emplace(id, rect).second)
+		{
+			return false;
+		}
+		link(id, rect);
+		return true;
+	}
+
+	bool RectGrid::remove(std::uint32_t id)
+	{
+		const auto it = m_rects.find(id);
+		if (it == m_rects.end())
+		{
+			return false;
+		}
+		unlink(id, it->second);
+		m_rects.erase(it);
+		return true;
+	}
+
+	bool RectGrid::move(std::uint32_t id, const Rect& rect)
+	{
+		const auto it = m_rects.find(id);
+		if (it == m_rects.end())
+		{
+			return false;
+		}
+		const Rect old = it->second;
+		it->second = rect;
+		// Moves within the same cells, the common case for small steps, are updated in place.
+		const CellRange from = cells_of(old);
+		const CellRange to = cells_of(rect);
+		if (!old.empty() && !rect.empty() && from.x0 == to.x0 && from.y0 == to.y0 && from.x1 == to.x1 && from.y1 == to.y1)
+		{
+			for (std::int32_t cy = to.y0; cy <= to.y1; cy++)
+			{
+				for (std::int32_t cx = to.x0; cx <= to.x1; cx++)
+				{
+					for (RectEntry& entry : cell(cx, cy))
+					{
+						if (entry.id == id)
+						{
+							entry.rect = rect;
+							break;
+						}
+					}
+				}
+			}
+			return true;
+		}
+		unlink(id, old);
+		link(id, rect);
+		return true;
+	}
+
+	const Rect* RectGrid::find(std::uint32_t id) const noexcept
+	{
+		const auto it = m_rects.find(id);
+		return it == m_rects.end() ? nullptr : &it->second;
+	}
+
+	size_t RectGrid::query_point(std::int32_t x, std::int32_t y, std::vector<std::uint32_t>& out) const
+	{
+		const size_t before = out.size();
+		for (const RectEntry& entry : cell(cell_x(x), cell_y(y)))
+		{
+			if (entry.rect.contains(x, y))
+			{
+				out.push_back(entry.id);
+			}
+		}
+		return out.size() - before;
+	}
+
+	size_t RectGrid::query_overlap(const Rect& area, std::vector<std::uint32_t>& out) const
+	{
+		if (area.empty())
+		{
+			return 0;
+		}
+		const size_t before = out.size();
+		const CellRange range = cells_of(area);
+		for (std::int32_t cy = range.y0; cy <= range.y1; cy++)
+		{
+			for (std::int32_t cx = range.x0; cx <= range.x1; cx++)
+			{
+				for (const RectEntry& entry : cell(cx, cy))
+				{
+					// A rect spanning several cells is reported only from the cell holding
+					// the top-left corner of its overlap with area, which both cover.
+					if (entry.rect.intersects(area) &&
+						cell_x(std::max(entry.rect.left, area.left)) == cx &&
+						cell_y(std::max(entry.rect.top, area.top)) == cy)
+					{
+						out.push_back(entry.id);
+					}
+				}
+			}
+		}
+		return out.size() - before;
+	}
+
+	size_t RectGrid::nearest(std::int32_t x, std::int32_t y, size_t k, std::vector<std::uint32_t>& out) const
+	{
+		if (k == 0)
+		{
+			return 0;
+		}
+		nearest_set best{k};
+		const std::int32_t qx = cell_x(x);
+		const std::int32_t qy = cell_y(y);
+		constexpr std::int64_t unbounded = std::numeric_limits<std::int64_t>::max();
+		for (std::int32_t ring = 0;; ring++)
+		{
+			const std::int32_t x0 = qx - ring;
+			const std::int32_t y0 = qy - ring;
+			const std::int32_t x1 = qx + ring;
+			const std::int32_t y1 = qy + ring;
+			for (std::int32_t cy = std::max(y0, 0); cy <= std::min(y1, m_rows - 1); cy++)
+			{
+				const bool edgeRow = cy == y0 || cy == y1;
+				for (std::int32_t cx = std::max(x0, 0); cx <= std::min(x1, m_columns - 1); cx++)
+				{
+					if (!edgeRow && cx != x0 && cx != x1)
+					{
+						continue;
+					}
+					for (const RectEntry& entry : cell(cx, cy))
+					{
+						// Counted only in the cell holding its point nearest to (x, y).
+						const std::int64_t nx = std::clamp<std::int64_t>(x, entry.rect.left, std::int64_t{entry.rect.right} - 1);
+						const std::int64_t ny = std::clamp<std::int64_t>(y, entry.rect.top, std::int64_t{entry.rect.bottom} - 1);
+						if (cell_x(nx) == cx && cell_y(ny) == cy)
+						{
+							best.offer(distance_sq(entry.rect, x, y), entry.id);
+						}
+					}
+				}
+			}
+
+			// Anything not seen yet has its nearest point outside the block of rings
+			// searched so far. Border cells reach to infinity, so a side at the border of
+			// the grid has nothing beyond it.
+			std::int64_t gap = unbounded;
+			if (x0 > 0)
+			{
+				gap = std::min(gap, std::int64_t{x} - (std::int64_t{m_bounds.left} + std::int64_t{x0} * m_cellSize) + 1);
+			}
+			if (y0 > 0)
+			{
+				gap = std::min(gap, std::int64_t{y} - (std::int64_t{m_bounds.top} + std::int64_t{y0} * m_cellSize) + 1);
+			}
+			if (x1 < m_columns - 1)
+			{
+				gap = std::min(gap, std::int64_t{m_bounds.left} + (std::int64_t{x1} + 1) * m_cellSize - x);
+			}
+			if (y1 < m_rows - 1)
+			{
+				gap = std::min(gap, std::int64_t{m_bounds.top} + (std::int64_t{y1} + 1) * m_cellSize - y);
+			}
+			if (gap == unbounded || (best.full() && detail::sum_of_squares(static_cast<std::uint64_t>(gap), 0) > best.worst()))
+			{
+				break;
+			}
+		}
+		return best.append_to(out);
+	}
+
+	RectQuadtree::RectQuadtree(const Rect& bounds, std::uint32_t maxDepth)
+		:
+		m_maxDepth(std::min<std::uint32_t>(maxDepth, 32))
+	{
+		const std::int64_t extent = std::max<std::int64_t>({std::int64_t{bounds.right} - bounds.left, std::int64_t{bounds.bottom} - bounds.top, 1});
+		std::int64_t size = 1;
+		while (size < extent)
+		{
+			size *= 2;
+		}
+		m_nodes.push_back(Node{bounds.left, bounds.top, size, noChildren, {}});
+	}
+
+	void RectQuadtree::build(std::span<const RectEntry> entries)
+	{
+		clear();
+		m_locations.reserve(entries.size());
+		for (const RectEntry& entry : entries)
+		{
+			insert(entry.id, entry.rect);
+		}
+	}
+
+	void RectQuadtree::clear() noexcept
+	{
+		m_nodes.resize(1);
+		m_nodes[0].children = noChildren;
+		m_nodes[0].entries.clear();
+		m_locations.clear();
+	}
+
+	std::uint32_t RectQuadtree::node_for(const Rect& rect)
+	{
+		const Node& root = m_nodes[0];
+		const std::int64_t cx = (std::int64_t{rect.left} + rect.right) / 2;
+		const std::int64_t cy = (std::int64_t{rect.top} + rect.bottom) / 2;
+		const std::int64_t extent = std::max(std::int64_t{rect.right} - rect.left, std::int64_t{rect.bottom} - rect.top);
+		if (cx < root.x || cx >= root.x + root.size || cy < root.y || cy >= root.y + root.size)
+		{
+			return 0;
+		}
+		std::uint32_t index = 0;
+		for (std::uint32_t depth = 0; depth < m_maxDepth; depth++)
+		{
+			const std::int64_t half = m_nodes[index].size / 2;
+			if (half < extent || half == 0)
+			{
+				break;
+			}
+			if (m_nodes[index].children == noChildren)
+			{
+				const std::int64_t parentX = m_nodes[index].x;
+				const std::int64_t parentY = m_nodes[index].y;
+				m_nodes[index].children = static_cast<std::uint32_t>(m_nodes.size());
+				for (std::uint32_t quadrant = 0; quadrant < 4; quadrant++)
+				{
+					m_nodes.push_back(Node{parentX + (quadrant & 1) * half, parentY + (quadrant >> 1) * half, half, noChildren, {}});
+				}
+			}
+			const Node& node = m_nodes[index];
+			const std::uint32_t quadrant = (cx >= node.x + half ? 1u : 0u) | (cy >= node.y + half ? 2u : 0u);
+			index = node.children + quadrant;
+		}
+		return index;
+	}
+
+	void RectQuadtree::link(std::uint32_t id, const Rect& rect)
+	{
+		const std::uint32_t node = node_for(rect);
+		std::vector<RectEntry>& entries = m_nodes[node].entries;
+		m_locations[id] = Location{node, static_cast<std::uint32_t>(entries.size())};
+		entries.push_back(RectEntry{rect, id});
+	}
+
+	void RectQuadtree::unlink(const Location& location)
+	{
+		std::vector<RectEntry>& entries = m_nodes[location.node].entries;
+		if (location.slot + 1 != entries.size())
+		{
+			entries[location.slot] = entries.back();
+			m_locations[entries[location.slot].id].slot = location.slot;
+		}
+		entries.pop_back();
+	}
+
+	bool RectQuadtree::insert(std::uint32_t id, const Rect& rect)
+	{
+		if (m_locations.contains(id))
+		{
+			return false;
+		}
+		link(id, rect);
+		return true;
+	}
+
+	bool RectQuadtree::remove(std::uint32_t id)
+	{
+		const auto it = m_locations.find(id);
+		if (it == m_locations.end())
+		{
+			return false;
+		}
+		const Location location = it->second;
+		m_locations.erase(it);
+		unlink(location);
+		return true;
+	}
+
+	bool RectQuadtree::move(std::uint32_t id, const Rect& rect)
+	{
+		const auto it = m_locations.find(id);
+		if (it == m_locations.end())
+		{
+			return false;
+		}
+		const Location location = it->second;
+		if (node_for(rect) == location.node)
+		{
+			m_nodes[location.node].entries[location.slot].rect = rect;
+			return true;
+		}
+		unlink(location);
+		link(id, rect);
+		return true;
+	}
+
+	const Rect* RectQuadtree::find(std::uint32_t id) const noexcept
+	{
+		const auto it = m_locations.find(id);
+		return it == m_locations.end() ? nullptr : &m_nodes[it->second.node].entries[it->second.slot].rect;
+	}
+
+	namespace {
+		// Bounds of everything a non-root node can hold: its cell grown by half a cell on
+		// every side, plus one for the rounding of odd extents.
+		struct loose_box
+		{
+			std::int64_t left, top, right, bottom;
+
+			template<typename N>
+			explicit loose_box(const N& node) noexcept
+				:
+				left(node.x - node.size / 2 - 1),
+				top(node.y - node.size / 2 - 1),
+				right(node.x + node.size + node.size / 2 + 1),
+				bottom(node.y + node.size + node.size / 2 + 1)
+			{}
+
+			bool contains(std::int64_t x, std::int64_t y) const noexcept
+			{
+				return x >= left && x < right && y >= top && y < bottom;
+			}
+
+			bool intersects(const Rect& rect) const noexcept
+			{
+				return left < rect.right && rect.left < right && top < rect.bottom && rect.top < bottom;
+			}
+
+			std::uint64_t distance_sq(std::int64_t x, std::int64_t y) const noexcept
+			{
+				const std::int64_t dx = axis_gap(x, left, right);
+				const std::int64_t dy = axis_gap(y, top, bottom);
+				return detail::sum_of_squares(static_cast<std::uint64_t>(dx), static_cast<std::uint64_t>(dy));
+			}
+		};
+	}
+
+	size_t RectQuadtree::query_point(std::int32_t x, std::int32_t y, std::vector<std::uint32_t>& out) const
+	{
+		const size_t before = out.size();
+		std::vector<std::uint32_t> stack{0};
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			for (const RectEntry& entry : node.entries)
+			{
+				if (entry.rect.contains(x, y))
+				{
+					out.push_back(entry.id);
+				}
+			}
+			if (node.children != noChildren)
+			{
+				for (std::uint32_t child = node.children; child < node.children + 4; child++)
+				{
+					if (loose_box{m_nodes[child]}.contains(x, y))
+					{
+						stack.push_back(child);
+					}
+				}
+			}
+		}
+		return out.size() - before;
+	}
+
+	size_t RectQuadtree::query_overlap(const Rect& area, std::vector<std::uint32_t>& out) const
+	{
+		if (area.empty())
+		{
+			return 0;
+		}
+		const size_t before = out.size();
+		std::vector<std::uint32_t> stack{0};
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			for (const RectEntry& entry : node.entries)
+			{
+				if (entry.rect.intersects(area))
+				{
+					out.push_back(entry.id);
+				}
+			}
+			if (node.children != noChildren)
+			{
+				for (std::uint32_t child = node.children; child < node.children + 4; child++)
+				{
+					if (loose_box{m_nodes[child]}.intersects(area))
+					{
+						stack.push_back(child);
+					}
+				}
+			}
+		}
+		return out.size() - before;
+	}
+
+	size_t RectQuadtree::nearest(std::int32_t x, std::int32_t y, size_t k, std::vector<std::uint32_t>& out) const
+	{
+		if (k == 0)
+		{
+			return 0;
+		}
+		nearest_set best{k};
+		// Nodes closest first; the root holds rects of any position, so it has distance 0.
+		std::priority_queue<candidate, std::vector<candidate>, std::greater<>> nodes;
+		nodes.push({0, 0});
+		while (!nodes.empty())
+		{
+			const auto [distance, index] = nodes.top();
+			nodes.pop();
+			if (best.full() && distance > best.worst())
+			{
+				break;
+			}
+			const Node& node = m_nodes[index];
+			for (const RectEntry& entry : node.entries)
+			{
+				if (!entry.rect.empty())
+				{
+					best.offer(distance_sq(entry.rect, x, y), entry.id);
+				}
+			}
+			if (node.children != noChildren)
+			{
+				for (std::uint32_t child = node.children; child < node.children + 4; child++)
+				{
+					nodes.push({loose_box{m_nodes[child]}.distance_sq(x, y), child});
+				}
+			}
+		}
+		return best.append_to(out);
+	}
+}
\ No newline at end of file
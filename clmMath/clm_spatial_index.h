@@ -0,0 +1,128 @@
+#ifndef CLM_SPATIAL_INDEX_H
+#define CLM_SPATIAL_INDEX_H
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "clm_rect.h"
+
+// Indexes of Rect/ID pairs for hit-testing and range queries. Both share one interface:
+// bulk build() replaces the contents, insert/remove/move update single entries by ID, and
+// queries append matching IDs to out (which is not cleared) and return how many they
+// appended. Empty rects are kept, so they can be moved or removed, but no query returns
+// them.
+//
+// RectGrid suits a bounded world with rects of similar size, such as a screen of widgets
+// or a tile map; RectQuadtree suits a wide range of sizes or an unbounded world.
+namespace clm::math {
+	struct RectEntry
+	{
+		Rect rect;
+		std::uint32_t id;
+	};
+
+	// Uniform grid of square cells over bounds. A rect is listed in every cell it
+	// overlaps; rects reaching past bounds are kept in the border cells, so nothing is
+	// ever lost, but a world much larger than bounds degrades to a scan of the border.
+	class RectGrid
+	{
+	public:
+		RectGrid(const Rect& bounds, std::int32_t cellSize);
+
+		void build(std::span<const RectEntry> entries);
+		void clear() noexcept;
+
+		// insert fails if id is already present, remove and move if it is not.
+		bool insert(std::uint32_t id, const Rect& rect);
+		bool remove(std::uint32_t id);
+		bool move(std::uint32_t id, const Rect& rect);
+
+		size_t size() const noexcept { return m_rects.size(); }
+		const Rect* find(std::uint32_t id) const noexcept;
+
+		// Every rect containing (x, y).
+		size_t query_point(std::int32_t x, std::int32_t y, std::vector<std::uint32_t>& out) const;
+		// Every rect intersecting area, each once.
+		size_t query_overlap(const Rect& area, std::vector<std::uint32_t>& out) const;
+		// Up to k rects nearest to (x, y) by distance_sq, closest first; ties go to the lower ID.
+		size_t nearest(std::int32_t x, std::int32_t y, size_t k, std::vector<std::uint32_t>& out) const;
+
+	private:
+		struct CellRange
+		{
+			std::int32_t x0, y0, x1, y1;
+		};
+
+		std::int32_t cell_x(std::int64_t x) const noexcept;
+		std::int32_t cell_y(std::int64_t y) const noexcept;
+		CellRange cells_of(const Rect& rect) const noexcept;
+		std::vector<RectEntry>& cell(std::int32_t cx, std::int32_t cy) noexcept { return m_cells[static_cast<size_t>(cy) * m_columns + cx]; }
+		const std::vector<RectEntry>& cell(std::int32_t cx, std::int32_t cy) const noexcept { return m_cells[static_cast<size_t>(cy) * m_columns + cx]; }
+		void link(std::uint32_t id, const Rect& rect);
+		void unlink(std::uint32_t id, const Rect& rect);
+
+		Rect m_bounds;
+		std::int32_t m_cellSize;
+		std::int32_t m_columns;
+		std::int32_t m_rows;
+		std::vector<std::vector<RectEntry>> m_cells;
+		std::unordered_map<std::uint32_t, Rect> m_rects;
+	};
+
+	// Loose quadtree in one flat node array. A rect lives in the deepest node whose cell
+	// holds its centre and is at least as large as the rect, so it fits in the node's
+	// cell grown by half a cell on every side and is stored exactly once. The root covers
+	// the power-of-two square around bounds and takes everything that fits nowhere else.
+	class RectQuadtree
+	{
+	public:
+		explicit RectQuadtree(const Rect& bounds, std::uint32_t maxDepth = 10);
+
+		void build(std::span<const RectEntry> entries);
+		void clear() noexcept;
+
+		bool insert(std::uint32_t id, const Rect& rect);
+		bool remove(std::uint32_t id);
+		bool move(std::uint32_t id, const Rect& rect);
+
+		size_t size() const noexcept { return m_locations.size(); }
+		const Rect* find(std::uint32_t id) const noexcept;
+
+		size_t query_point(std::int32_t x, std::int32_t y, std::vector<std::uint32_t>& out) const;
+		size_t query_overlap(const Rect& area, std::vector<std::uint32_t>& out) const;
+		size_t nearest(std::int32_t x, std::int32_t y, size_t k, std::vector<std::uint32_t>& out) const;
+
+	private:
+		static constexpr std::uint32_t noChildren = 0;
+
+		// A node covers the square [x, x + size) x [y, y + size). Its children are four
+		// consecutive nodes: top-left, top-right, bottom-left, bottom-right.
+		struct Node
+		{
+			std::int64_t x;
+			std::int64_t y;
+			std::int64_t size;
+			std::uint32_t children = noChildren;
+			std::vector<RectEntry> entries;
+		};
+
+		// Where an ID's entry is: m_nodes[node].entries[slot].
+		struct Location
+		{
+			std::uint32_t node;
+			std::uint32_t slot;
+		};
+
+		std::uint32_t node_for(const Rect& rect);
+		void link(std::uint32_t id, const Rect& rect);
+		void unlink(const Location& location);
+
+		std::uint32_t m_maxDepth;
+		std::vector<Node> m_nodes;
+		std::unordered_map<std::uint32_t, Location> m_locations;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef CLM_TRANSFORM_H
+#define CLM_TRANSFORM_H
+
+#include <span>
+#include <cassert>
+#include <type_traits>
+
+#include "clm_matrix.h"
+#include "clm_vector_batch.h"
+
+namespace clm::math {
+	// Transforms every point in `in` by mat (w = 1) into `out`, which must be at least as
+	// long. mat is either a full 4x4 or a 3x4 affine. For float the columns are loaded into
+	// registers once for the whole span.
+	template<size_t rows, typename T> requires (rows == 3 || rows == 4)
+	void transform_points(const Matrix<rows, T, 4>& mat,
+						  std::span<const Vector<std::type_identity_t<T>, 3>> in,
+						  std::span<Vector<std::type_identity_t<T>, 3>> out) noexcept
+	{
+		assert(out.size() >= in.size());
+		using simd_t = simd::mat_traits<4, T>;
+		if constexpr (simd_t::enabled)
+		{
+			const auto cols = rows == 4 ? simd_t::load_columns(mat.data()) : simd_t::load_affine_columns(mat.data());
+			for (size_t i = 0; i < in.size(); i++)
+			{
+				simd_t::transform_point(cols, in[i].data(), out[i].data());
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < in.size(); i++)
+			{
+				out[i] = transform_point(mat, in[i]);
+			}
+		}
+	}
+
+	// SoA version: each matrix element is broadcast once and applied to a full pack of
+	// x, y and z components per step. float and double use the dispatched kernel.
+	template<size_t rows, std::floating_point T> requires (rows == 3 || rows == 4)
+	void transform_points(const Matrix<rows, T, 4>& mat, const VectorBatch<T, 3>& in, VectorBatch<T, 3>& out)
+	{
+		out.resize(in.size());
+		if constexpr (dispatch::dispatched_type<T>)
+		{
+			dispatch::batch_kernels<T>().transform_points(mat.data(), in.components().data(), out.components().data(), in.size());
+		}
+		else
+		{
+			const T* xs = in.component(0);
+			const T* ys = in.component(1);
+			const T* zs = in.component(2);
+			simd::for_each_pack<T>(in.size(), [&]<typename P>(size_t i) {
+				auto x = P::load(xs + i);
+				auto y = P::load(ys + i);
+				auto z = P::load(zs + i);
+				for (size_t row = 0; row < 3; row++)
+				{
+					auto sum = P::set1(mat[row][3]);
+					sum = P::fmadd(x, P::set1(mat[row][0]), sum);
+					sum = P::fmadd(y, P::set1(mat[row][1]), sum);
+					sum = P::fmadd(z, P::set1(mat[row][2]), sum);
+					P::store(out.component(row) + i, sum);
+				}
+			});
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <utility>
 #include <cmath>
 #include "clm_gen_math.h"
+#include "clm_vector_simd.h"
+#include "clm_vector_expr.h"
 
 template<typename T, typename...Ts>
 struct base_type
@@ -19,9 +21,14 @@ concept valid_vec_type = std::floating_point<T> || std::integral<T>;
 
 namespace clm::math {
 	template<valid_vec_type T, size_t dim>
-	class Vector
+	class Vector : public vector_expr_base
 	{
+		using simd_t = simd::vec_traits<T, dim>;
 	public:
+		using value_type = T;
+		static constexpr size_t dim_v = dim;
+		static constexpr bool is_leaf = true;
+
 		constexpr Vector() noexcept
 			:
 			elems({})
@@ -46,6 +53,14 @@ namespace clm::math {
 			elems = std::move(rhs.elems);
 		}
 
+		template<vector_expr E> requires (!E::is_leaf && expr::compatible<Vector, E>)
+		constexpr Vector(const E& expression) noexcept
+			:
+			Vector()
+		{
+			assign(expression);
+		}
+
 		constexpr const Vector& operator=(const Vector& rhs) noexcept
 		{
 			std::copy(rhs.elems.begin(), rhs.elems.end(), elems.begin());
@@ -58,6 +73,12 @@ namespace clm::math {
 			return *this;
 		}
 
+		template<vector_expr E> requires (!E::is_leaf && expr::compatible<Vector, E>)
+		constexpr const Vector& operator=(const E& expression) noexcept
+		{
+			return assign(expression);
+		}
+
 		template<valid_vec_type U> requires std::convertible_to<T, U>
 		constexpr explicit operator Vector<U, dim>() const noexcept
 		{
@@ -84,52 +105,18 @@ namespace clm::math {
 			return elems[pos];
 		}
 
-		constexpr Vector<T, dim> operator+(const Vector<T, dim>& rhs) const noexcept
-		{
-			Vector<T, dim> sum{};
-			auto& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				sum[i] = lhs[i] + rhs[i];
-			}
-			return sum;
-		}
-
-		constexpr Vector operator-(const Vector& rhs) const noexcept
+		constexpr const T* data() const noexcept
 		{
-			Vector diff{};
-			auto& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				diff[i] = lhs[i] - rhs[i];
-			}
-			return diff;
+			return elems.data();
 		}
-
-		template<valid_vec_type U>
-		constexpr Vector operator*(U rhs) const noexcept
+		constexpr T* data() noexcept
 		{
-			T rhsT = static_cast<T>(rhs);
-			Vector product{};
-			auto& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				product[i] = lhs[i] * rhsT;
-			}
-			return product;
+			return elems.data();
 		}
 
-		template<valid_vec_type U>
-		constexpr Vector operator/(U rhs) const noexcept
+		auto eval_reg() const noexcept requires simd_t::enabled
 		{
-			T rhsT = static_cast<T>(rhs);
-			Vector product{};
-			auto& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				product[i] = lhs[i] / rhsT;
-			}
-			return product;
+			return simd_t::load(data());
 		}
 
 		constexpr bool operator==(const Vector& rhs) const noexcept
@@ -161,62 +148,51 @@ namespace clm::math {
 			return !operator==(rhs);
 		}
 
-		template<valid_vec_type U> requires std::convertible_to<U, T>
-		friend constexpr Vector operator*(U lhs, const Vector& rhs) noexcept
+		// The non-template overloads take braced lists, which can't deduce E: v += {1, 2, 3}.
+		constexpr const Vector& operator+=(const Vector& rhs) noexcept
 		{
-			return rhs * static_cast<T>(lhs);
+			return assign(*this + rhs);
 		}
 
-		constexpr Vector operator-() const noexcept
+		template<vector_expr E> requires expr::compatible<Vector, E>
+		constexpr const Vector& operator+=(const E& rhs) noexcept
 		{
-			const Vector& rhs = *this;
-			return {-1 * rhs};
+			return assign(*this + rhs);
 		}
 
-		constexpr const Vector& operator+=(const Vector& rhs) noexcept
+		constexpr const Vector& operator-=(const Vector& rhs) noexcept
 		{
-			Vector& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				lhs[i] += rhs[i];
-			}
-			return lhs;
+			return assign(*this - rhs);
 		}
 
-		constexpr const Vector& operator-=(const Vector& rhs) noexcept
+		template<vector_expr E> requires expr::compatible<Vector, E>
+		constexpr const Vector& operator-=(const E& rhs) noexcept
 		{
-			Vector& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				lhs[i] -= rhs[i];
-			}
-			return lhs;
+			return assign(*this - rhs);
 		}
 
 		template<valid_vec_type U>
 		constexpr const Vector& operator*=(const U rhs) noexcept
 		{
-			Vector& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				lhs[i] *= static_cast<T>(rhs);
-			}
-			return lhs;
+			return assign(*this * rhs);
 		}
 
 		template<valid_vec_type U>
 		constexpr const Vector& operator/=(const U rhs) noexcept
 		{
-			Vector& lhs = *this;
-			for (size_t i = 0; i < dim; i++)
-			{
-				lhs[i] /= static_cast<T>(rhs);
-			}
-			return lhs;
+			return assign(*this / rhs);
 		}
 
 		constexpr T length_squared() const noexcept
 		{
+			if constexpr (simd_t::enabled)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					auto reg = simd_t::load(data());
+					return simd_t::dot(reg, reg);
+				}
+			}
 			T quadraticSum{};
 			for (size_t i = 0; i < dim; i++)
 			{
@@ -235,7 +211,27 @@ namespace clm::math {
 			return clm::math::sqrt(length_squared());
 		}
 	protected:
-		std::array<T, dim> elems;
+		// Evaluates an expression tree into this vector in a single pass. Each element only
+		// depends on the same element of the operands, so the expression may alias *this.
+		template<vector_expr E>
+		constexpr const Vector& assign(const E& expression) noexcept
+		{
+			if constexpr (simd_t::enabled)
+			{
+				if (!std::is_constant_evaluated())
+				{
+					simd_t::store(data(), expression.eval_reg());
+					return *this;
+				}
+			}
+			for (size_t i = 0; i < dim; i++)
+			{
+				elems[i] = expression[i];
+			}
+			return *this;
+		}
+
+		alignas(simd_t::alignment) std::array<T, simd_t::storage_dim> elems;
 	};
 
 	template<valid_vec_type...Ts>
@@ -267,13 +263,31 @@ namespace clm::math {
 		return {(p1[0] + p2[0]) / 2, (p1[1] + p2[1]) / 2};
 	}
 
-	template<valid_vec_type T, size_t dim>
-	constexpr T dot(const Vector<T, dim>& lhs, const Vector<T, dim>& rhs) noexcept
+	template<vector_expr E>
+	constexpr Vector<typename E::value_type, E::dim_v> eval(const E& expression) noexcept
+	{
+		return Vector<typename E::value_type, E::dim_v>{expression};
+	}
+
+	// Consumes two expressions directly, so dot(a - b, c) never materializes a - b.
+	template<vector_expr L, vector_expr R> requires expr::compatible<L, R>
+	constexpr typename L::value_type dot(const L& lhs, const R& rhs) noexcept
 	{
+		using T = typename L::value_type;
+		using simd_t = simd::vec_traits<T, L::dim_v>;
+		if constexpr (simd_t::enabled)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				return simd_t::dot(lhs.eval_reg(), rhs.eval_reg());
+			}
+		}
 		T dotProduct{};
-		for (size_t i = 0; i < dim; i++)
+		for (size_t i = 0; i < L::dim_v; i++)
 		{
-			dotProduct += (lhs[i] * rhs[i]);
+			T lhsElem = lhs[i];
+			T rhsElem = rhs[i];
+			dotProduct += (lhsElem * rhsElem);
 		}
 		return dotProduct;
 	}
@@ -288,11 +302,35 @@ namespace clm::math {
 	template<valid_vec_type T>
 	constexpr Vector<T, 3> cross(const Vector<T, 3>& lhs, const Vector<T, 3>& rhs) noexcept
 	{
+		using simd_t = simd::vec_traits<T, 3>;
+		if constexpr (simd_t::enabled)
+		{
+			if (!std::is_constant_evaluated())
+			{
+				Vector<T, 3> product{};
+				simd_t::store(product.data(), simd_t::cross(simd_t::load(lhs.data()), simd_t::load(rhs.data())));
+				return product;
+			}
+		}
 		return Vector<T, 3>{lhs[1] * rhs[2] - lhs[2] * rhs[1],
-			lhs[0] * rhs[2] - lhs[2] * rhs[0],
+			lhs[2] * rhs[0] - lhs[0] * rhs[2],
 			lhs[0] * rhs[1] - lhs[1] * rhs[0]};
 	}
 
+	template<vector_expr L, vector_expr R> requires (expr::compatible<L, R> && L::dim_v == 3 && !(L::is_leaf && R::is_leaf))
+	constexpr Vector<typename L::value_type, 3> cross(const L& lhs, const R& rhs) noexcept
+	{
+		return cross(eval(lhs), eval(rhs));
+	}
+
+	// z of the 3D cross product of (lhs, 0) and (rhs, 0): positive when rhs is
+	// counter-clockwise of lhs in a y-up frame.
+	template<valid_vec_type T>
+	constexpr T cross(const Vector<T, 2>& lhs, const Vector<T, 2>& rhs) noexcept
+	{
+		return lhs[0] * rhs[1] - lhs[1] * rhs[0];
+	}
+
 	template<std::integral T, size_t dim>
 	constexpr Vector<float, dim> unit_vector(const Vector<T, dim>& vec) noexcept
 	{
@@ -304,6 +342,12 @@ namespace clm::math {
 	{
 		return vec / vec.length();
 	}
+
+	template<vector_expr E> requires (!E::is_leaf)
+	constexpr auto unit_vector(const E& expression) noexcept
+	{
+		return unit_vector(eval(expression));
+	}
 }
 
 #endif
\ No newline at end of file
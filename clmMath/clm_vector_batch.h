@@ -0,0 +1,332 @@
+#ifndef CLM_VECTOR_BATCH_H
+#define CLM_VECTOR_BATCH_H
+
+#include <array>
+#include <vector>
+#include <span>
+#include <cassert>
+#include <concepts>
+#include <type_traits>
+
+#include <clmUtil/clm_aligned_alloc.h>
+
+#include "clm_vector.h"
+#include "clm_simd_pack.h"
+#include "clm_dispatch.h"
+
+namespace clm::math {
+	// Structure-of-arrays storage for many Vector<T, dim>: component axis of every vector
+	// lives in its own contiguous, 64-byte aligned array so the batch kernels below can
+	// fill a whole register with the same component of consecutive vectors.
+	template<valid_vec_type T, size_t dim>
+	class VectorBatch
+	{
+	public:
+		using component_t = std::vector<T, util::aligned_allocator<T>>;
+
+		VectorBatch() = default;
+		explicit VectorBatch(size_t count)
+		{
+			resize(count);
+		}
+		explicit VectorBatch(std::span<const Vector<T, dim>> vecs)
+		{
+			load(vecs);
+		}
+		~VectorBatch() = default;
+		VectorBatch(const VectorBatch&) = default;
+		VectorBatch(VectorBatch&&) noexcept = default;
+		VectorBatch& operator=(const VectorBatch&) = default;
+		VectorBatch& operator=(VectorBatch&&) noexcept = default;
+
+		size_t size() const noexcept
+		{
+			return m_components[0].size();
+		}
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+		void resize(size_t count)
+		{
+			for (auto& component : m_components)
+			{
+				component.resize(count);
+			}
+		}
+		void reserve(size_t count)
+		{
+			for (auto& component : m_components)
+			{
+				component.reserve(count);
+			}
+		}
+		void clear() noexcept
+		{
+			for (auto& component : m_components)
+			{
+				component.clear();
+			}
+		}
+
+		T* component(size_t axis) noexcept
+		{
+			return m_components[axis].data();
+		}
+		const T* component(size_t axis) const noexcept
+		{
+			return m_components[axis].data();
+		}
+		// Every component pointer at once, the form the dispatched kernels take.
+		std::array<T*, dim> components() noexcept
+		{
+			std::array<T*, dim> ptrs{};
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				ptrs[axis] = component(axis);
+			}
+			return ptrs;
+		}
+		std::array<const T*, dim> components() const noexcept
+		{
+			std::array<const T*, dim> ptrs{};
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				ptrs[axis] = component(axis);
+			}
+			return ptrs;
+		}
+
+		Vector<T, dim> get(size_t index) const noexcept
+		{
+			Vector<T, dim> vec{};
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				vec[axis] = m_components[axis][index];
+			}
+			return vec;
+		}
+		void set(size_t index, const Vector<T, dim>& vec) noexcept
+		{
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				m_components[axis][index] = vec[axis];
+			}
+		}
+		void push_back(const Vector<T, dim>& vec)
+		{
+			for (size_t axis = 0; axis < dim; axis++)
+			{
+				m_components[axis].push_back(vec[axis]);
+			}
+		}
+
+		// Transposes an array of Vectors into the batch, replacing its contents.
+		void load(std::span<const Vector<T, dim>> vecs)
+		{
+			resize(vecs.size());
+			for (size_t i = 0; i < vecs.size(); i++)
+			{
+				set(i, vecs[i]);
+			}
+		}
+		// Transposes the batch back out; out must hold at least size() vectors.
+		void store(std::span<Vector<T, dim>> out) const noexcept
+		{
+			assert(out.size() >= size());
+			for (size_t i = 0; i < size(); i++)
+			{
+				out[i] = get(i);
+			}
+		}
+		std::vector<Vector<T, dim>> to_vectors() const
+		{
+			std::vector<Vector<T, dim>> vecs(size());
+			store(vecs);
+			return vecs;
+		}
+	private:
+		std::array<component_t, dim> m_components;
+	};
+
+	template<valid_vec_type T>
+	using Vec2Batch = VectorBatch<T, 2>;
+	using Vec2fBatch = VectorBatch<float, 2>;
+	template<valid_vec_type T>
+	using Vec3Batch = VectorBatch<T, 3>;
+	using Vec3fBatch = VectorBatch<float, 3>;
+	using Vec3dBatch = VectorBatch<double, 3>;
+
+	// float and double batches go through the runtime dispatched kernels (clm_dispatch.h),
+	// so they use the widest instruction set the CPU has rather than the one the build
+	// targets. Other element types, and dimensions above dispatch::max_kernel_dim, run the
+	// inline pack kernels.
+	template<typename T, size_t dim>
+	inline constexpr bool dispatched_batch = dispatch::dispatched_type<T> && dim <= dispatch::max_kernel_dim;
+
+	template<valid_vec_type T, size_t dim>
+	void add(const VectorBatch<T, dim>& lhs, const VectorBatch<T, dim>& rhs, VectorBatch<T, dim>& out)
+	{
+		assert(lhs.size() == rhs.size());
+		out.resize(lhs.size());
+		for (size_t axis = 0; axis < dim; axis++)
+		{
+			const T* a = lhs.component(axis);
+			const T* b = rhs.component(axis);
+			T* o = out.component(axis);
+			if constexpr (dispatch::dispatched_type<T>)
+			{
+				dispatch::batch_kernels<T>().add(a, b, o, lhs.size());
+			}
+			else
+			{
+				simd::for_each_pack<T>(lhs.size(), [=]<typename P>(size_t i) {
+					P::store(o + i, P::add(P::load(a + i), P::load(b + i)));
+				});
+			}
+		}
+	}
+
+	template<valid_vec_type T, size_t dim>
+	void scale(const VectorBatch<T, dim>& vecs, T factor, VectorBatch<T, dim>& out)
+	{
+		out.resize(vecs.size());
+		for (size_t axis = 0; axis < dim; axis++)
+		{
+			const T* a = vecs.component(axis);
+			T* o = out.component(axis);
+			if constexpr (dispatch::dispatched_type<T>)
+			{
+				dispatch::batch_kernels<T>().scale(a, factor, o, vecs.size());
+			}
+			else
+			{
+				simd::for_each_pack<T>(vecs.size(), [=]<typename P>(size_t i) {
+					P::store(o + i, P::mul(P::load(a + i), P::set1(factor)));
+				});
+			}
+		}
+	}
+
+	template<valid_vec_type T, size_t dim>
+	void dot(const VectorBatch<T, dim>& lhs, const VectorBatch<T, dim>& rhs, std::span<std::type_identity_t<T>> out)
+	{
+		assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+		T* o = out.data();
+		if constexpr (dispatched_batch<T, dim>)
+		{
+			dispatch::batch_kernels<T>().dot(lhs.components().data(), rhs.components().data(), dim, o, lhs.size());
+		}
+		else
+		{
+			simd::for_each_pack<T>(lhs.size(), [&]<typename P>(size_t i) {
+				auto sum = P::zero();
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					sum = P::fmadd(P::load(lhs.component(axis) + i), P::load(rhs.component(axis) + i), sum);
+				}
+				P::store(o + i, sum);
+			});
+		}
+	}
+
+	template<valid_vec_type T>
+	void cross(const VectorBatch<T, 3>& lhs, const VectorBatch<T, 3>& rhs, VectorBatch<T, 3>& out)
+	{
+		assert(lhs.size() == rhs.size());
+		out.resize(lhs.size());
+		if constexpr (dispatch::dispatched_type<T>)
+		{
+			dispatch::batch_kernels<T>().cross(lhs.components().data(), rhs.components().data(), out.components().data(), lhs.size());
+		}
+		else
+		{
+			simd::for_each_pack<T>(lhs.size(), [&]<typename P>(size_t i) {
+				auto ax = P::load(lhs.component(0) + i);
+				auto ay = P::load(lhs.component(1) + i);
+				auto az = P::load(lhs.component(2) + i);
+				auto bx = P::load(rhs.component(0) + i);
+				auto by = P::load(rhs.component(1) + i);
+				auto bz = P::load(rhs.component(2) + i);
+				P::store(out.component(0) + i, P::sub(P::mul(ay, bz), P::mul(az, by)));
+				P::store(out.component(1) + i, P::sub(P::mul(az, bx), P::mul(ax, bz)));
+				P::store(out.component(2) + i, P::sub(P::mul(ax, by), P::mul(ay, bx)));
+			});
+		}
+	}
+
+	template<std::floating_point T, size_t dim>
+	void length(const VectorBatch<T, dim>& vecs, std::span<std::type_identity_t<T>> out)
+	{
+		assert(out.size() >= vecs.size());
+		T* o = out.data();
+		if constexpr (dispatched_batch<T, dim>)
+		{
+			dispatch::batch_kernels<T>().length(vecs.components().data(), dim, o, vecs.size());
+		}
+		else
+		{
+			simd::for_each_pack<T>(vecs.size(), [&]<typename P>(size_t i) {
+				auto sum = P::zero();
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					auto c = P::load(vecs.component(axis) + i);
+					sum = P::fmadd(c, c, sum);
+				}
+				P::store(o + i, P::sqrt(sum));
+			});
+		}
+	}
+
+	template<std::floating_point T, size_t dim>
+	void unit_vector(const VectorBatch<T, dim>& vecs, VectorBatch<T, dim>& out)
+	{
+		out.resize(vecs.size());
+		if constexpr (dispatched_batch<T, dim>)
+		{
+			dispatch::batch_kernels<T>().normalize(vecs.components().data(), out.components().data(), dim, vecs.size());
+		}
+		else
+		{
+			simd::for_each_pack<T>(vecs.size(), [&]<typename P>(size_t i) {
+				std::array<typename P::reg_t, dim> comps{};
+				auto sum = P::zero();
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					comps[axis] = P::load(vecs.component(axis) + i);
+					sum = P::fmadd(comps[axis], comps[axis], sum);
+				}
+				auto len = P::sqrt(sum);
+				for (size_t axis = 0; axis < dim; axis++)
+				{
+					P::store(out.component(axis) + i, P::div(comps[axis], len));
+				}
+			});
+		}
+	}
+
+	template<valid_vec_type T, size_t dim>
+	void midpoint(const VectorBatch<T, dim>& lhs, const VectorBatch<T, dim>& rhs, VectorBatch<T, dim>& out)
+	{
+		assert(lhs.size() == rhs.size());
+		out.resize(lhs.size());
+		for (size_t axis = 0; axis < dim; axis++)
+		{
+			const T* a = lhs.component(axis);
+			const T* b = rhs.component(axis);
+			T* o = out.component(axis);
+			simd::for_each_pack<T>(lhs.size(), [=]<typename P>(size_t i) {
+				if constexpr (std::floating_point<T>)
+				{
+					P::store(o + i, P::mul(P::add(P::load(a + i), P::load(b + i)), P::set1(static_cast<T>(0.5))));
+				}
+				else
+				{
+					P::store(o + i, P::div(P::add(P::load(a + i), P::load(b + i)), P::set1(static_cast<T>(2))));
+				}
+			});
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#ifndef CLM_VECTOR_EXPR_H
+#define CLM_VECTOR_EXPR_H
+
+#include <cstddef>
+#include <concepts>
+#include <type_traits>
+
+#include "clm_vector_simd.h"
+
+namespace clm::math {
+	// Lazy arithmetic for Vector. The operators below build small expression nodes instead
+	// of Vectors; nothing is computed until the expression is assigned to a Vector, used to
+	// construct one, or passed to dot(). At that point the whole tree is evaluated in one
+	// pass, either one element at a time or, for the SIMD-backed Vector shapes, one register.
+	//
+	// Nodes hold references to the Vectors they were built from, so an expression must not
+	// outlive its operands: write "Vector v = a + b;", not "auto v = a + b;".
+	struct vector_expr_base {};
+
+	template<typename E>
+	concept vector_expr = std::derived_from<std::remove_cvref_t<E>, vector_expr_base>;
+
+	template<typename U>
+	concept vector_scalar = std::floating_point<U> || std::integral<U>;
+
+	namespace expr {
+		template<typename L, typename R>
+		concept compatible = std::same_as<typename L::value_type, typename R::value_type> && (L::dim_v == R::dim_v);
+
+		// Vectors (and types derived from them) are captured by reference, nodes by value.
+		template<typename E>
+		using operand_t = std::conditional_t<E::is_leaf, const E&, E>;
+
+		struct add_op
+		{
+			template<typename T>
+			static constexpr T apply(T lhs, T rhs) noexcept { return lhs + rhs; }
+			template<typename S, typename Reg>
+			static Reg apply_reg(Reg lhs, Reg rhs) noexcept { return S::add(lhs, rhs); }
+		};
+
+		struct sub_op
+		{
+			template<typename T>
+			static constexpr T apply(T lhs, T rhs) noexcept { return lhs - rhs; }
+			template<typename S, typename Reg>
+			static Reg apply_reg(Reg lhs, Reg rhs) noexcept { return S::sub(lhs, rhs); }
+		};
+
+		struct mul_op
+		{
+			template<typename T>
+			static constexpr T apply(T lhs, T rhs) noexcept { return lhs * rhs; }
+			template<typename S, typename Reg, typename T>
+			static Reg apply_reg(Reg lhs, T rhs) noexcept { return S::mul(lhs, rhs); }
+		};
+
+		struct div_op
+		{
+			template<typename T>
+			static constexpr T apply(T lhs, T rhs) noexcept { return lhs / rhs; }
+			template<typename S, typename Reg, typename T>
+			static Reg apply_reg(Reg lhs, T rhs) noexcept { return S::div(lhs, rhs); }
+		};
+
+		template<typename L, typename R, typename Op>
+		class binary : public vector_expr_base
+		{
+		public:
+			using value_type = typename L::value_type;
+			static constexpr size_t dim_v = L::dim_v;
+			static constexpr bool is_leaf = false;
+			using simd_t = simd::vec_traits<value_type, dim_v>;
+
+			constexpr binary(const L& lhs, const R& rhs) noexcept
+				:
+				m_lhs(lhs), m_rhs(rhs)
+			{}
+
+			constexpr value_type operator[](size_t pos) const noexcept
+			{
+				return Op::apply(static_cast<value_type>(m_lhs[pos]), static_cast<value_type>(m_rhs[pos]));
+			}
+
+			auto eval_reg() const noexcept requires simd_t::enabled
+			{
+				return Op::template apply_reg<simd_t>(m_lhs.eval_reg(), m_rhs.eval_reg());
+			}
+		private:
+			operand_t<L> m_lhs;
+			operand_t<R> m_rhs;
+		};
+
+		template<typename E, typename Op>
+		class scalar : public vector_expr_base
+		{
+		public:
+			using value_type = typename E::value_type;
+			static constexpr size_t dim_v = E::dim_v;
+			static constexpr bool is_leaf = false;
+			using simd_t = simd::vec_traits<value_type, dim_v>;
+
+			constexpr scalar(const E& vec, value_type factor) noexcept
+				:
+				m_vec(vec), m_factor(factor)
+			{}
+
+			constexpr value_type operator[](size_t pos) const noexcept
+			{
+				return Op::apply(static_cast<value_type>(m_vec[pos]), m_factor);
+			}
+
+			auto eval_reg() const noexcept requires simd_t::enabled
+			{
+				return Op::template apply_reg<simd_t>(m_vec.eval_reg(), m_factor);
+			}
+		private:
+			operand_t<E> m_vec;
+			value_type m_factor;
+		};
+
+		template<typename E>
+		class negate : public vector_expr_base
+		{
+		public:
+			using value_type = typename E::value_type;
+			static constexpr size_t dim_v = E::dim_v;
+			static constexpr bool is_leaf = false;
+			using simd_t = simd::vec_traits<value_type, dim_v>;
+
+			constexpr explicit negate(const E& vec) noexcept
+				:
+				m_vec(vec)
+			{}
+
+			constexpr value_type operator[](size_t pos) const noexcept
+			{
+				return static_cast<value_type>(-m_vec[pos]);
+			}
+
+			auto eval_reg() const noexcept requires simd_t::enabled
+			{
+				return simd_t::neg(m_vec.eval_reg());
+			}
+		private:
+			operand_t<E> m_vec;
+		};
+	}
+
+	template<vector_expr L, vector_expr R> requires expr::compatible<L, R>
+	constexpr expr::binary<L, R, expr::add_op> operator+(const L& lhs, const R& rhs) noexcept
+	{
+		return {lhs, rhs};
+	}
+
+	template<vector_expr L, vector_expr R> requires expr::compatible<L, R>
+	constexpr expr::binary<L, R, expr::sub_op> operator-(const L& lhs, const R& rhs) noexcept
+	{
+		return {lhs, rhs};
+	}
+
+	template<vector_expr E, vector_scalar U>
+	constexpr expr::scalar<E, expr::mul_op> operator*(const E& lhs, U rhs) noexcept
+	{
+		return {lhs, static_cast<typename E::value_type>(rhs)};
+	}
+
+	template<vector_scalar U, vector_expr E>
+	constexpr expr::scalar<E, expr::mul_op> operator*(U lhs, const E& rhs) noexcept
+	{
+		return {rhs, static_cast<typename E::value_type>(lhs)};
+	}
+
+	template<vector_expr E, vector_scalar U>
+	constexpr expr::scalar<E, expr::div_op> operator/(const E& lhs, U rhs) noexcept
+	{
+		return {lhs, static_cast<typename E::value_type>(rhs)};
+	}
+
+	template<vector_expr E>
+	constexpr expr::negate<E> operator-(const E& rhs) noexcept
+	{
+		return expr::negate<E>{rhs};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#ifndef CLM_VECTOR_SIMD_H
+#define CLM_VECTOR_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Define CLM_NO_SIMD to force every Vector down the scalar path.
+#if !defined(CLM_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__))
+#define CLM_SIMD_SSE 1
+#include <immintrin.h>
+#if defined(__AVX__)
+#define CLM_SIMD_AVX 1
+#endif
+#if defined(__AVX2__)
+#define CLM_SIMD_AVX2 1
+#endif
+// MSVC has no __FMA__; /arch:AVX2 implies FMA3.
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define CLM_SIMD_FMA 1
+#endif
+#if defined(__AVX512F__)
+#define CLM_SIMD_AVX512 1
+#endif
+#endif
+
+namespace clm::math::simd {
+	// Storage and register operations for Vector<T, dim>. The generic traits keep the
+	// plain std::array<T, dim> layout; the specializations below pad the storage out to
+	// a full register so every operator is a single aligned load, op and store.
+	template<typename T, size_t dim>
+	struct vec_traits
+	{
+		static constexpr bool enabled = false;
+		static constexpr size_t storage_dim = dim;
+		static constexpr size_t alignment = alignof(T);
+	};
+
+#ifdef CLM_SIMD_SSE
+	struct sse_float_ops
+	{
+		using reg_t = __m128;
+
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm_add_ps(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm_sub_ps(lhs, rhs); }
+		static reg_t mul(reg_t lhs, float rhs) noexcept { return _mm_mul_ps(lhs, _mm_set1_ps(rhs)); }
+		static reg_t div(reg_t lhs, float rhs) noexcept { return _mm_div_ps(lhs, _mm_set1_ps(rhs)); }
+		static reg_t neg(reg_t val) noexcept { return _mm_xor_ps(val, _mm_set1_ps(-0.0f)); }
+
+		static float hsum(reg_t val) noexcept
+		{
+			__m128 shuf = _mm_shuffle_ps(val, val, _MM_SHUFFLE(2, 3, 0, 1));
+			__m128 sums = _mm_add_ps(val, shuf);
+			shuf = _mm_movehl_ps(shuf, sums);
+			sums = _mm_add_ss(sums, shuf);
+			return _mm_cvtss_f32(sums);
+		}
+	};
+
+	template<>
+	struct vec_traits<float, 2> : sse_float_ops
+	{
+		static constexpr bool enabled = true;
+		static constexpr size_t storage_dim = 2;
+		static constexpr size_t alignment = 8;
+
+		// Two floats are moved as one 64-bit lane; the upper half of the register is zero.
+		// __m128i is declared may_alias, so the cast is safe where a double* would not be.
+		static reg_t load(const float* ptr) noexcept
+		{
+			return _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)));
+		}
+		static void store(float* ptr, reg_t val) noexcept
+		{
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), _mm_castps_si128(val));
+		}
+		static float dot(reg_t lhs, reg_t rhs) noexcept
+		{
+			__m128 prod = _mm_mul_ps(lhs, rhs);
+			return _mm_cvtss_f32(_mm_add_ss(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(1, 1, 1, 1))));
+		}
+	};
+
+	template<>
+	struct vec_traits<float, 3> : sse_float_ops
+	{
+		static constexpr bool enabled = true;
+		static constexpr size_t storage_dim = 4;
+		static constexpr size_t alignment = 16;
+
+		static reg_t load(const float* ptr) noexcept { return _mm_load_ps(ptr); }
+		static void store(float* ptr, reg_t val) noexcept { _mm_store_ps(ptr, val); }
+
+		// The padding lane is normally zero but may hold NaN after a division by zero,
+		// so it is masked out of the reduction.
+		static float dot(reg_t lhs, reg_t rhs) noexcept
+		{
+			const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+			return hsum(_mm_and_ps(_mm_mul_ps(lhs, rhs), mask));
+		}
+		static reg_t cross(reg_t lhs, reg_t rhs) noexcept
+		{
+			__m128 lhsYZX = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 0, 2, 1));
+			__m128 rhsYZX = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 2, 1));
+			__m128 diff = _mm_sub_ps(_mm_mul_ps(lhs, rhsYZX), _mm_mul_ps(lhsYZX, rhs));
+			return _mm_shuffle_ps(diff, diff, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+	};
+
+	template<>
+	struct vec_traits<float, 4> : sse_float_ops
+	{
+		static constexpr bool enabled = true;
+		static constexpr size_t storage_dim = 4;
+		static constexpr size_t alignment = 16;
+
+		static reg_t load(const float* ptr) noexcept { return _mm_load_ps(ptr); }
+		static void store(float* ptr, reg_t val) noexcept { _mm_store_ps(ptr, val); }
+		static float dot(reg_t lhs, reg_t rhs) noexcept { return hsum(_mm_mul_ps(lhs, rhs)); }
+	};
+
+	template<>
+	struct vec_traits<double, 2>
+	{
+		using reg_t = __m128d;
+		static constexpr bool enabled = true;
+		static constexpr size_t storage_dim = 2;
+		static constexpr size_t alignment = 16;
+
+		static reg_t load(const double* ptr) noexcept { return _mm_load_pd(ptr); }
+		static void store(double* ptr, reg_t val) noexcept { _mm_store_pd(ptr, val); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm_add_pd(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm_sub_pd(lhs, rhs); }
+		static reg_t mul(reg_t lhs, double rhs) noexcept { return _mm_mul_pd(lhs, _mm_set1_pd(rhs)); }
+		static reg_t div(reg_t lhs, double rhs) noexcept { return _mm_div_pd(lhs, _mm_set1_pd(rhs)); }
+		static reg_t neg(reg_t val) noexcept { return _mm_xor_pd(val, _mm_set1_pd(-0.0)); }
+		static double dot(reg_t lhs, reg_t rhs) noexcept
+		{
+			__m128d prod = _mm_mul_pd(lhs, rhs);
+			return _mm_cvtsd_f64(_mm_add_sd(prod, _mm_unpackhi_pd(prod, prod)));
+		}
+	};
+
+#ifdef CLM_SIMD_AVX
+	template<>
+	struct vec_traits<double, 4>
+	{
+		using reg_t = __m256d;
+		static constexpr bool enabled = true;
+		static constexpr size_t storage_dim = 4;
+		static constexpr size_t alignment = 32;
+
+		static reg_t load(const double* ptr) noexcept { return _mm256_load_pd(ptr); }
+		static void store(double* ptr, reg_t val) noexcept { _mm256_store_pd(ptr, val); }
+		static reg_t add(reg_t lhs, reg_t rhs) noexcept { return _mm256_add_pd(lhs, rhs); }
+		static reg_t sub(reg_t lhs, reg_t rhs) noexcept { return _mm256_sub_pd(lhs, rhs); }
+		static reg_t mul(reg_t lhs, double rhs) noexcept { return _mm256_mul_pd(lhs, _mm256_set1_pd(rhs)); }
+		static reg_t div(reg_t lhs, double rhs) noexcept { return _mm256_div_pd(lhs, _mm256_set1_pd(rhs)); }
+		static reg_t neg(reg_t val) noexcept { return _mm256_xor_pd(val, _mm256_set1_pd(-0.0)); }
+		static double dot(reg_t lhs, reg_t rhs) noexcept
+		{
+			__m256d prod = _mm256_mul_pd(lhs, rhs);
+			__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(prod), _mm256_extractf128_pd(prod, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+		}
+	};
+#endif
+#endif
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef CLM_ALIGNED_ALLOC_H
+#define CLM_ALIGNED_ALLOC_H
+
+#include <cstddef>
+#include <new>
+#include <limits>
+
+namespace clm::util {
+	// Allocator for containers whose storage is fed straight to aligned SIMD loads.
+	// The default of 64 bytes covers an AVX-512 register and a cache line.
+	template<typename T, size_t Align = 64>
+	class aligned_allocator {
+	public:
+		static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "Alignment must be a power of two no smaller than alignof(T).");
+		using value_type = T;
+
+		template<typename U>
+		struct rebind
+		{
+			using other = aligned_allocator<U, Align>;
+		};
+
+		constexpr aligned_allocator() noexcept = default;
+		template<typename U>
+		constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+		[[nodiscard]] T* allocate(size_t count)
+		{
+			if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+			{
+				throw std::bad_array_new_length{};
+			}
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Align}));
+		}
+
+		void deallocate(T* ptr, size_t) noexcept
+		{
+			::operator delete(ptr, std::align_val_t{Align});
+		}
+
+		template<typename U>
+		constexpr bool operator==(const aligned_allocator<U, Align>&) const noexcept
+		{
+			return true;
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include <clmUtil/clm_cpu.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <array>
+#include <algorithm>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CLM_CPU_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CLM_CPU_X86 1
+#endif
+
+namespace clm::util {
+	namespace {
+#ifdef CLM_CPU_X86
+		using cpuid_regs = std::array<std::uint32_t, 4>;
+
+		cpuid_regs cpuid(std::uint32_t leaf, std::uint32_t subleaf) noexcept
+		{
+			cpuid_regs regs{};
+#ifdef _MSC_VER
+			int out[4]{};
+			__cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (size_t i = 0; i < 4; i++)
+			{
+				regs[i] = static_cast<std::uint32_t>(out[i]);
+			}
+#else
+			__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+			return regs;
+		}
+
+		// XCR0, the register state the OS saves on context switch. Only valid to read
+		// once cpuid reports OSXSAVE.
+		std::uint64_t xgetbv0() noexcept
+		{
+#ifdef _MSC_VER
+			return _xgetbv(0);
+#else
+			std::uint32_t eax{};
+			std::uint32_t edx{};
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+		}
+
+		constexpr bool bit(std::uint32_t reg, unsigned index) noexcept
+		{
+			return ((reg >> index) & 1u) != 0;
+		}
+#endif
+
+		cpu_features detect() noexcept
+		{
+			cpu_features features{};
+#ifdef CLM_CPU_X86
+			const std::uint32_t maxLeaf = cpuid(0, 0)[0];
+			if (maxLeaf < 1)
+			{
+				return features;
+			}
+			const cpuid_regs leaf1 = cpuid(1, 0);
+			features.sse2 = bit(leaf1[3], 26);
+			features.sse3 = bit(leaf1[2], 0);
+			features.ssse3 = bit(leaf1[2], 9);
+			features.fma = bit(leaf1[2], 12);
+			features.sse41 = bit(leaf1[2], 19);
+			features.sse42 = bit(leaf1[2], 20);
+			features.popcnt = bit(leaf1[2], 23);
+			features.avx = bit(leaf1[2], 28);
+
+			if (bit(leaf1[2], 27))
+			{
+				const std::uint64_t xcr0 = xgetbv0();
+				// XMM and YMM state, then opmask, ZMM_Hi256 and Hi16_ZMM on top of that.
+				features.osAvx = (xcr0 & 0x6) == 0x6;
+				features.osAvx512 = features.osAvx && (xcr0 & 0xE0) == 0xE0;
+			}
+
+			if (maxLeaf >= 7)
+			{
+				const cpuid_regs leaf7 = cpuid(7, 0);
+				features.bmi1 = bit(leaf7[1], 3);
+				features.avx2 = bit(leaf7[1], 5);
+				features.bmi2 = bit(leaf7[1], 8);
+				features.avx512f = bit(leaf7[1], 16);
+				features.avx512dq = bit(leaf7[1], 17);
+				features.avx512bw = bit(leaf7[1], 30);
+				features.avx512vl = bit(leaf7[1], 31);
+			}
+
+			if (cpuid(0x80000000u, 0)[0] >= 0x80000001u)
+			{
+				features.lzcnt = bit(cpuid(0x80000001u, 0)[2], 5);
+			}
+#endif
+			return features;
+		}
+
+		simd_level level_of(const cpu_features& features) noexcept
+		{
+			if (features.avx512f && features.osAvx512 && features.avx2 && features.fma)
+			{
+				return simd_level::avx512;
+			}
+			if (features.avx2 && features.fma && features.osAvx)
+			{
+				return simd_level::avx2;
+			}
+			if (features.avx && features.osAvx)
+			{
+				return simd_level::avx;
+			}
+			if (features.sse41)
+			{
+				return simd_level::sse41;
+			}
+			if (features.sse2)
+			{
+				return simd_level::sse2;
+			}
+			return simd_level::scalar;
+		}
+
+		simd_level startup_level() noexcept
+		{
+			const simd_level detected = detected_simd_level();
+#ifdef _MSC_VER
+#pragma warning(suppress : 4996)
+#endif
+			const char* env = std::getenv("CLM_SIMD_LEVEL");
+			if (env == nullptr)
+			{
+				return detected;
+			}
+			const auto requested = parse_simd_level(env);
+			return requested ? std::min(*requested, detected) : detected;
+		}
+
+		constexpr std::uint8_t unset = 0xFF;
+		std::atomic<std::uint8_t> activeLevel{unset};
+
+		constexpr std::array<std::string_view, simd_level_count> levelNames{
+			"scalar", "sse2", "sse41", "avx", "avx2", "avx512"
+		};
+	}
+
+	const cpu_features& cpu_info() noexcept
+	{
+		static const cpu_features features = detect();
+		return features;
+	}
+
+	simd_level detected_simd_level() noexcept
+	{
+		static const simd_level level = level_of(cpu_info());
+		return level;
+	}
+
+	simd_level active_simd_level() noexcept
+	{
+		std::uint8_t level = activeLevel.load(std::memory_order_relaxed);
+		if (level == unset)
+		{
+			std::uint8_t expected = unset;
+			level = static_cast<std::uint8_t>(startup_level());
+			if (!activeLevel.compare_exchange_strong(expected, level, std::memory_order_relaxed))
+			{
+				level = expected;
+			}
+		}
+		return static_cast<simd_level>(level);
+	}
+
+	simd_level force_simd_level(simd_level level) noexcept
+	{
+		const simd_level applied = std::min(level, detected_simd_level());
+		activeLevel.store(static_cast<std::uint8_t>(applied), std::memory_order_relaxed);
+		return applied;
+	}
+
+	void reset_simd_level() noexcept
+	{
+		activeLevel.store(static_cast<std::uint8_t>(startup_level()), std::memory_order_relaxed);
+	}
+
+	std::string_view to_string(simd_level level) noexcept
+	{
+		const size_t index = static_cast<size_t>(level);
+		return index < levelNames.size() ? levelNames[index] : std::string_view{"unknown"};
+	}
+
+	std::optional<simd_level> parse_simd_level(std::string_view name) noexcept
+	{
+		for (size_t i = 0; i < levelNames.size(); i++)
+		{
+			if (levelNames[i] == name)
+			{
+				return static_cast<simd_level>(i);
+			}
+		}
+		return std::nullopt;
+	}
+}
\ No newline at end of file
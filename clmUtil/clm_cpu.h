@@ -0,0 +1,70 @@
+#ifndef CLM_CPU_H
+#define CLM_CPU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace clm::util {
+	// Instruction set tiers the runtime dispatch chooses between, in increasing order.
+	// avx2 implies FMA3 and avx512 implies AVX-512F on top of avx2.
+	enum class simd_level : std::uint8_t
+	{
+		scalar,
+		sse2,
+		sse41,
+		avx,
+		avx2,
+		avx512
+	};
+	inline constexpr size_t simd_level_count = 6;
+
+	// What cpuid and xgetbv report. The os_* flags say whether the OS saves the wide
+	// register state; an instruction set is only usable when both halves agree.
+	struct cpu_features
+	{
+		bool sse2 = false;
+		bool sse3 = false;
+		bool ssse3 = false;
+		bool sse41 = false;
+		bool sse42 = false;
+		bool popcnt = false;
+		bool lzcnt = false;
+		bool bmi1 = false;
+		bool bmi2 = false;
+		bool avx = false;
+		bool avx2 = false;
+		bool fma = false;
+		bool avx512f = false;
+		bool avx512dq = false;
+		bool avx512bw = false;
+		bool avx512vl = false;
+		bool osAvx = false;
+		bool osAvx512 = false;
+	};
+
+	// Detected once on first use; every call after that is a plain load.
+	const cpu_features& cpu_info() noexcept;
+
+	// Highest level both the CPU and the OS support.
+	simd_level detected_simd_level() noexcept;
+
+	// Level the dispatched kernels currently use. Starts at detected_simd_level(), lowered
+	// by the CLM_SIMD_LEVEL environment variable (scalar, sse2, sse41, avx, avx2, avx512)
+	// when it is set.
+	simd_level active_simd_level() noexcept;
+
+	// Routes every dispatched kernel through level, clamped to detected_simd_level() so a
+	// forced level can never fault. Returns the level actually applied. Meant for tests
+	// and benchmarks comparing code paths; not synchronised with kernels already running.
+	simd_level force_simd_level(simd_level level) noexcept;
+
+	// Undoes force_simd_level, going back to the startup level.
+	void reset_simd_level() noexcept;
+
+	std::string_view to_string(simd_level level) noexcept;
+	std::optional<simd_level> parse_simd_level(std::string_view name) noexcept;
+}
+
+#endif
\ No newline at end of file
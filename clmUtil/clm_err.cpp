@@ -1,22 +1,22 @@
 #include <clmUtil/clm_err.h>
+#include <clmUtil/clm_result.h>
 
 #include <format>
+#include <stdexcept>
 
 namespace clm::err {
-	void assert(bool condition,
-				std::string msg,
-				std::source_location location)
+	void detail::assert_failed(std::string_view msg, const std::source_location& location)
 	{
-#ifdef _DEBUG
-		if (!condition)
-		{
-			throw std::runtime_error(std::format("{}\nFile: {}\nFunction: {}\nLine: {}",
-												 msg,
-												 location.file_name(),
-												 location.function_name(),
-												 location.line()));
-		}
-#endif
+		throw std::runtime_error(std::format("{}\nFile: {}\nFunction: {}\nLine: {}",
+											 msg,
+											 location.file_name(),
+											 location.function_name(),
+											 location.line()));
+	}
+
+	void detail::vulkan_failed(std::string_view msg, const std::source_location& location)
+	{
+		throw VulkanException{std::string{msg}, location};
 	}
 
 	WindowsExceptionBase::WindowsExceptionBase(HRESULT hr, const std::source_location& loc) noexcept
@@ -76,4 +76,23 @@ namespace clm::err {
 	{
 		return m_msg.c_str();
 	}
+
+	vk_runtime_error to_vk_runtime_error(const error& e, std::string_view msg)
+	{
+		return vk_runtime_error{static_cast<VkResult>(e.code), msg, e.location};
+	}
+
+	VulkanException to_vulkan_exception(const error& e, std::string_view msg)
+	{
+		return VulkanException{std::format("{} Code: {}", msg, e.code), e.location};
+	}
+
+	void detail::throw_error(const error& e, std::string_view msg)
+	{
+		if (e.domain == error_domain::vulkan)
+		{
+			throw to_vk_runtime_error(e, msg);
+		}
+		assert_failed(std::string_view{std::format("{} Code: {}", msg, e.code)}, e.location);
+	}
 }
\ No newline at end of file
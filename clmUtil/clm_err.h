@@ -3,7 +3,10 @@
 
 #include <exception>
 #include <string>
+#include <string_view>
 #include <source_location>
+#include <type_traits>
+#include <concepts>
 #include <vector>
 #include <format>
 
@@ -17,10 +20,121 @@
 #include <vulkan/vulkan.h>
 #endif
 
+// Assertions are compiled in for _DEBUG builds; define CLM_ENABLE_ASSERTS to 0 or 1 to
+// override that.
+#ifndef CLM_ENABLE_ASSERTS
+#ifdef _DEBUG
+#define CLM_ENABLE_ASSERTS 1
+#else
+#define CLM_ENABLE_ASSERTS 0
+#endif
+#endif
+
+// Failure handlers: kept out of line and out of the callers' hot code.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CLM_COLD __declspec(noinline)
+#else
+#define CLM_COLD [[gnu::cold, gnu::noinline]]
+#endif
+
+// Like clm::err::assert, except that a disabled assertion does not evaluate its condition
+// or message arguments at all.
+#if CLM_ENABLE_ASSERTS
+#define CLM_ASSERT(condition, ...) (::clm::err::assert)(static_cast<bool>(condition), __VA_ARGS__)
+#else
+#define CLM_ASSERT(condition, ...) static_cast<void>(sizeof(static_cast<bool>(condition)))
+#endif
+
 namespace clm::err {
-	void assert(bool condition,
-				std::string msg,
-				std::source_location location = std::source_location::current());
+	inline constexpr bool assertsEnabled = CLM_ENABLE_ASSERTS != 0;
+
+	// A format string checked at compile time, together with the location of the call it
+	// was written in. Taking it in place of a source_location parameter lets a check have
+	// format arguments after the string and still default the location.
+	template<typename... Args>
+	struct located_format
+	{
+		template<typename S> requires std::convertible_to<const S&, std::string_view>
+		consteval located_format(const S& fmt, std::source_location loc = std::source_location::current())
+			:
+			format(fmt), location(loc)
+		{}
+
+		std::format_string<Args...> format;
+		std::source_location location;
+	};
+
+	namespace detail {
+		[[noreturn]] CLM_COLD void assert_failed(std::string_view msg, const std::source_location& location);
+		[[noreturn]] CLM_COLD void vulkan_failed(std::string_view msg, const std::source_location& location);
+
+		// The message is only formatted here, once the check has failed.
+		template<typename... Args>
+		[[noreturn]] CLM_COLD void assert_failed(std::string_view fmt, const std::source_location& location, const Args&... args)
+		{
+			assert_failed(std::string_view{std::vformat(fmt, std::make_format_args(args...))}, location);
+		}
+		template<typename... Args>
+		[[noreturn]] CLM_COLD void vulkan_failed(std::string_view fmt, const std::source_location& location, const Args&... args)
+		{
+			vulkan_failed(std::string_view{std::vformat(fmt, std::make_format_args(args...))}, location);
+		}
+	}
+
+	// Throws std::runtime_error when condition is false and assertions are enabled. The
+	// passing path is a single predicted branch, and nothing at all when disabled. The
+	// name is parenthesized so the assert macro of <cassert> can't expand it.
+	inline void (assert)(bool condition,
+						 std::string_view msg,
+						 std::source_location location = std::source_location::current())
+	{
+		if constexpr (assertsEnabled)
+		{
+			if (!condition) [[unlikely]]
+			{
+				detail::assert_failed(msg, location);
+			}
+		}
+	}
+
+	// assert(i < size, "index {} out of {}", i, size): the arguments are only formatted on
+	// failure.
+	template<typename Arg, typename... Args>
+	void (assert)(bool condition,
+				  located_format<std::type_identity_t<Arg>, std::type_identity_t<Args>...> fmt,
+				  Arg&& arg,
+				  Args&&... args)
+	{
+		if constexpr (assertsEnabled)
+		{
+			if (!condition) [[unlikely]]
+			{
+				detail::assert_failed(fmt.format.get(), fmt.location, arg, args...);
+			}
+		}
+	}
+
+	// As assert, but checked in every build.
+	inline void check(bool condition,
+					  std::string_view msg,
+					  std::source_location location = std::source_location::current())
+	{
+		if (!condition) [[unlikely]]
+		{
+			detail::assert_failed(msg, location);
+		}
+	}
+	template<typename Arg, typename... Args>
+	void check(bool condition,
+			   located_format<std::type_identity_t<Arg>, std::type_identity_t<Args>...> fmt,
+			   Arg&& arg,
+			   Args&&... args)
+	{
+		if (!condition) [[unlikely]]
+		{
+			detail::assert_failed(fmt.format.get(), fmt.location, arg, args...);
+		}
+	}
 
 	class WindowsExceptionBase : public std::exception {
 	public:
@@ -108,12 +222,24 @@ namespace clm::err {
 		}
 	}
 
-	void inline check_ret_val(VkResult result, std::string errorMsg = "no message", std::source_location loc = std::source_location::current() )
+	// Throws VulkanException unless result is VK_SUCCESS. The message is only copied into
+	// a string on failure.
+	inline void check_ret_val(VkResult result, std::string_view errorMsg = "no message", std::source_location loc = std::source_location::current())
+	{
+		if (result != VK_SUCCESS) [[unlikely]]
+		{
+			detail::vulkan_failed(errorMsg, loc);
+		}
+	}
+	template<typename Arg, typename... Args>
+	void check_ret_val(VkResult result,
+					   located_format<std::type_identity_t<Arg>, std::type_identity_t<Args>...> fmt,
+					   Arg&& arg,
+					   Args&&... args)
 	{
-		if (result != VK_SUCCESS)
+		if (result != VK_SUCCESS) [[unlikely]]
 		{
-			//std::string errorMsg = std::format("Exception thrown\nFile: {}\nFunction: {}\nLine: {}", loc.file_name(), loc.function_name(), loc.line());
-			throw VulkanException{errorMsg, loc};
+			detail::vulkan_failed(fmt.format.get(), fmt.location, arg, args...);
 		}
 	}
 
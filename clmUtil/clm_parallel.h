@@ -0,0 +1,196 @@
+#ifndef CLM_PARALLEL_H
+#define CLM_PARALLEL_H
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <stop_token>
+#include <condition_variable>
+
+namespace clm::util {
+	inline size_t worker_count() noexcept
+	{
+		return std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	namespace detail {
+		// Set on pool workers and on a thread while it runs a pool job, so nested
+		// parallel_for calls run inline instead of waiting on the busy pool.
+		inline thread_local bool inParallelJob = false;
+
+		struct parallel_job_scope
+		{
+			parallel_job_scope() noexcept { inParallelJob = true; }
+			~parallel_job_scope() { inParallelJob = false; }
+			parallel_job_scope(const parallel_job_scope&) = delete;
+			parallel_job_scope& operator=(const parallel_job_scope&) = delete;
+		};
+
+		// worker_count() - 1 threads started on first use and kept until exit, so repeated
+		// parallel_for calls don't pay for thread creation and thread_local scratch buffers
+		// survive between calls. One job runs at a time.
+		class worker_pool
+		{
+		public:
+			using job_fn = void (*)(void*);
+
+			static worker_pool& get()
+			{
+				static worker_pool pool{worker_count() - 1};
+				return pool;
+			}
+
+			size_t size() const noexcept
+			{
+				return m_threads.size();
+			}
+
+			// Runs job(ctx) on the first helpers workers and returns once they are done.
+			// Returns false without running anything if another thread holds the pool.
+			bool try_run(job_fn job, void* ctx, size_t helpers)
+			{
+				std::unique_lock running{m_runMutex, std::try_to_lock};
+				if (!running.owns_lock())
+				{
+					return false;
+				}
+				std::unique_lock lock{m_mutex};
+				m_job = job;
+				m_ctx = ctx;
+				m_helpers = std::min(helpers, m_threads.size());
+				m_pending = m_helpers;
+				m_generation++;
+				lock.unlock();
+				m_wake.notify_all();
+
+				job(ctx);
+
+				lock.lock();
+				m_done.wait(lock, [&]() { return m_pending == 0; });
+				return true;
+			}
+
+		private:
+			explicit worker_pool(size_t threads)
+			{
+				m_threads.reserve(threads);
+				for (size_t i = 0; i < threads; i++)
+				{
+					m_threads.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+				}
+			}
+
+			void work(std::stop_token stop, size_t index)
+			{
+				inParallelJob = true;
+				std::uint64_t seen = 0;
+				std::unique_lock lock{m_mutex};
+				while (m_wake.wait(lock, stop, [&]() { return m_generation != seen; }))
+				{
+					seen = m_generation;
+					if (index >= m_helpers)
+					{
+						continue;
+					}
+					const job_fn job = m_job;
+					void* const ctx = m_ctx;
+					lock.unlock();
+					job(ctx);
+					lock.lock();
+					if (--m_pending == 0)
+					{
+						m_done.notify_one();
+					}
+				}
+			}
+
+			std::mutex m_runMutex;
+			std::mutex m_mutex;
+			std::condition_variable_any m_wake;
+			std::condition_variable m_done;
+			std::uint64_t m_generation = 0;
+			job_fn m_job = nullptr;
+			void* m_ctx = nullptr;
+			size_t m_helpers = 0;
+			size_t m_pending = 0;
+			// Last, so the threads are stopped and joined before the state they use goes.
+			std::vector<std::jthread> m_threads;
+		};
+	}
+
+	// Calls fn(i) for every i in [0, count) across up to worker_count() threads. Indices are
+	// handed out grain at a time from a shared counter, so uneven work balances itself.
+	// The calling thread takes part and the call returns once every index is done. The
+	// first exception thrown by fn is rethrown on the calling thread. The other threads
+	// come from a persistent pool; calls made from inside fn run inline, and a call made
+	// while another thread holds the pool starts threads of its own.
+	template<typename Fn>
+	void parallel_for(size_t count, Fn&& fn, size_t grain = 1, size_t maxThreads = 0)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		grain = std::max<size_t>(1, grain);
+		const size_t chunks = (count + grain - 1) / grain;
+		const size_t threadCount = std::min(chunks, maxThreads == 0 ? worker_count() : maxThreads);
+		if (threadCount <= 1 || detail::inParallelJob)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				fn(i);
+			}
+			return;
+		}
+
+		std::atomic<size_t> next{0};
+		std::exception_ptr error{};
+		std::atomic_flag errorSet{};
+		auto worker = [&]() {
+			try
+			{
+				for (size_t begin = next.fetch_add(grain); begin < count; begin = next.fetch_add(grain))
+				{
+					const size_t end = std::min(count, begin + grain);
+					for (size_t i = begin; i < end; i++)
+					{
+						fn(i);
+					}
+				}
+			}
+			catch (...)
+			{
+				if (!errorSet.test_and_set())
+				{
+					error = std::current_exception();
+				}
+				next.store(count);
+			}
+		};
+
+		{
+			const detail::parallel_job_scope scope{};
+			const auto job = [](void* ctx) { (*static_cast<decltype(worker)*>(ctx))(); };
+			if (!detail::worker_pool::get().try_run(job, &worker, threadCount - 1))
+			{
+				std::vector<std::jthread> threads{};
+				threads.reserve(threadCount - 1);
+				for (size_t t = 1; t < threadCount; t++)
+				{
+					threads.emplace_back(worker);
+				}
+				worker();
+			}
+		}
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
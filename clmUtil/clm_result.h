@@ -0,0 +1,137 @@
+#ifndef CLM_RESULT_H
+#define CLM_RESULT_H
+
+#include <cstdint>
+#include <utility>
+#include <expected>
+#include <string_view>
+#include <type_traits>
+#include <source_location>
+
+#include <clmUtil/clm_err.h>
+
+// Non-throwing error channel for calls whose failures are routine, such as polling fences
+// that return VK_NOT_READY or VK_TIMEOUT. A failure is a small error value that is
+// returned, not thrown; value_or_throw and the to_* adapters turn it into the exceptions
+// of clm_err.h at API boundaries.
+namespace clm::err {
+	enum class error_domain : std::uint8_t
+	{
+		generic,
+		vulkan,
+		windows
+	};
+
+	// A code and the domain it belongs to. location points at static data, so copying an
+	// error never allocates. It is empty (line 0) when the error was made without one.
+	struct error
+	{
+		std::int32_t code = 0;
+		error_domain domain = error_domain::generic;
+		std::source_location location{};
+
+		bool is(VkResult result) const noexcept
+		{
+			return domain == error_domain::vulkan && code == static_cast<std::int32_t>(result);
+		}
+		// Positive VkResults are status codes (VK_NOT_READY, VK_TIMEOUT, VK_INCOMPLETE, ...)
+		// rather than failures; the caller usually retries.
+		bool is_vk_status() const noexcept
+		{
+			return domain == error_domain::vulkan && code > 0;
+		}
+		bool has_location() const noexcept
+		{
+			return location.line() != 0;
+		}
+	};
+	// Code and domain share one 8-byte slot; the rest is source_location, one pointer with
+	// libstdc++ and libc++, four fields with MSVC.
+	static_assert(sizeof(error) <= 8 + sizeof(std::source_location));
+
+	template<typename T = void>
+	using result = std::expected<T, error>;
+
+	inline std::unexpected<error> make_error(VkResult code, std::source_location location = std::source_location::current()) noexcept
+	{
+		return std::unexpected<error>{error{static_cast<std::int32_t>(code), error_domain::vulkan, location}};
+	}
+	inline std::unexpected<error> make_error(error_domain domain, std::int32_t code, std::source_location location = std::source_location::current()) noexcept
+	{
+		return std::unexpected<error>{error{code, domain, location}};
+	}
+	// Without a location, for the hottest loops.
+	inline std::unexpected<error> make_error_code(VkResult code) noexcept
+	{
+		return std::unexpected<error>{error{static_cast<std::int32_t>(code), error_domain::vulkan, std::source_location{}}};
+	}
+
+	// VK_SUCCESS as a value, anything else as an error.
+	inline result<> vk_result(VkResult code, std::source_location location = std::source_location::current()) noexcept
+	{
+		if (code == VK_SUCCESS) [[likely]]
+		{
+			return {};
+		}
+		return make_error(code, location);
+	}
+
+	vk_runtime_error to_vk_runtime_error(const error& e, std::string_view msg = "Vulkan call failed");
+	VulkanException to_vulkan_exception(const error& e, std::string_view msg = "Vulkan call failed");
+
+	namespace detail {
+		// Throws vk_runtime_error for Vulkan errors and std::runtime_error for the rest.
+		[[noreturn]] CLM_COLD void throw_error(const error& e, std::string_view msg);
+	}
+
+	// The value, or the error thrown as an exception; for the boundary between code that
+	// propagates results and code that expects exceptions.
+	template<typename T>
+	T value_or_throw(result<T>&& r, std::string_view msg = "Vulkan call failed")
+	{
+		if (!r) [[unlikely]]
+		{
+			detail::throw_error(r.error(), msg);
+		}
+		if constexpr (!std::is_void_v<T>)
+		{
+			return std::move(*r);
+		}
+	}
+	template<typename T>
+	decltype(auto) value_or_throw(const result<T>& r, std::string_view msg = "Vulkan call failed")
+	{
+		if (!r) [[unlikely]]
+		{
+			detail::throw_error(r.error(), msg);
+		}
+		if constexpr (!std::is_void_v<T>)
+		{
+			return *r;
+		}
+	}
+}
+
+#define CLM_RESULT_CONCAT_IMPL(a, b) a##b
+#define CLM_RESULT_CONCAT(a, b) CLM_RESULT_CONCAT_IMPL(a, b)
+
+// Returns the error of expr, a result<T>, from the enclosing function, which must itself
+// return a result.
+#define CLM_TRY(expr) \
+	do \
+	{ \
+		if (auto&& clmTryResult = (expr); !clmTryResult) [[unlikely]] \
+		{ \
+			return ::std::unexpected<::clm::err::error>{clmTryResult.error()}; \
+		} \
+	} while (0)
+
+// As CLM_TRY, then declares decl from the value: CLM_TRY_ASSIGN(auto image, acquire());
+// Expands to several statements, so it needs a block of its own under an if or a loop.
+#define CLM_TRY_ASSIGN(decl, expr) \
+	auto&& CLM_RESULT_CONCAT(clmTryResult, __LINE__) = (expr); \
+	if (!CLM_RESULT_CONCAT(clmTryResult, __LINE__)) [[unlikely]] \
+		return ::std::unexpected<::clm::err::error>{CLM_RESULT_CONCAT(clmTryResult, __LINE__).error()}; \
+	decl = *::std::move(CLM_RESULT_CONCAT(clmTryResult, __LINE__))
+
+#endif
\ No newline at end of file